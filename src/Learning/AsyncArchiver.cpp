@@ -0,0 +1,122 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "AsyncArchiver.h"
+#include "Organism.h"
+#include <memory>
+using namespace eSpinn;
+
+
+/* @brief: constructor - start the background thread */
+AsyncArchiver::AsyncArchiver(const eSpinn_size &n) :
+    capacity(n ? n : 1), jobs(), busy(false), stopping(false),
+    mtx(), cv_job(), cv_done(), worker(&AsyncArchiver::work, this)
+{ }
+
+
+/* @brief: destructor - finish all jobs and stop the background thread */
+AsyncArchiver::~AsyncArchiver() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv_job.notify_all();
+    worker.join();
+}
+
+
+/* @brief: run jobs until stopped
+ * the queue is drained before stopping
+ */
+void AsyncArchiver::work() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv_job.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            busy = true;
+        }
+        // a room is freed in the queue
+        cv_done.notify_all();
+        try {
+            job();
+        } catch (const std::exception &e) {
+            std::cerr << BnR_ERROR << "Archiving failed: " << e.what() << std::endl;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            busy = false;
+        }
+        cv_done.notify_all();
+    }
+}
+
+
+/* @brief: queue a job
+ * block while the queue is full
+ */
+void AsyncArchiver::submit(std::function<void()> job) {
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_done.wait(lock, [this] { return jobs.size() < capacity; });
+        jobs.push_back(std::move(job));
+    }
+    cv_job.notify_one();
+}
+
+
+/* @brief: queue a job on a snapshot of population pop
+ * the snapshot is a binary archive in memory
+ * and is loaded into a population on the background thread
+ */
+void AsyncArchiver::submit(const Population &pop, std::function<void(Population&)> job) {
+    BinaryWriter w(binarch::POPULATION);
+    pop.archive_binary(w);
+    auto buf = std::make_shared<std::vector<char>>(w.release());
+    submit([buf, job] {
+        BinaryReader r(std::move(*buf));
+        Population p;
+        if (p.load_binary(r))
+            job(p);
+    });
+}
+
+
+/* @brief: queue a job on a snapshot of organism org
+ * the snapshot is a binary archive in memory
+ * and is loaded into an organism on the background thread
+ */
+void AsyncArchiver::submit(const OrganismBase &org, std::function<void(OrganismBase&)> job) {
+    BinaryWriter w(binarch::ORGANISM);
+    w.write(std::string(org.type_key()));
+    org.archive(w);
+    auto buf = std::make_shared<std::vector<char>>(w.release());
+    submit([buf, job] {
+        BinaryReader r(std::move(*buf));
+        std::string key;
+        r.read(key);
+        std::unique_ptr<OrganismBase> o(create_organism(key));
+        if (o && o->load(r))
+            job(*o);
+    });
+}
+
+
+/* @brief: wait until all queued jobs are done */
+void AsyncArchiver::flush() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [this] { return jobs.empty() && !busy; });
+}
+
+
+/* @brief: get num of jobs not done yet */
+const eSpinn_size AsyncArchiver::pending() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return jobs.size() + (busy ? 1 : 0);
+}
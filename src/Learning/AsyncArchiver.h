@@ -0,0 +1,69 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "OrganismBase.h"
+#include "Population.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/* @brief: AsyncArchiver
+ * persist results on a background thread while the next generation evaluates
+ * jobs run one at a time in the order they are submitted
+ * population & organism jobs run on snapshots, i.e. binary copies taken
+ * when the jobs are submitted, so the originals can be evolved right after
+ * submitting blocks while the queue is full
+ * all queued jobs are done before the archiver is destroyed
+ * initialization list: max num of queued jobs
+ */
+namespace eSpinn {
+    class AsyncArchiver
+    {
+    private:
+        /* data */
+        eSpinn_size capacity;
+        std::deque<std::function<void()>> jobs;
+        bool busy; // a job is running
+        bool stopping;
+        std::mutex mtx;
+        std::condition_variable cv_job, cv_done;
+        std::thread worker;
+
+        /* @brief: run jobs until stopped */
+        void work();
+    public:
+        /* @brief: constructor - start the background thread */
+        AsyncArchiver(const eSpinn_size &n = 4);
+
+        /* @brief: deleted copy constructor */
+        AsyncArchiver(const AsyncArchiver &) = delete;
+
+        /* @brief: destructor - finish all jobs and stop the background thread */
+        ~AsyncArchiver();
+
+        /* @brief: queue a job
+         * block while the queue is full
+         */
+        void submit(std::function<void()> job);
+
+        /* @brief: queue a job on a snapshot of population pop */
+        void submit(const Population &pop, std::function<void(Population&)> job);
+
+        /* @brief: queue a job on a snapshot of organism org */
+        void submit(const OrganismBase &org, std::function<void(OrganismBase&)> job);
+
+        /* @brief: wait until all queued jobs are done */
+        void flush();
+
+        /* @brief: get num of jobs not done yet */
+        const eSpinn_size pending();
+    };
+}
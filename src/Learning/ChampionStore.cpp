@@ -0,0 +1,268 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "ChampionStore.h"
+#include "Organism.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+using namespace eSpinn;
+
+
+/* @brief: get size of the header of the store files
+ * i.e. a binary archive header padded to 8 bytes, so that entries are aligned
+ */
+static std::size_t header_size() {
+    static const std::size_t s = (BinaryWriter(binarch::CHAMPION_STORE).size() + 7) / 8 * 8;
+    return s;
+}
+
+
+/* @brief: check if the mapped file starts with a header of content c */
+static bool check_header(const MappedFile &f, const binarch::contentType &c) {
+    if (!f.ok() || f.size() < header_size())
+        return false;
+    BinaryReader r(std::vector<char>(f.data(), f.data() + header_size()));
+    // the padding is not read
+    return r.ok() && r.getContent() == c;
+}
+
+
+/* @brief: append bytes to file
+ * a header of content c is written first if the file is empty
+ * pos is set to where the bytes are written
+ * return false if file can't be written
+ */
+static bool append(const std::string &file, const binarch::contentType &c,
+    const char *p, const std::size_t &len, std::uint64_t &pos)
+{
+    std::ofstream ofs(file, std::ios::binary | std::ios::app | std::ios::ate);
+    if (!ofs) {
+        std::cerr << BnR_ERROR << "Can't open file " << file << std::endl;
+        return false;
+    }
+    pos = static_cast<std::uint64_t>(ofs.tellp());
+    if (!pos) {
+        auto h = BinaryWriter(c).release();
+        h.resize(header_size(), 0);
+        ofs.write(h.data(), h.size());
+        pos = h.size();
+    }
+    ofs.write(p, len);
+    return static_cast<bool>(ofs);
+}
+
+
+/* @brief: constructor
+ * an existing store is cleared if not appending to it
+ */
+ChampionStore::ChampionStore(const std::string &file, const bool append) :
+    data_file(file), index_file(file + ".idx"), data(), index(),
+    stale(true), last_gen(0)
+{
+    if (!append) {
+        std::remove(data_file.c_str());
+        std::remove(index_file.c_str());
+    } else if (map() && begin() != end()) {
+        last_gen = (end() - 1)->gen;
+    }
+}
+
+
+/* @brief: map the files if they are not mapped or are stale
+ * return false if the store is empty or corrupted
+ */
+bool ChampionStore::map() {
+    if (!stale)
+        return index.ok() && data.ok();
+    stale = false;
+    if (!index.map(index_file) || !data.map(data_file))
+        return false;
+    if (!check_header(index, binarch::CHAMPION_INDEX)
+        || !check_header(data, binarch::CHAMPION_STORE))
+    {
+        std::cerr << BnR_ERROR << data_file << " is not a champion store" << std::endl;
+        index.unmap();
+        data.unmap();
+        return false;
+    }
+    return true;
+}
+
+
+/* @brief: get index entries in the mapped index file
+ * an entry partially written is ignored
+ */
+const ChampionEntry* ChampionStore::begin() const {
+    return reinterpret_cast<const ChampionEntry*>(index.data() + header_size());
+}
+
+
+const ChampionEntry* ChampionStore::end() const {
+    return begin() + (index.size() - header_size()) / sizeof(ChampionEntry);
+}
+
+
+/* @brief: add organism o of generation gen
+ * mark it as champion of gen if champ is true
+ * return false if gen is older than the last added one
+ * or the files can't be written
+ */
+bool ChampionStore::add(const OrganismBase &o, const eSpinn_size &gen, const bool champ) {
+    if (gen < last_gen) {
+        std::cerr << BnR_ERROR << "Organisms of generation " << gen
+            << " are added after generation " << last_gen << std::endl;
+        return false;
+    }
+    BinaryWriter w(binarch::ORGANISM);
+    w.write(std::string(o.type_key()));
+    o.archive(w);
+    const auto buf = w.release();
+
+    // the organism is written before its entry
+    // so that an entry always refers to a complete archive
+    ChampionEntry e;
+    e.gen = gen;
+    e.org_id = o.getID();
+    e.champ = champ ? 1 : 0;
+    e.size = buf.size();
+    e.fitness = o.getFit();
+    std::uint64_t pos = 0;
+    stale = true;
+    if (!append(data_file, binarch::CHAMPION_STORE, buf.data(), buf.size(), e.offset)
+        || !append(index_file, binarch::CHAMPION_INDEX,
+            reinterpret_cast<const char*>(&e), sizeof(e), pos))
+        return false;
+    last_gen = gen;
+    return true;
+}
+
+
+/* @brief: add all organisms of population pop
+ * with its champion marked as champion of gen
+ */
+bool ChampionStore::add(const Population &pop, const eSpinn_size &gen) {
+    const auto champ = pop.get_champ_org();
+    for (auto &o : pop.orgs) {
+        if (!add(*o, gen, o == champ))
+            return false;
+    }
+    return true;
+}
+
+
+/* @brief: get num of organisms in the store */
+const eSpinn_size ChampionStore::size() {
+    return map() ? end() - begin() : 0;
+}
+
+
+/* @brief: find index entry of organism #id of generation gen
+ * return nullptr if not found
+ */
+const ChampionEntry* ChampionStore::find(const eSpinn_size &gen, const netID &id) {
+    if (!map())
+        return nullptr;
+    // entries are in order of generations
+    auto e = std::lower_bound(begin(), end(), gen,
+        [](const ChampionEntry &a, const eSpinn_size &g) { return a.gen < g; });
+    for ( ; e != end() && e->gen == gen; ++e) {
+        if (e->org_id == id)
+            return e;
+    }
+    return nullptr;
+}
+
+
+/* @brief: find index entry of the champion of generation gen
+ * return nullptr if not found
+ */
+const ChampionEntry* ChampionStore::find_champ(const eSpinn_size &gen) {
+    if (!map())
+        return nullptr;
+    auto e = std::lower_bound(begin(), end(), gen,
+        [](const ChampionEntry &a, const eSpinn_size &g) { return a.gen < g; });
+    for ( ; e != end() && e->gen == gen; ++e) {
+        if (e->champ)
+            return e;
+    }
+    return nullptr;
+}
+
+
+/* @brief: load the organism of an index entry
+ * only the bytes of the organism are read from the mapped data file
+ */
+OrganismBase* ChampionStore::load(const ChampionEntry &e) const {
+    if (e.offset < header_size() || e.offset + e.size > data.size()) {
+        std::cerr << BnR_ERROR << "Corrupted champion store " << data_file << std::endl;
+        return nullptr;
+    }
+    const auto p = data.data() + e.offset;
+    BinaryReader r(std::vector<char>(p, p + e.size));
+    std::string key;
+    r.read(key);
+    auto o = create_organism(key);
+    if (!o || !o->load(r)) {
+        std::cerr << BnR_ERROR << "Corrupted champion store " << data_file << std::endl;
+        delete o;
+        return nullptr;
+    }
+    return o;
+}
+
+
+/* @brief: load organism #id of generation gen
+ * return nullptr if not found, otherwise the returned object
+ * should be deleted manually
+ */
+OrganismBase* ChampionStore::load(const eSpinn_size &gen, const netID &id) {
+    auto e = find(gen, id);
+    return e ? load(*e) : nullptr;
+}
+
+
+/* @brief: load the champion of generation gen
+ * return nullptr if not found, otherwise the returned object
+ * should be deleted manually
+ */
+OrganismBase* ChampionStore::load_champ(const eSpinn_size &gen) {
+    auto e = find_champ(gen);
+    return e ? load(*e) : nullptr;
+}
+
+
+/* @brief: load the champion of the latest generation up to gen
+ * e.g. of the last stored generation of a run that stopped early
+ * return nullptr if not found, otherwise the returned object
+ * should be deleted manually
+ */
+OrganismBase* ChampionStore::load_latest_champ(const eSpinn_size &gen) {
+    if (!map())
+        return nullptr;
+    auto e = std::upper_bound(begin(), end(), gen,
+        [](const eSpinn_size &g, const ChampionEntry &a) { return g < a.gen; });
+    while (e != begin()) {
+        if ((--e)->champ)
+            return load(*e);
+    }
+    return nullptr;
+}
+
+
+/* @brief: load the fittest champion of all generations
+ * return nullptr if there is no champion, otherwise the returned object
+ * should be deleted manually
+ */
+OrganismBase* ChampionStore::load_best() {
+    if (!map())
+        return nullptr;
+    const ChampionEntry *best = nullptr;
+    for (auto e = begin(); e != end(); ++e) {
+        if (e->champ && (!best || e->fitness > best->fitness))
+            best = e;
+    }
+    return best ? load(*best) : nullptr;
+}
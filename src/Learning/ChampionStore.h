@@ -0,0 +1,116 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "OrganismBase.h"
+#include "Population.h"
+#include "Utilities/MappedFile.h"
+#include <cstdint>
+#include <string>
+
+/* @brief: ChampionStore
+ * an indexed store of organisms across generations
+ * organisms are appended to a data file, each as a binary organism archive,
+ * and indexed by an entry in an index file (data file + ".idx")
+ * both files are memory mapped when loading,
+ * so an organism is loaded without reading the rest of the store
+ * organisms are added in non-decreasing order of generations
+ * initialization list: data file, (append to existing store)
+ */
+namespace eSpinn {
+    /* @brief: index entry of an organism */
+    struct ChampionEntry {
+        std::uint32_t gen;
+        std::uint32_t org_id;
+        std::uint32_t champ; // 1 if champion of the generation
+        std::uint32_t size; // size of the organism archive
+        std::uint64_t offset; // position of the organism archive in the data file
+        double fitness;
+    };
+
+
+    class ChampionStore
+    {
+    private:
+        /* data */
+        std::string data_file, index_file;
+        MappedFile data, index;
+        bool stale; // files changed since mapped
+        eSpinn_size last_gen; // generation of the last organism
+
+        /* @brief: map the files if they are not mapped or are stale
+         * return false if the store is empty or corrupted
+         */
+        bool map();
+
+        /* @brief: get index entries in the mapped index file */
+        const ChampionEntry* begin() const;
+        const ChampionEntry* end() const;
+
+        /* @brief: load the organism of an index entry */
+        OrganismBase* load(const ChampionEntry &e) const;
+    public:
+        /* @brief: constructor
+         * an existing store is cleared if not appending to it
+         */
+        ChampionStore(const std::string &file, const bool append = true);
+
+        /* @brief: deleted copy constructor */
+        ChampionStore(const ChampionStore &) = delete;
+
+        /* @brief: add organism o of generation gen
+         * mark it as champion of gen if champ is true
+         * return false if gen is older than the last added one
+         * or the files can't be written
+         */
+        bool add(const OrganismBase &o, const eSpinn_size &gen, const bool champ = false);
+
+        /* @brief: add all organisms of population pop
+         * with its champion marked as champion of gen
+         */
+        bool add(const Population &pop, const eSpinn_size &gen);
+
+        /* @brief: get num of organisms in the store */
+        const eSpinn_size size();
+
+        /* @brief: find index entry of organism #id of generation gen
+         * return nullptr if not found
+         */
+        const ChampionEntry* find(const eSpinn_size &gen, const netID &id);
+
+        /* @brief: find index entry of the champion of generation gen
+         * return nullptr if not found
+         */
+        const ChampionEntry* find_champ(const eSpinn_size &gen);
+
+        /* @brief: load organism #id of generation gen
+         * return nullptr if not found, otherwise the returned object
+         * should be deleted manually
+         */
+        OrganismBase* load(const eSpinn_size &gen, const netID &id);
+
+        /* @brief: load the champion of generation gen
+         * return nullptr if not found, otherwise the returned object
+         * should be deleted manually
+         */
+        OrganismBase* load_champ(const eSpinn_size &gen);
+
+        /* @brief: load the champion of the latest generation up to gen
+         * e.g. of the last stored generation of a run that stopped early
+         * return nullptr if not found, otherwise the returned object
+         * should be deleted manually
+         */
+        OrganismBase* load_latest_champ(const eSpinn_size &gen);
+
+        /* @brief: load the fittest champion of all generations
+         * return nullptr if there is no champion, otherwise the returned object
+         * should be deleted manually
+         */
+        OrganismBase* load_best();
+    };
+}
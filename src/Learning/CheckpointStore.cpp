@@ -0,0 +1,419 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "CheckpointStore.h"
+#include <fstream>
+#include <unordered_set>
+using namespace eSpinn;
+
+
+/* @brief: how an array is stored relative to the reference array
+ * SAME: identical, SPARSE: indices & values of the changed elements,
+ * FULL: the whole array
+ */
+enum diffType : unsigned char {
+    SAME = 0,
+    SPARSE = 1,
+    FULL = 2
+};
+
+
+/* @brief: write array cur as the difference from ref
+ * ref is nullptr if there is no reference
+ */
+template <typename T>
+static void archive_diff(BinaryWriter &w, const std::vector<T> &cur,
+    const std::vector<T> *ref)
+{
+    if (ref && ref->size() == cur.size()) {
+        std::vector<std::uint32_t> idx;
+        std::vector<T> val;
+        for (std::uint32_t i = 0; i < cur.size(); ++i) {
+            // compare bits, so that restored genomes are exactly the same
+            if (std::memcmp(&cur[i], &(*ref)[i], sizeof(T))) {
+                idx.push_back(i);
+                val.push_back(cur[i]);
+            }
+        }
+        if (idx.empty()) {
+            w.write(SAME);
+            return;
+        }
+        if (idx.size() * (sizeof(std::uint32_t) + sizeof(T)) < cur.size() * sizeof(T)) {
+            w.write(SPARSE);
+            w.write(idx);
+            w.write(val);
+            return;
+        }
+    }
+    w.write(FULL);
+    w.write(cur);
+}
+
+
+/* @brief: read array cur stored as the difference from ref
+ * return false if the archive is corrupted
+ */
+template <typename T>
+static bool load_diff(BinaryReader &r, std::vector<T> &cur, const std::vector<T> *ref) {
+    diffType t = FULL;
+    r.read(t);
+    switch (t) {
+        case SAME:
+            if (!ref)
+                return false;
+            cur = *ref;
+            break;
+        case SPARSE: {
+            if (!ref)
+                return false;
+            std::vector<std::uint32_t> idx;
+            std::vector<T> val;
+            r.read(idx);
+            r.read(val);
+            if (idx.size() != val.size())
+                return false;
+            cur = *ref;
+            for (std::uint32_t i = 0; i < idx.size(); ++i) {
+                if (idx[i] >= cur.size())
+                    return false;
+                cur[idx[i]] = val[i];
+            }
+            break;
+        }
+        case FULL:
+            r.read(cur);
+            break;
+        default:
+            return false;
+    }
+    return r.ok();
+}
+
+
+/* @brief: write genome g as the difference from ref */
+static void archive_genome(BinaryWriter &w, const Genome &g, const Genome *ref) {
+    const auto &t = g.topology();
+    const Topology *rt = ref ? &ref->topology() : nullptr;
+    w.write(t.inp_size);
+    w.write(t.hid_size);
+    w.write(t.outp_size);
+    archive_diff(w, t.neuron_id, rt ? &rt->neuron_id : nullptr);
+    archive_diff(w, t.neuron_layer, rt ? &rt->neuron_layer : nullptr);
+    archive_diff(w, t.neuron_type, rt ? &rt->neuron_type : nullptr);
+    archive_diff(w, g.neuron_param, ref ? &ref->neuron_param : nullptr);
+    archive_diff(w, t.conn_id, rt ? &rt->conn_id : nullptr);
+    archive_diff(w, t.conn_in, rt ? &rt->conn_in : nullptr);
+    archive_diff(w, t.conn_out, rt ? &rt->conn_out : nullptr);
+    archive_diff(w, g.weight, ref ? &ref->weight : nullptr);
+    archive_diff(w, g.delay, ref ? &ref->delay : nullptr);
+    archive_diff(w, g.enable, ref ? &ref->enable : nullptr);
+    archive_diff(w, t.conn_type, rt ? &rt->conn_type : nullptr);
+    archive_diff(w, g.hebb, ref ? &ref->hebb : nullptr);
+    archive_diff(w, g.plastic[0], ref ? &ref->plastic[0] : nullptr);
+    archive_diff(w, g.plastic[1], ref ? &ref->plastic[1] : nullptr);
+}
+
+
+/* @brief: read genome g stored as the difference from ref
+ * the topology of ref is shared if g has the same one
+ * return false if the archive is corrupted
+ */
+static bool load_genome(BinaryReader &r, Genome &g, const Genome *ref) {
+    auto &t = g.edit_topology();
+    const Topology *rt = ref ? &ref->topology() : nullptr;
+    r.read(t.inp_size);
+    r.read(t.hid_size);
+    r.read(t.outp_size);
+    const bool ok = load_diff(r, t.neuron_id, rt ? &rt->neuron_id : nullptr)
+        && load_diff(r, t.neuron_layer, rt ? &rt->neuron_layer : nullptr)
+        && load_diff(r, t.neuron_type, rt ? &rt->neuron_type : nullptr)
+        && load_diff(r, g.neuron_param, ref ? &ref->neuron_param : nullptr)
+        && load_diff(r, t.conn_id, rt ? &rt->conn_id : nullptr)
+        && load_diff(r, t.conn_in, rt ? &rt->conn_in : nullptr)
+        && load_diff(r, t.conn_out, rt ? &rt->conn_out : nullptr)
+        && load_diff(r, g.weight, ref ? &ref->weight : nullptr)
+        && load_diff(r, g.delay, ref ? &ref->delay : nullptr)
+        && load_diff(r, g.enable, ref ? &ref->enable : nullptr)
+        && load_diff(r, t.conn_type, rt ? &rt->conn_type : nullptr)
+        && load_diff(r, g.hebb, ref ? &ref->hebb : nullptr)
+        && load_diff(r, g.plastic[0], ref ? &ref->plastic[0] : nullptr)
+        && load_diff(r, g.plastic[1], ref ? &ref->plastic[1] : nullptr);
+    g.intern();
+    return ok;
+}
+
+
+/* @brief: hash of the topology of genome g
+ * genomes of the same topology only differ in their parameters
+ */
+static std::uint64_t topology_hash(const Genome &g) {
+    const auto &t = g.topology();
+    return fnv1a(t.conn_id, fnv1a(t.neuron_id, fnv1a(nullptr, 0)));
+}
+
+
+/* @brief: get checkpoint file name of generation gen */
+std::string CheckpointStore::filename(const eSpinn_size &gen) const {
+    return prefix + std::to_string(gen) + ext;
+}
+
+
+/* @brief: write a checkpoint of generation gen
+ * a base snapshot if it is the first checkpoint
+ * or interval checkpoints have been written since the last base,
+ * otherwise a delta from the last checkpoint
+ * return the size of the file written
+ */
+std::size_t CheckpointStore::save(const Population &pop, const eSpinn_size &gen) {
+    const auto file = filename(gen);
+    if (last_file.empty() || since_base + 1 >= interval) {
+        pop.archive_binary(file);
+        since_base = 0;
+    } else {
+        archive_delta(pop, file);
+        ++since_base;
+    }
+
+    // keep the genomes to write the next delta
+    last_file = file;
+    num_innov = pop.innovation.size();
+    genomes.clear();
+    for (auto &o : pop.orgs)
+        genomes.emplace(o->get_genome().hash(), o->get_genome());
+
+    std::ifstream ifs(file, std::ios::binary | std::ios::ate);
+    return ifs ? static_cast<std::size_t>(ifs.tellg()) : 0;
+}
+
+
+/* @brief: write a delta from the last checkpoint */
+void CheckpointStore::archive_delta(const Population &pop, const std::string &ofile) const {
+    BinaryWriter w(binarch::CHECKPOINT_DELTA);
+    // the last checkpoint is in the same directory
+    w.write(last_file.substr(last_file.find_last_of('/') + 1));
+    pop.archive_states(w);
+    pop.archive_innovation(w, num_innov);
+
+    // organism types are stored once
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, std::uint32_t> key_index;
+    std::vector<std::uint64_t> hashes;
+    std::unordered_map<std::uint64_t, const Genome*> cur_genomes;
+    for (auto &o : pop.orgs) {
+        const std::string key(o->type_key());
+        if (!key_index.count(key)) {
+            key_index[key] = keys.size();
+            keys.push_back(key);
+        }
+        hashes.push_back(o->get_genome().hash());
+        cur_genomes.emplace(hashes.back(), &o->get_genome());
+    }
+    w.write(static_cast<std::uint32_t>(keys.size()));
+    for (auto &k : keys)
+        w.write(k);
+
+    // organisms refer to genomes by hashes
+    w.write(static_cast<std::uint32_t>(pop.orgs.size()));
+    for (eSpinn_size k = 0; k < pop.orgs.size(); ++k) {
+        auto o = pop.orgs[k];
+        const auto rec = w.begin_record();
+        w.write(key_index[o->type_key()]);
+        w.write(hashes[k]);
+        w.write(o->org_id);
+        w.write(o->gen);
+        w.write(o->fitness);
+        w.write(o->orig_fit);
+        w.write(o->winner);
+        w.end_record(rec);
+    }
+
+    // new genomes, as differences from a genome of the same topology
+    std::unordered_map<std::uint64_t, std::uint64_t> topology;
+    for (auto &g : genomes)
+        topology.emplace(topology_hash(g.second), g.first);
+    std::vector<std::uint64_t> added;
+    for (auto &g : cur_genomes) {
+        if (!genomes.count(g.first))
+            added.push_back(g.first);
+    }
+    w.write(static_cast<std::uint32_t>(added.size()));
+    for (auto &h : added) {
+        const auto &g = *cur_genomes[h];
+        auto t = topology.find(topology_hash(g));
+        const Genome *ref = t == topology.end() ? nullptr : &genomes.at(t->second);
+        const auto rec = w.begin_record();
+        w.write(h);
+        w.write(ref ? t->second : std::uint64_t(0));
+        archive_genome(w, g, ref);
+        w.end_record(rec);
+    }
+
+    // removed genomes
+    std::vector<std::uint64_t> removed;
+    for (auto &g : genomes) {
+        if (!cur_genomes.count(g.first))
+            removed.push_back(g.first);
+    }
+    w.write(removed);
+
+    pop.archive_species(w);
+    w.save(ofile);
+}
+
+
+/* @brief: remove all organisms & species of pop */
+void CheckpointStore::clear(Population &pop) {
+    for (auto &s : pop.species)
+        delete s; // organisms are deleted by species
+    pop.species.clear();
+    pop.orgs.clear();
+}
+
+
+/* @brief: read a delta and apply it to pop
+ * genomes are updated to the genomes of the delta
+ * return false if the archive is corrupted
+ */
+bool CheckpointStore::apply_delta(BinaryReader &r, Population &pop,
+    std::unordered_map<std::uint64_t, Genome> &genomes)
+{
+    if (r.getContent() != binarch::CHECKPOINT_DELTA)
+        return false;
+    std::string parent;
+    r.read(parent);
+    clear(pop);
+    pop.load_states(r);
+    pop.load_innovation(r);
+
+    std::uint32_t num = 0;
+    r.read(num);
+    std::vector<std::string> keys(num);
+    for (auto &k : keys)
+        r.read(k);
+
+    // organisms
+    struct OrgRecord {
+        std::uint32_t key;
+        std::uint64_t hash;
+        netID org_id;
+        eSpinn_size gen;
+        double fitness, orig_fit;
+        bool winner;
+    };
+    r.read(num);
+    std::vector<OrgRecord> recs(r.ok() ? num : 0);
+    for (auto &o : recs) {
+        const auto end = r.begin_record();
+        r.read(o.key);
+        r.read(o.hash);
+        r.read(o.org_id);
+        r.read(o.gen);
+        r.read(o.fitness);
+        r.read(o.orig_fit);
+        r.read(o.winner);
+        r.end_record(end);
+    }
+
+    // new genomes are decoded before the removed ones are erased
+    // because they refer to genomes of the last checkpoint
+    bool good = r.ok();
+    std::unordered_map<std::uint64_t, Genome> added;
+    r.read(num);
+    for (std::uint32_t k = 0; k < num && good; ++k) {
+        const auto end = r.begin_record();
+        std::uint64_t h = 0, ref_hash = 0;
+        r.read(h);
+        r.read(ref_hash);
+        const Genome *ref = nullptr;
+        if (ref_hash) {
+            auto it = genomes.find(ref_hash);
+            if (it == genomes.end()) {
+                good = false;
+                break;
+            }
+            ref = &it->second;
+        }
+        good = load_genome(r, added[h], ref);
+        r.end_record(end);
+    }
+    std::vector<std::uint64_t> removed;
+    r.read(removed);
+    for (auto &h : removed)
+        genomes.erase(h);
+    for (auto &g : added)
+        genomes[g.first] = std::move(g.second);
+
+    std::vector<OrganismBase*> loaded;
+    for (auto &rec : recs) {
+        if (!good || !r.ok())
+            break;
+        auto g = genomes.find(rec.hash);
+        auto o = rec.key < keys.size() ? create_organism(keys[rec.key]) : nullptr;
+        if (!o || g == genomes.end()) {
+            delete o;
+            good = false;
+            break;
+        }
+        o->org_id = rec.org_id;
+        o->gen = rec.gen;
+        o->fitness = rec.fitness;
+        o->orig_fit = rec.orig_fit;
+        o->winner = rec.winner;
+        o->genome = g->second; // the phenotype is built from it when needed
+        loaded.push_back(o);
+    }
+    return pop.load_species(r, loaded, good && r.ok());
+}
+
+
+/* @brief: restore the checkpoint of generation gen to an empty population
+ * return false if a checkpoint in the chain is missing or corrupted
+ */
+bool CheckpointStore::restore(Population &pop, const eSpinn_size &gen) const {
+    return restore(pop, filename(gen));
+}
+
+
+/* @brief: restore a checkpoint file to an empty population
+ * the file is either a base or a delta
+ * return false if a checkpoint in the chain is missing or corrupted
+ */
+bool CheckpointStore::restore(Population &pop, const std::string &ifile) {
+    // follow the deltas back to the base
+    const auto dir = ifile.substr(0, ifile.find_last_of('/') + 1);
+    std::vector<std::string> chain;
+    std::string file = ifile;
+    std::unordered_set<std::string> visited;
+    while (true) {
+        BinaryReader r(file);
+        if (!r.ok())
+            return false;
+        if (r.getContent() == binarch::POPULATION)
+            break;
+        if (r.getContent() != binarch::CHECKPOINT_DELTA || !visited.insert(file).second) {
+            std::cerr << BnR_ERROR << file << " is not a checkpoint" << std::endl;
+            return false;
+        }
+        chain.push_back(file);
+        std::string parent;
+        r.read(parent);
+        file = dir + parent;
+    }
+    if (!pop.load_binary(file))
+        return false;
+
+    std::unordered_map<std::uint64_t, Genome> genomes;
+    for (auto &o : pop.orgs)
+        genomes.emplace(o->get_genome().hash(), o->get_genome());
+    for (auto f = chain.rbegin(); f != chain.rend(); ++f) {
+        BinaryReader r(*f);
+        if (!apply_delta(r, pop, genomes)) {
+            std::cerr << BnR_ERROR << "Corrupted checkpoint " << *f << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,85 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "Genome.h"
+#include "Population.h"
+#include "Utilities/BinaryArchive.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/* @brief: CheckpointStore
+ * checkpoints of a population over generations
+ * a full base snapshot (binary population archive) is written every few checkpoints
+ * and small deltas in between, each relative to the previous checkpoint:
+ *      - population states & new innovations
+ *      - genomes that are new, as differences from a genome of the same topology
+ *      - genomes that are removed
+ *      - organisms & species, which refer to genomes by their hashes
+ * identical genomes (e.g. clones of champions) are stored once
+ * checkpoint files are named as prefix + gen + extension
+ * any checkpoint is restored by loading its base and applying the deltas after it
+ * initialization list: file prefix, file extension, num of checkpoints between bases
+ */
+namespace eSpinn {
+    class CheckpointStore
+    {
+    private:
+        /* data */
+        std::string prefix;
+        std::string ext;
+        eSpinn_size interval;
+        eSpinn_size since_base; // num of deltas since the last base
+        std::string last_file; // file of the last checkpoint
+        eSpinn_size num_innov; // num of innovations of the last checkpoint
+        // genomes of the last checkpoint, by their hashes
+        std::unordered_map<std::uint64_t, Genome> genomes;
+
+        /* @brief: get checkpoint file name of generation gen */
+        std::string filename(const eSpinn_size &gen) const;
+
+        /* @brief: write a delta from the last checkpoint */
+        void archive_delta(const Population &pop, const std::string &ofile) const;
+
+        /* @brief: read a delta and apply it to pop
+         * genomes are updated to the genomes of the delta
+         * return false if the archive is corrupted
+         */
+        static bool apply_delta(BinaryReader &r, Population &pop,
+            std::unordered_map<std::uint64_t, Genome> &genomes);
+
+        /* @brief: remove all organisms & species of pop */
+        static void clear(Population &pop);
+    public:
+        /* @brief: constructor */
+        CheckpointStore(const std::string &p, const std::string &e,
+            const eSpinn_size &n = 10) :
+            prefix(p), ext(e), interval(n ? n : 1), since_base(0), last_file(),
+            num_innov(0), genomes() { }
+
+        /* @brief: write a checkpoint of generation gen
+         * a base snapshot if it is the first checkpoint
+         * or interval checkpoints have been written since the last base,
+         * otherwise a delta from the last checkpoint
+         * return the size of the file written
+         */
+        std::size_t save(const Population &pop, const eSpinn_size &gen);
+
+        /* @brief: restore the checkpoint of generation gen to an empty population
+         * return false if a checkpoint in the chain is missing or corrupted
+         */
+        bool restore(Population &pop, const eSpinn_size &gen) const;
+
+        /* @brief: restore a checkpoint file to an empty population
+         * the file is either a base or a delta
+         * return false if a checkpoint in the chain is missing or corrupted
+         */
+        static bool restore(Population &pop, const std::string &ifile);
+    };
+}
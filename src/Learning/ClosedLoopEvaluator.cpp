@@ -0,0 +1,626 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "ClosedLoopEvaluator.h"
+#include "Models/NetworkBatch.h"
+#include "Utilities/Utilities.h"
+#include "Utilities/SampleHold.h"
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+using namespace eSpinn;
+
+
+/* @brief: networks of rate-based output neurons can be run in a batch */
+template <typename T>
+struct batch_support : std::integral_constant<bool,
+    std::is_same<typename T::outp_type, SigmNeuron>::value
+    || std::is_same<typename T::outp_type, LinrNeuron>::value> { };
+
+
+/* @brief: group organisms that can be run in a batch
+ * return positions of organisms in each group,
+ * positions of the other organisms are pushed to rest
+ */
+template <typename T>
+static std::vector<std::vector<eSpinn_size>> group(
+    const std::vector<Organism<T>*> &orgs, std::vector<eSpinn_size> &rest,
+    std::true_type)
+{
+    std::vector<const Genome*> genomes;
+    for (auto &o : orgs)
+        genomes.push_back(&o->get_genome());
+    return NetworkBatch<T>::group(genomes, rest);
+}
+
+
+template <typename T>
+static std::vector<std::vector<eSpinn_size>> group(
+    const std::vector<Organism<T>*> &orgs, std::vector<eSpinn_size> &rest,
+    std::false_type)
+{
+    for (eSpinn_size i = 0; i < orgs.size(); ++i)
+        rest.push_back(i);
+    return {};
+}
+
+
+/* @brief: run a batch of networks controlling a batch of environments in lockstep
+ * networks [m*k, (m+1)*k) are k copies of member m's, i.e. run its k episodes
+ * scores of all episodes are written to scores, 0 if networks don't fit
+ * the first episode of member m is recorded in slot m of tr if given
+ * networks are sampled at the rate of ctrl, all at the same time slots
+ */
+template <typename T>
+static void run_lockstep(NetworkBatch<T> &batch, const eSpinn_size &k,
+    const Environment &env, const SampleHold &ctrl,
+    std::vector<double> &scores, TraceRecorder *tr)
+{
+    auto inp_size = batch.get_inp_size(), outp_size = batch.get_outp_size();
+    if (env.obs_size() > inp_size || env.act_size() > outp_size) {
+        std::cerr << BnR_ERROR << "network size doesn't fit the environment" << std::endl;
+        scores.assign(batch.size(), .0);
+        return;
+    }
+    auto envs = env.make_batch(batch.size());
+    envs->reset();
+    std::vector<double> inps(batch.size() * inp_size, 1.0);
+    std::vector<double> outps(batch.size() * outp_size);
+    const auto traced = tr ? std::min(tr->num_slots(), batch.size() / k) : 0;
+    SampleHold hold(ctrl);
+    hold.reset();
+    while (!envs->done()) {
+        const double *u;
+        if (hold.due()) {
+            envs->observe(inps.data(), inp_size);
+            batch.run(inps.data(), outps.data());
+            u = hold.sample(outps.data(), outps.size());
+        } else {
+            u = hold.hold();
+        }
+        // every row taken counts in the trace, take it only while the episode runs
+        for (eSpinn_size m = 0; m < traced; ++m) {
+            if (envs->done(m*k))
+                continue;
+            if (auto row = tr->next_row(m))
+                envs->trace(m*k, u, outp_size, row);
+        }
+        envs->step(u, outp_size);
+    }
+    scores.resize(batch.size());
+    for (eSpinn_size b = 0; b < batch.size(); ++b)
+        scores[b] = envs->score(b);
+}
+
+
+/* @brief: run organisms of a group in a batch, k episodes of each
+ * scores of organism b's episodes are written to scores[b*k ...]
+ */
+template <typename T>
+static void run_batch(const std::vector<Organism<T>*> &orgs,
+    const std::vector<eSpinn_size> &group, const eSpinn_size &k,
+    const Environment &env, const SampleHold &ctrl, std::vector<double> &scores,
+    TraceRecorder &tr, std::true_type)
+{
+    std::vector<const Genome*> members;
+    for (auto &i : group) {
+        for (eSpinn_size e = 0; e < k; ++e)
+            members.push_back(&orgs[i]->get_genome());
+    }
+    NetworkBatch<T> batch(members);
+    run_lockstep(batch, k, env, ctrl, scores, &tr);
+}
+
+
+template <typename T>
+static void run_batch(const std::vector<Organism<T>*> &orgs,
+    const std::vector<eSpinn_size> &group, const eSpinn_size &k,
+    const Environment &env, const SampleHold &ctrl, std::vector<double> &scores,
+    TraceRecorder &tr, std::false_type)
+{ }
+
+
+/* @brief: run k episodes of org in lockstep by copies of its network
+ * scores are written to scores[0 ... k)
+ * return false if the network can't be run in a batch
+ */
+template <typename T>
+static bool run_copies(Organism<T> *org, const eSpinn_size &k,
+    const Environment &env, const SampleHold &ctrl, std::vector<double> &scores,
+    TraceRecorder *tr, std::true_type)
+{
+    if (!NetworkBatch<T>::batchable(org->get_genome()))
+        return false;
+    NetworkBatch<T> batch(org->get_genome(), k);
+    run_lockstep(batch, k, env, ctrl, scores, tr);
+    return true;
+}
+
+
+template <typename T>
+static bool run_copies(Organism<T> *org, const eSpinn_size &k,
+    const Environment &env, const SampleHold &ctrl, std::vector<double> &scores,
+    TraceRecorder *tr, std::false_type)
+{
+    return false;
+}
+
+
+/* @brief: constructor
+ * 0 threads means using all hardware threads
+ */
+template <typename T>
+ClosedLoopEvaluator<T>::ClosedLoopEvaluator(const Environment &e,
+    const Mode &m, const eSpinn_size &threads, const eSpinn_size &d) :
+    env(e.clone()), mode(m), num_threads(1), depth(1),
+    episodes(1), agg(MEAN), quant(.5), ctrl(), inps(), scores(), tracer(0)
+{
+    set_threads(threads);
+    set_depth(d);
+}
+
+
+/* @brief: set how organisms are evaluated */
+template <typename T>
+void ClosedLoopEvaluator<T>::set_mode(const Mode &m) {
+    mode = m;
+}
+
+
+/* @brief: set the num of threads used in PARALLEL mode
+ * 0 means using all hardware threads
+ */
+template <typename T>
+void ClosedLoopEvaluator<T>::set_threads(const eSpinn_size &n) {
+    num_threads = n ? n : std::thread::hardware_concurrency();
+    if (!num_threads)
+        num_threads = 1;
+}
+
+
+/* @brief: set the num of episodes interleaved by a worker in PARALLEL mode
+ * 0 is taken as 1
+ */
+template <typename T>
+void ClosedLoopEvaluator<T>::set_depth(const eSpinn_size &d) {
+    depth = d ? d : 1;
+}
+
+
+/* @brief: set num of episodes run by each organism
+ * and how their scores give its fitness, q is the quantile if QUANTILE
+ * 0 episodes is taken as 1, q is capped within [0, 1]
+ */
+template <typename T>
+void ClosedLoopEvaluator<T>::set_episodes(const eSpinn_size &k,
+    const Aggregate &a, const double &q)
+{
+    episodes = k ? k : 1;
+    agg = a;
+    quant = std::min(std::max(q, .0), 1.0);
+}
+
+
+/* @brief: run networks every period time slots of environments
+ * outputs in between are held as mode
+ * 0 is taken as 1, i.e. every time slot
+ */
+template <typename T>
+void ClosedLoopEvaluator<T>::set_control(const eSpinn_size &period,
+    const SampleHold::Mode &mode)
+{
+    ctrl.set_period(period);
+    ctrl.set_mode(mode);
+}
+
+
+/* @brief: trace environments while evaluating
+ * keep the latest capacity time slots of the best organism's episode
+ * 0 disables tracing
+ */
+template <typename T>
+void ClosedLoopEvaluator<T>::set_tracing(const eSpinn_size &capacity) {
+    tracer.set_capacity(capacity);
+}
+
+
+/* @brief: get the recorder of traces
+ * it keeps the trace of the best organism last evaluated
+ */
+template <typename T>
+const TraceRecorder &ClosedLoopEvaluator<T>::get_tracer() const {
+    return tracer;
+}
+
+
+/* @brief: set the environment, a copy of e is kept */
+template <typename T>
+void ClosedLoopEvaluator<T>::set_env(const Environment &e) {
+    env = e.clone();
+}
+
+
+/* @brief: get the environment */
+template <typename T>
+Environment &ClosedLoopEvaluator<T>::get_env() const {
+    return *env;
+}
+
+
+/* @brief: start an episode of env controlled by org
+ * return false if the network doesn't fit the environment
+ * plastic connection weights are backed up
+ */
+template <typename T>
+bool ClosedLoopEvaluator<T>::begin_episode(Organism<T> *org,
+    Environment &e, std::vector<double> &inps)
+{
+    auto net = org->getNet();
+    auto inp_size = net->get_inp_size();
+    if (e.obs_size() > inp_size || e.act_size() > net->get_outp_size()) {
+        std::cerr << BnR_ERROR << "network size doesn't fit the environment" << std::endl;
+        return false;
+    }
+    inps.assign(inp_size, 1.0);
+    net->backup_connection_weights();
+    net->reset();
+    e.reset();
+    return true;
+}
+
+
+/* @brief: finish an episode of env controlled by org
+ * return the score
+ * plastic connection weights are restored
+ */
+template <typename T>
+const double ClosedLoopEvaluator<T>::end_episode(Organism<T> *org, Environment &e) {
+    org->getNet()->restore_connection_weights();
+    return e.score();
+}
+
+
+/* @brief: run an episode of env controlled by org
+ * return the score
+ * the environment is observed & the network runs at the rate of hold,
+ * the environment steps every time slot by outputs of hold
+ * time slots are recorded in slot 0 of tr if given
+ */
+template <typename T>
+const double ClosedLoopEvaluator<T>::run_episode(Organism<T> *org,
+    Environment &e, std::vector<double> &inps, SampleHold &hold,
+    TraceRecorder *tr)
+{
+    if (!begin_episode(org, e, inps))
+        return .0;
+    auto net = org->getNet();
+    hold.reset();
+    while (!e.done()) {
+        const double *outp;
+        if (hold.due()) {
+            e.observe(inps.data());
+            net->load_inputs(inps.data(), inps.size());
+            auto &outps = net->run();
+            outp = hold.sample(outps.data(), outps.size());
+        } else {
+            outp = hold.hold();
+        }
+        if (auto row = tr ? tr->next_row(0) : nullptr)
+            e.trace(outp, row);
+        e.step(outp);
+    }
+    return end_episode(org, e);
+}
+
+
+/* @brief: aggregate scores s[0 ... n) of an organism's episodes
+ * s may be reordered
+ * a quantile is linearly interpolated between the sorted scores
+ */
+template <typename T>
+const double ClosedLoopEvaluator<T>::aggregate(double *s, const eSpinn_size &n) const {
+    switch (agg) {
+    case MIN:
+        return *std::min_element(s, s + n);
+    case QUANTILE: {
+        std::sort(s, s + n);
+        const double p = quant * (n - 1);
+        const auto lo = static_cast<eSpinn_size>(p);
+        if (lo + 1 >= n)
+            return s[n - 1];
+        return s[lo] + (p - lo) * (s[lo + 1] - s[lo]);
+    }
+    default:
+        return std::accumulate(s, s + n, .0) / n;
+    }
+}
+
+
+/* @brief: run the episodes of env controlled by org
+ * return the fitness aggregated from scores of them
+ * episodes of a batchable network run in lockstep by copies of it,
+ * the others one by one
+ * the first episode is traced in slot 0 of tr if given,
+ * org is at position pos of the evaluated organisms
+ */
+template <typename T>
+const double ClosedLoopEvaluator<T>::run_episodes(Organism<T> *org,
+    Environment &e, std::vector<double> &inps, std::vector<double> &s,
+    SampleHold &hold, TraceRecorder *tr, const eSpinn_size &pos) const
+{
+    if (tr)
+        tr->begin(0, org, pos, e.trace_size());
+    double fit;
+    if (episodes == 1) {
+        fit = run_episode(org, e, inps, hold, tr);
+    } else {
+        if (!run_copies(org, episodes, e, hold, s, tr, batch_support<T>())) {
+            s.resize(episodes);
+            for (eSpinn_size k = 0; k < episodes; ++k)
+                s[k] = run_episode(org, e, inps, hold, k ? nullptr : tr);
+        }
+        fit = aggregate(s.data(), episodes);
+    }
+    if (tr)
+        tr->end(0, fit);
+    return fit;
+}
+
+
+/* @brief: run episodes of organisms first, first+stride, ...
+ * interleaving depth of them on the calling thread
+ * every time slot, all episodes in flight observe, then all networks run,
+ * then all environments step, so the independent work of different
+ * organisms is issued back to back and hides each other's memory latency
+ * (observing & running are skipped at time slots between samples)
+ * a finished episode is replaced by the next organism
+ * the random engine is seeded from seeds[i] before organism i's episode starts,
+ * and each episode in flight draws from its own stream, swapped in around
+ * observing & stepping, i.e. scores don't depend on the num of threads & the depth
+ * episodes are traced in slots of tr, one per episode in flight
+ */
+template <typename T>
+void ClosedLoopEvaluator<T>::run_pipeline(const std::vector<Organism<T>*> &orgs,
+    const eSpinn_size &first, const eSpinn_size &stride,
+    const std::vector<std::uint64_t> &seeds, std::vector<double> &fits,
+    TraceRecorder &tr)
+{
+    auto next = first;
+    // a single episode in flight keeps the thread's stream
+    const bool own_streams = depth > 1;
+    auto swap_stream = [own_streams](Episode &ep) {
+        if (own_streams)
+            std::swap(rand_engine(), ep.engine);
+    };
+    // start the next episode that fits its environment in slot ep
+    auto start = [&](Episode &ep) {
+        for (; next < orgs.size(); next += stride) {
+            seed_rand(seeds[next]);
+            if (begin_episode(orgs[next], *ep.env, ep.inps))
+                break;
+            fits[next] = .0;
+        }
+        ep.idx = next;
+        if (next < orgs.size()) {
+            if (own_streams)
+                ep.engine = rand_engine();
+            ep.net = orgs[next]->getNet();
+            ep.hold.reset();
+            tr.begin(ep.slot, orgs[next], next, ep.env->trace_size());
+            next += stride;
+        }
+    };
+
+    std::vector<Episode> pipe(depth);
+    tr.set_slots(depth);
+    for (eSpinn_size s = 0; s < pipe.size(); ++s) {
+        pipe[s].env = env->clone();
+        pipe[s].hold = ctrl;
+        pipe[s].slot = s;
+        start(pipe[s]);
+    }
+    auto busy = [&orgs](const Episode &ep) { return ep.idx < orgs.size(); };
+    pipe.erase(std::remove_if(pipe.begin(), pipe.end(),
+        [&busy](const Episode &ep) { return !busy(ep); }), pipe.end());
+
+    std::vector<const double*> outps(pipe.size());
+    while (!pipe.empty()) {
+        for (auto &ep : pipe) {
+            if (!ep.hold.due())
+                continue;
+            swap_stream(ep);
+            ep.env->observe(ep.inps.data());
+            swap_stream(ep);
+        }
+        for (eSpinn_size s = 0; s < pipe.size(); ++s) {
+            auto &hold = pipe[s].hold;
+            if (hold.due()) {
+                pipe[s].net->load_inputs(pipe[s].inps.data(), pipe[s].inps.size());
+                auto &o = pipe[s].net->run();
+                outps[s] = hold.sample(o.data(), o.size());
+            } else {
+                outps[s] = hold.hold();
+            }
+            if (auto row = tr.next_row(pipe[s].slot))
+                pipe[s].env->trace(outps[s], row);
+        }
+        for (eSpinn_size s = 0; s < pipe.size(); ++s) {
+            swap_stream(pipe[s]);
+            pipe[s].env->step(outps[s]);
+            swap_stream(pipe[s]);
+        }
+
+        for (auto &ep : pipe) {
+            if (!ep.env->done())
+                continue;
+            fits[ep.idx] = end_episode(orgs[ep.idx], *ep.env);
+            tr.end(ep.slot, fits[ep.idx]);
+            start(ep);
+        }
+        pipe.erase(std::remove_if(pipe.begin(), pipe.end(),
+            [&busy](const Episode &ep) { return !busy(ep); }), pipe.end());
+    }
+}
+
+
+/* @brief: evaluate organisms one by one */
+template <typename T>
+void ClosedLoopEvaluator<T>::evaluate_serial(const std::vector<Organism<T>*> &orgs,
+    std::vector<double> &fits)
+{
+    tracer.set_slots(1);
+    for (eSpinn_size i = 0; i < orgs.size(); ++i)
+        fits[i] = run_episodes(orgs[i], *env, inps, scores, ctrl, &tracer, i);
+}
+
+
+/* @brief: evaluate organisms by worker threads
+ * networks are built on the calling thread beforehand
+ * worker t evaluates organisms t, t+n, t+2n, ... interleaving depth of them,
+ * or running their episodes one organism after another if several,
+ * each episode's random engine is seeded from the calling thread's engine,
+ * interleaved episodes draw from their own streams,
+ * i.e. results are reproducible whatever the num of threads & the depth
+ * each worker keeps its best trace, the best of them is merged
+ */
+template <typename T>
+void ClosedLoopEvaluator<T>::evaluate_parallel(const std::vector<Organism<T>*> &orgs,
+    std::vector<double> &fits)
+{
+    const auto n = std::min<eSpinn_size>(num_threads, orgs.size());
+    if (!n)
+        return;
+    for (auto &o : orgs)
+        o->getNet();
+    std::vector<std::uint64_t> seeds(orgs.size());
+    for (auto &s : seeds)
+        s = (static_cast<std::uint64_t>(rand_engine()()) << 32) | rand_engine()();
+
+    std::vector<TraceRecorder> traces(n, TraceRecorder(tracer.get_capacity()));
+    auto work = [this, &orgs, &fits, &seeds, &traces, n](const eSpinn_size &t) {
+        if (episodes == 1) {
+            run_pipeline(orgs, t, n, seeds, fits, traces[t]);
+            return;
+        }
+        auto e = env->clone();
+        std::vector<double> inps, s;
+        SampleHold hold(ctrl);
+        for (auto i = t; i < orgs.size(); i += n) {
+            seed_rand(seeds[i]);
+            fits[i] = run_episodes(orgs[i], *e, inps, s, hold, &traces[t], i);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (eSpinn_size t = 1; t < n; ++t)
+        workers.emplace_back(work, t);
+    // the calling thread is worker 0, its stream is kept
+    const auto engine = rand_engine();
+    work(0);
+    rand_engine() = engine;
+    for (auto &w : workers)
+        w.join();
+    for (auto &tr : traces)
+        tracer.merge(tr);
+}
+
+
+/* @brief: evaluate organisms in batches of the same topology
+ * all episodes of a group run in one batch
+ * the others are evaluated one by one
+ * the best trace of each group is merged
+ */
+template <typename T>
+void ClosedLoopEvaluator<T>::evaluate_batched(const std::vector<Organism<T>*> &orgs,
+    std::vector<double> &fits)
+{
+    std::vector<eSpinn_size> rest;
+    auto groups = group(orgs, rest, batch_support<T>());
+    TraceRecorder group_tr(tracer.get_capacity(), 0);
+    for (auto &g : groups) {
+        group_tr.set_slots(tracer.isenabled() ? g.size() : 0);
+        for (eSpinn_size b = 0; b < group_tr.num_slots(); ++b)
+            group_tr.begin(b, orgs[g[b]], g[b], env->trace_size());
+        run_batch(orgs, g, episodes, *env, ctrl, scores, group_tr, batch_support<T>());
+        for (eSpinn_size b = 0; b < g.size(); ++b)
+            fits[g[b]] = aggregate(&scores[b*episodes], episodes);
+        for (eSpinn_size b = 0; b < group_tr.num_slots(); ++b)
+            group_tr.end(b, fits[g[b]]);
+        tracer.merge(group_tr);
+    }
+    tracer.set_slots(1);
+    for (auto &r : rest)
+        fits[r] = run_episodes(orgs[r], *env, inps, scores, ctrl, &tracer, r);
+}
+
+
+/* @brief: evaluate organism in an episode of the environment
+ * assign and return its fitness
+ */
+template <typename T>
+const double ClosedLoopEvaluator<T>::evaluate(Organism<T> *org) {
+    tracer.clear();
+    tracer.set_slots(1);
+    org->setFit(run_episodes(org, *env, inps, scores, ctrl, &tracer));
+    return org->getFit();
+}
+
+
+/* @brief: evaluate organisms and assign their fitness */
+template <typename T>
+void ClosedLoopEvaluator<T>::evaluate(const std::vector<OrganismBase*> &orgs) {
+    std::vector<Organism<T>*> org_casts;
+    for (auto &o : orgs) {
+        auto org_cast = dynamic_cast<Organism<T>*>(o);
+        if (!org_cast) {
+            std::cerr << BnR_ERROR << "organism #" << o->getID()
+                << " is not of the evaluated network type" << std::endl;
+            continue;
+        }
+        org_casts.push_back(org_cast);
+    }
+
+    std::vector<double> fits(org_casts.size());
+    tracer.clear();
+    switch (mode) {
+    case PARALLEL:
+        evaluate_parallel(org_casts, fits);
+        break;
+    case BATCHED:
+        evaluate_batched(org_casts, fits);
+        break;
+    default:
+        evaluate_serial(org_casts, fits);
+        break;
+    }
+    for (eSpinn_size i = 0; i < org_casts.size(); ++i)
+        org_casts[i]->setFit(fits[i]);
+}
+
+
+/* @brief: evaluate all organisms of the population
+ * organisms of fit >= winner_fit are winners
+ * return true if problem solved
+ */
+template <typename T>
+bool ClosedLoopEvaluator<T>::evaluate(Population *pop, const double &winner_fit) {
+    evaluate(pop->orgs);
+    for (auto &org : pop->orgs) {
+        std::cout << "org #" << org->getID() << "'s fit is "
+            << org->getFit() << std::endl;
+        if (org->setWinner(winner_fit))
+            pop->set_solved();
+    }
+    return pop->issolved();
+}
+
+
+/* @brief: explicit instantiation */
+template class eSpinn::ClosedLoopEvaluator<SigmNetwork>;
+template class eSpinn::ClosedLoopEvaluator<LinrNetwork>;
+template class eSpinn::ClosedLoopEvaluator<IzhiNetwork>;
+template class eSpinn::ClosedLoopEvaluator<LifNetwork>;
+template class eSpinn::ClosedLoopEvaluator<HybridNetwork>;
+template class eSpinn::ClosedLoopEvaluator<HybLinNetwork>;
@@ -0,0 +1,210 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "Organism.h"
+#include "Population.h"
+#include "TraceRecorder.h"
+#include "Plants/Environment.h"
+#include "Utilities/SampleHold.h"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+/* @brief: ClosedLoopEvaluator
+ * evaluate organisms by letting their networks control an environment
+ * each organism runs an episode: the network is reset, then at every time slot
+ * it observes the environment, runs, and acts on the environment until done
+ * the environment's score is the organism's fitness
+ * organisms are evaluated
+ *   - SERIAL: one by one on the calling thread
+ *   - PARALLEL: by worker threads, each interleaving episodes of
+ *     depth organisms with its own clones of the environment
+ *   - BATCHED: organisms of the same topology are run in a batch,
+ *     controlling a batch of environments in lockstep,
+ *     the others are evaluated one by one
+ * an organism can run several episodes, e.g. of a stochastic environment,
+ * and the fitness is the mean, min or a quantile of their scores,
+ * episodes of a batchable network run in lockstep by copies of it
+ * sharing its parameters, and controlling a batch of environments,
+ * the others run one by one
+ * networks can run at a lower rate than environments step,
+ * i.e. every few time slots, with outputs held in between
+ * network inputs after the observations are biases of 1.0
+ * if tracing, environments are traced every time slot while evaluating
+ * and the trace of the best organism is kept
+ * initialization list: environment, mode, num of threads, interleave depth
+ */
+namespace eSpinn {
+    template <typename T>
+    class ClosedLoopEvaluator
+    {
+    public:
+        /* @brief: how organisms are evaluated */
+        enum Mode {
+            SERIAL = 0,
+            PARALLEL,
+            BATCHED
+        };
+
+        /* @brief: how scores of an organism's episodes give its fitness */
+        enum Aggregate {
+            MEAN = 0,
+            MIN,
+            QUANTILE
+        };
+    private:
+        /* data */
+        std::unique_ptr<Environment> env;
+        Mode mode;
+        eSpinn_size num_threads;
+        eSpinn_size depth; // num of interleaved episodes per worker
+        eSpinn_size episodes; // num of episodes per organism
+        Aggregate agg;
+        double quant; // quantile of scores if agg is QUANTILE
+        SampleHold ctrl; // rate of networks, held outputs of serial evaluations
+        std::vector<double> inps; // inputs of serial evaluations
+        std::vector<double> scores; // scores of serial evaluations
+        TraceRecorder tracer; // keeps trace of the best organism
+
+        /* @brief: an episode in flight of a worker */
+        struct Episode
+        {
+            std::unique_ptr<Environment> env;
+            std::vector<double> inps;
+            T *net;
+            SampleHold hold;
+            eSpinn_size idx;
+            eSpinn_size slot; // slot of the trace recorder
+            std::mt19937 engine; // random stream of the episode
+        };
+
+        /* @brief: start an episode of env controlled by org
+         * return false if the network doesn't fit the environment
+         */
+        static bool begin_episode(Organism<T> *org, Environment &e,
+            std::vector<double> &inps);
+
+        /* @brief: finish an episode of env controlled by org
+         * return the score
+         */
+        static const double end_episode(Organism<T> *org, Environment &e);
+
+        /* @brief: run an episode of env controlled by org
+         * return the score
+         * the network runs at the rate of hold
+         * time slots are recorded in slot 0 of tr if given
+         */
+        static const double run_episode(Organism<T> *org, Environment &e,
+            std::vector<double> &inps, SampleHold &hold,
+            TraceRecorder *tr = nullptr);
+
+        /* @brief: aggregate scores s[0 ... n) of an organism's episodes
+         * s may be reordered
+         */
+        const double aggregate(double *s, const eSpinn_size &n) const;
+
+        /* @brief: run the episodes of env controlled by org
+         * return the fitness aggregated from scores of them
+         * the first episode is traced in slot 0 of tr if given,
+         * org is at position pos of the evaluated organisms
+         */
+        const double run_episodes(Organism<T> *org, Environment &e,
+            std::vector<double> &inps, std::vector<double> &s, SampleHold &hold,
+            TraceRecorder *tr = nullptr, const eSpinn_size &pos = 0) const;
+
+        /* @brief: run episodes of organisms first, first+stride, ...
+         * interleaving depth of them on the calling thread
+         * episodes are traced in slots of tr
+         */
+        void run_pipeline(const std::vector<Organism<T>*> &orgs,
+            const eSpinn_size &first, const eSpinn_size &stride,
+            const std::vector<std::uint64_t> &seeds, std::vector<double> &fits,
+            TraceRecorder &tr);
+
+        /* @brief: evaluate organisms one by one */
+        void evaluate_serial(const std::vector<Organism<T>*> &orgs,
+            std::vector<double> &fits);
+
+        /* @brief: evaluate organisms by worker threads */
+        void evaluate_parallel(const std::vector<Organism<T>*> &orgs,
+            std::vector<double> &fits);
+
+        /* @brief: evaluate organisms in batches of the same topology */
+        void evaluate_batched(const std::vector<Organism<T>*> &orgs,
+            std::vector<double> &fits);
+    public:
+        /* @brief: constructor
+         * 0 threads means using all hardware threads
+         */
+        ClosedLoopEvaluator(const Environment &e, const Mode &m = SERIAL,
+            const eSpinn_size &threads = 0, const eSpinn_size &d = 1);
+
+        /* @brief: destructor */
+        ~ClosedLoopEvaluator() = default;
+
+        /* @brief: set how organisms are evaluated */
+        void set_mode(const Mode &m);
+
+        /* @brief: set the num of threads used in PARALLEL mode
+         * 0 means using all hardware threads
+         */
+        void set_threads(const eSpinn_size &n);
+
+        /* @brief: set the num of episodes interleaved by a worker in PARALLEL mode
+         * 0 is taken as 1
+         */
+        void set_depth(const eSpinn_size &d);
+
+        /* @brief: set num of episodes run by each organism
+         * and how their scores give its fitness, q is the quantile if QUANTILE
+         * 0 episodes is taken as 1
+         */
+        void set_episodes(const eSpinn_size &k, const Aggregate &a = MEAN,
+            const double &q = .5);
+
+        /* @brief: run networks every period time slots of environments
+         * outputs in between are held as mode
+         * 0 is taken as 1, i.e. every time slot
+         */
+        void set_control(const eSpinn_size &period,
+            const SampleHold::Mode &mode = SampleHold::ZOH);
+
+        /* @brief: trace environments while evaluating
+         * keep the latest capacity time slots of the best organism's episode
+         * 0 disables tracing
+         */
+        void set_tracing(const eSpinn_size &capacity);
+
+        /* @brief: get the recorder of traces
+         * it keeps the trace of the best organism last evaluated
+         */
+        const TraceRecorder &get_tracer() const;
+
+        /* @brief: set the environment, a copy of e is kept */
+        void set_env(const Environment &e);
+
+        /* @brief: get the environment */
+        Environment &get_env() const;
+
+        /* @brief: evaluate organism in an episode of the environment
+         * assign and return its fitness
+         */
+        const double evaluate(Organism<T> *org);
+
+        /* @brief: evaluate organisms and assign their fitness */
+        void evaluate(const std::vector<OrganismBase*> &orgs);
+
+        /* @brief: evaluate all organisms of the population
+         * organisms of fit >= winner_fit are winners
+         * return true if problem solved
+         */
+        bool evaluate(Population *pop, const double &winner_fit);
+    };
+}
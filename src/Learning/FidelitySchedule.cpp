@@ -0,0 +1,84 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "FidelitySchedule.h"
+#include <algorithm>
+#include <cmath>
+using namespace eSpinn;
+
+
+/* @brief: overloaded << 
+ * print fidelity
+ */
+std::ostream& eSpinn::operator<<(std::ostream &os, const Fidelity &f) {
+    os << "Fidelity: steps = " << f.steps << ", promote = " << f.promote;
+    return os;
+}
+
+
+/* @brief: constructor
+ * fractions are capped within (0, 1]
+ */
+Fidelity::Fidelity(const double &s, const double &p) :
+    steps(std::min(s, 1.0)), promote(std::min(p, 1.0))
+{
+    if (steps <= .0 || promote < .0) {
+        std::cerr << BnR_ERROR << "invalid fidelity, use full evaluation" << std::endl;
+        steps = promote = 1.0;
+    }
+}
+
+
+/* @brief: get num of steps of the screening episode
+ * at least one step, length if no screening
+ */
+const eSpinn_size Fidelity::screen_length(const eSpinn_size &length) const {
+    if (!screens())
+        return length;
+    return std::max(static_cast<eSpinn_size>(std::ceil(steps * length)), 
+        static_cast<eSpinn_size>(1));
+}
+
+
+/* @brief: choose the screened organisms to be evaluated in full
+ * i.e. the top promote fraction by their screening fitness,
+ * and the representatives of species that are screened
+ */
+std::unordered_set<const OrganismBase*> Fidelity::promoted(
+    const Population &pop, std::vector<OrganismBase*> screened) const
+{
+    std::unordered_set<const OrganismBase*> promo;
+    const eSpinn_size num = std::ceil(promote * screened.size());
+    std::stable_sort(screened.begin(), screened.end(),
+        [](const OrganismBase *a, const OrganismBase *b) {
+            return a->getFit() > b->getFit();
+        });
+    for (eSpinn_size i = 0; i < num; ++i)
+        promo.insert(screened[i]);
+    std::unordered_set<const OrganismBase*> is_screened(
+        screened.begin(), screened.end());
+    for (auto &s : pop.species) {
+        if (s->size() && is_screened.count(s->front()))
+            promo.insert(s->front());
+    }
+    return promo;
+}
+
+
+/* @brief: set fidelity from generation gen on */
+void FidelitySchedule::set(const eSpinn_size &gen, const Fidelity &f) {
+    stages[gen] = f;
+}
+
+
+/* @brief: get fidelity of generation gen
+ * i.e. the last one set at or before gen
+ */
+const Fidelity FidelitySchedule::at(const eSpinn_size &gen) const {
+    auto it = stages.upper_bound(gen);
+    if (it == stages.begin())
+        return Fidelity();
+    return (--it)->second;
+}
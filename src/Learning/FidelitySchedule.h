@@ -0,0 +1,82 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "OrganismBase.h"
+#include "Population.h"
+#include <map>
+#include <unordered_set>
+#include <vector>
+
+/* @brief: Fidelity
+ * evaluation fidelity of a generation
+ * all organisms are first screened on a short episode,
+ * i.e. the first steps fraction of the full episode,
+ * and only the top promote fraction of them, plus the representative
+ * (first) organism of each species, are evaluated on the full episode
+ * the representative of a species is usually the clone of its last champion
+ * organisms not promoted only have a screening fitness,
+ * which tasks rank below the full ones, so survivors are chosen
+ * from the promoted organisms but offspring counts of species,
+ * which are shares of the fitness sum of all organisms, are approximate
+ * no screening if either fraction is 1
+ * initialization list: fraction of steps, fraction of promoted organisms
+ */
+namespace eSpinn {
+    class Fidelity
+    {
+    private:
+        /* data */
+        double steps;
+        double promote;
+    public:
+        /* @brief: constructor - full evaluation by default */
+        Fidelity(const double &s = 1.0, const double &p = 1.0);
+
+        /* @brief: check if organisms are screened */
+        inline const bool screens() const { return steps < 1.0 && promote < 1.0; }
+
+        /* @brief: get num of steps of the screening episode
+         * at least one step, length if no screening
+         */
+        const eSpinn_size screen_length(const eSpinn_size &length) const;
+
+        /* @brief: choose the screened organisms to be evaluated in full
+         * screened organisms are ranked by their screening fitness
+         */
+        std::unordered_set<const OrganismBase*> promoted(const Population &pop,
+            std::vector<OrganismBase*> screened) const;
+
+        /* @brief: overloaded << 
+         * print fidelity
+         */
+        friend std::ostream& operator<<(std::ostream &os, const Fidelity &f);
+    };
+
+
+    /* @brief: FidelitySchedule
+     * fidelity of evaluation over generations
+     * a fidelity set at a generation applies until the next one is set
+     * full evaluation before the first one
+     */
+    class FidelitySchedule
+    {
+    private:
+        /* data */
+        std::map<eSpinn_size, Fidelity> stages;
+    public:
+        /* @brief: constructor */
+        FidelitySchedule() : stages() { }
+
+        /* @brief: set fidelity from generation gen on */
+        void set(const eSpinn_size &gen, const Fidelity &f);
+
+        /* @brief: get fidelity of generation gen */
+        const Fidelity at(const eSpinn_size &gen) const;
+    };
+}
@@ -0,0 +1,108 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "FitnessCache.h"
+#include "Utilities/Utilities.h"
+using namespace eSpinn;
+
+
+/* @brief: overloaded <<
+ * print hit rate
+ */
+std::ostream& eSpinn::operator<<(std::ostream &os, const FitnessCache &c) {
+    os << "Fitness cache: " << c.hits << " hits / " << c.misses << " misses ("
+        << 100.0 * c.hit_rate() << "%), " << c.size() << " entries";
+    return os;
+}
+
+
+/* @brief: get the key of a genome */
+std::uint64_t FitnessCache::key(const Genome &g) const {
+    const auto h = g.hash();
+    return fnv1a(&h, sizeof(h), config);
+}
+
+
+/* @brief: get the check of a genome, verifying an entry of its key */
+std::uint64_t FitnessCache::check(const Genome &g) const {
+    return g.hash(config);
+}
+
+
+/* @brief: enable or disable the cache
+ * a disabled cache misses all lookups and stores nothing
+ */
+void FitnessCache::set_enabled(const bool e) {
+    enabled = e;
+}
+
+
+/* @brief: check if the cache is enabled */
+bool FitnessCache::isenabled() const {
+    return enabled;
+}
+
+
+/* @brief: add an evaluation setting to the configuration hash */
+void FitnessCache::add_config(const double &v) {
+    config = fnv1a(&v, sizeof(v), config);
+}
+
+
+/* @brief: add an evaluation setting to the configuration hash */
+void FitnessCache::add_config(const std::string &s) {
+    config = fnv1a(s.data(), s.size(), config);
+}
+
+
+/* @brief: look up fitness of a genome
+ * return true if found and assign it to fit
+ * an entry of the same key but another check is a miss,
+ * i.e. a different genome of the same hash
+ */
+bool FitnessCache::lookup(const Genome &g, double &fit) {
+    if (!enabled)
+        return false;
+    auto it = fits.find(key(g));
+    if (it == fits.end() || it->second.second != check(g)) {
+        ++misses;
+        return false;
+    }
+    ++hits;
+    fit = it->second.first;
+    return true;
+}
+
+
+/* @brief: record fitness of a genome
+ * the cache is cleared when it is full
+ */
+void FitnessCache::store(const Genome &g, const double &fit) {
+    if (!enabled)
+        return;
+    if (fits.size() >= max_size)
+        fits.clear();
+    fits[key(g)] = std::make_pair(fit, check(g));
+}
+
+
+/* @brief: get the ratio of hits to lookups */
+double FitnessCache::hit_rate() const {
+    const auto total = hits + misses;
+    return total ? static_cast<double>(hits) / total : .0;
+}
+
+
+/* @brief: reset hit & miss counters */
+void FitnessCache::reset_stats() {
+    hits = misses = 0;
+}
+
+
+/* @brief: remove all entries */
+void FitnessCache::clear() {
+    fits.clear();
+    reset_stats();
+}
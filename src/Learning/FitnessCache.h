@@ -0,0 +1,90 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "Genome.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/* @brief: FitnessCache
+ * map the content hash of genome & evaluation configuration to fitness
+ * organisms whose genomes have been evaluated before
+ * (e.g. cloned champions, children identical to their parents)
+ * reuse the fitness instead of being simulated again
+ * only use with deterministic tasks, disable it for stochastic ones
+ * a hit is verified by a second, seeded genome hash,
+ * so colliding keys miss instead of returning another genome's fitness
+ * initialization list: max num of entries
+ */
+namespace eSpinn {
+    class FitnessCache
+    {
+        /* @brief: overloaded <<
+         * print hit rate
+         */
+        friend std::ostream& operator<<(std::ostream &os, const FitnessCache &c);
+    private:
+        /* data */
+        std::unordered_map<std::uint64_t, std::pair<double, std::uint64_t>> fits; // fitness & check
+        std::uint64_t config; // hash of evaluation configuration
+        eSpinn_size max_size;
+        unsigned long hits, misses;
+        bool enabled;
+
+        /* @brief: get the key of a genome */
+        std::uint64_t key(const Genome &g) const;
+
+        /* @brief: get the check of a genome, verifying an entry of its key */
+        std::uint64_t check(const Genome &g) const;
+    public:
+        /* @brief: constructor */
+        FitnessCache(const eSpinn_size &max = 100000) :
+            fits(), config(0), max_size(max), hits(0), misses(0), enabled(true) { }
+
+        /* @brief: enable or disable the cache
+         * a disabled cache misses all lookups and stores nothing
+         */
+        void set_enabled(const bool e);
+
+        /* @brief: check if the cache is enabled */
+        bool isenabled() const;
+
+        /* @brief: add an evaluation setting to the configuration hash
+         * add everything fitness depends on apart from the genome,
+         * e.g. timestep, reference signal, training data
+         */
+        void add_config(const double &v);
+        void add_config(const std::string &s);
+
+        /* @brief: look up fitness of a genome
+         * return true if found and assign it to fit
+         * an entry of the same key but another check is a miss
+         */
+        bool lookup(const Genome &g, double &fit);
+
+        /* @brief: record fitness of a genome
+         * the cache is cleared when it is full
+         */
+        void store(const Genome &g, const double &fit);
+
+        /* @brief: get the num of entries */
+        inline const eSpinn_size size() const { return fits.size(); }
+
+        /* @brief: get the ratio of hits to lookups */
+        double hit_rate() const;
+
+        /* @brief: reset hit & miss counters */
+        void reset_stats();
+
+        /* @brief: remove all entries */
+        void clear();
+    };
+}
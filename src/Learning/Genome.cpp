@@ -0,0 +1,650 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "Genome.h"
+#include "neat_def.h"
+#include "Utilities/Utilities.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+using namespace eSpinn;
+
+
+/* @brief: check if all structural genes are the same */
+bool Topology::operator==(const Topology &t) const {
+    return inp_size == t.inp_size && hid_size == t.hid_size
+        && outp_size == t.outp_size && neuron_id == t.neuron_id
+        && neuron_layer == t.neuron_layer && neuron_type == t.neuron_type
+        && conn_id == t.conn_id && conn_in == t.conn_in
+        && conn_out == t.conn_out && conn_type == t.conn_type;
+}
+
+
+/* @brief: content hash of all structural genes */
+std::uint64_t Topology::hash() const {
+    const eSpinn_size sizes[3] = {inp_size, hid_size, outp_size};
+    auto h = fnv1a(sizes, sizeof(sizes));
+    h = fnv1a(neuron_id, h);
+    h = fnv1a(neuron_layer, h);
+    h = fnv1a(neuron_type, h);
+    h = fnv1a(conn_id, h);
+    h = fnv1a(conn_in, h);
+    h = fnv1a(conn_out, h);
+    return fnv1a(conn_type, h);
+}
+
+
+/* @brief: table of interned topologies by their hashes
+ * shared by all threads, entries expire with the last genome using them
+ */
+struct TopologyTable {
+    std::mutex mtx;
+    std::unordered_multimap<std::uint64_t, std::weak_ptr<Topology>> entries;
+    std::size_t sweep_size; // remove expired entries when reaching this size
+};
+
+
+/* @brief: get the table of interned topologies */
+static TopologyTable& topology_table() {
+    static TopologyTable table{ {}, {}, 1024 };
+    return table;
+}
+
+
+/* @brief: get the interned empty topology */
+static const std::shared_ptr<Topology>& empty_topology() {
+    static const std::shared_ptr<Topology> topo(new Topology());
+    return topo;
+}
+
+
+/* @brief: overloaded <<
+ * print class info
+ */
+std::ostream& eSpinn::operator<<(std::ostream &os, const Genome &g) {
+    const auto &t = *g.topo;
+    os << "genome: " << t.inp_size << " inputs, " << t.hid_size << " hiddens, "
+        << t.outp_size << " outputs, " << g.conn_size() << " connections";
+    for (eSpinn_size i = 0; i < g.neuron_size(); ++i) {
+        os << std::endl << "neuron #" << t.neuron_id[i] << " l" << t.neuron_layer[i]
+            << " t" << t.neuron_type[i] << " " << g.neuron_param[i];
+    }
+    for (eSpinn_size i = 0; i < g.conn_size(); ++i) {
+        os << std::endl << "conn #" << t.conn_id[i] << " " << t.conn_in[i]
+            << "->" << t.conn_out[i] << " w=" << g.weight[i]
+            << " d=" << g.delay[i] << " en=" << int(g.enable[i])
+            << " hebb=" << g.hebb[i];
+    }
+    return os;
+}
+
+
+/* @brief: constructor - an empty genome
+ * all empty genomes share the same topology
+ */
+Genome::Genome() : topo(empty_topology()), draft(false),
+    neuron_param(), weight(), delay(), enable(), hebb(), plastic()
+{ }
+
+
+/* @brief: copy constructor
+ * the topology is shared unless it is being edited
+ */
+Genome::Genome(const Genome &g) : 
+    topo(g.draft ? std::make_shared<Topology>(*g.topo) : g.topo), draft(g.draft),
+    neuron_param(g.neuron_param), weight(g.weight), delay(g.delay),
+    enable(g.enable), hebb(g.hebb), plastic{g.plastic[0], g.plastic[1]}
+{ }
+
+
+/* @brief: copy assignment
+ * the storage of parameter genes is reused
+ * so is the storage of the topology if both are being edited
+ */
+Genome& Genome::operator=(const Genome &g) {
+    if (this == &g)
+        return *this;
+    if (!g.draft)
+        topo = g.topo;
+    else if (draft)
+        *topo = *g.topo;
+    else
+        topo = std::make_shared<Topology>(*g.topo);
+    draft = g.draft;
+    neuron_param = g.neuron_param;
+    weight = g.weight;
+    delay = g.delay;
+    enable = g.enable;
+    hebb = g.hebb;
+    plastic[0] = g.plastic[0];
+    plastic[1] = g.plastic[1];
+    return *this;
+}
+
+
+/* @brief: get the structural genes for editing
+ * the topology is copied first if it is shared
+ */
+Topology& Genome::edit_topology() {
+    if (!draft) {
+        topo = std::make_shared<Topology>(*topo);
+        draft = true;
+    }
+    return *topo;
+}
+
+
+/* @brief: share the edited topology
+ * with genomes of the same structure
+ * the topology is looked up in the table of interned ones,
+ * and added to it if not found
+ */
+void Genome::intern() {
+    if (!draft)
+        return;
+    draft = false;
+    const auto h = topo->hash();
+    auto &table = topology_table();
+    std::lock_guard<std::mutex> lock(table.mtx);
+    auto range = table.entries.equal_range(h);
+    for (auto it = range.first; it != range.second; ) {
+        auto t = it->second.lock();
+        if (!t) {
+            it = table.entries.erase(it);
+        } else if (*t == *topo) {
+            topo = t;
+            return;
+        } else {
+            ++it;
+        }
+    }
+    table.entries.emplace(h, topo);
+    if (table.entries.size() < table.sweep_size)
+        return;
+    // remove expired entries
+    for (auto it = table.entries.begin(); it != table.entries.end(); ) {
+        if (it->second.expired())
+            it = table.entries.erase(it);
+        else
+            ++it;
+    }
+    table.sweep_size = std::max(table.entries.size() * 2, 
+        static_cast<std::size_t>(1024));
+}
+
+
+/* @brief: remove all genes but keep the allocated storage
+ * the storage of a shared topology is not reused
+ */
+void Genome::clear() {
+    if (draft) {
+        auto &t = *topo;
+        t.neuron_id.clear();
+        t.neuron_layer.clear();
+        t.neuron_type.clear();
+        t.inp_size = t.hid_size = t.outp_size = 0;
+        t.conn_id.clear();
+        t.conn_in.clear();
+        t.conn_out.clear();
+        t.conn_type.clear();
+    } else {
+        topo = std::make_shared<Topology>();
+        draft = true;
+    }
+    neuron_param.clear();
+    weight.clear();
+    delay.clear();
+    enable.clear();
+    hebb.clear();
+    plastic[0].clear();
+    plastic[1].clear();
+}
+
+
+/* @brief: append a neuron gene */
+void Genome::push_neuron(const neuronID &nid, const neuronLayer &nl,
+    const neuronType &nt, const double &param)
+{
+    auto &t = edit_topology();
+    t.neuron_id.push_back(nid);
+    t.neuron_layer.push_back(nl);
+    t.neuron_type.push_back(nt);
+    neuron_param.push_back(param);
+    switch (nl) {
+        case L_INPUT: ++t.inp_size; break;
+        case L_HIDDEN: ++t.hid_size; break;
+        default: ++t.outp_size; break;
+    }
+}
+
+
+/* @brief: insert a hidden neuron gene at position pos */
+void Genome::insert_hid_neuron(const eSpinn_size &pos, const neuronID &nid,
+    const neuronType &nt, const double &param)
+{
+    auto &t = edit_topology();
+    t.neuron_id.insert(t.neuron_id.begin()+pos, nid);
+    t.neuron_layer.insert(t.neuron_layer.begin()+pos, L_HIDDEN);
+    t.neuron_type.insert(t.neuron_type.begin()+pos, nt);
+    neuron_param.insert(neuron_param.begin()+pos, param);
+    ++t.hid_size;
+}
+
+
+/* @brief: append a connection gene
+ * caller must keep connection ids sorted
+ */
+void Genome::push_conn(const connID &cid, const neuronID &iid, const neuronID &oid,
+    const double &w, const synDel &d, const bool &en,
+    const connType &ct, const HebbianType &h,
+    const double &corr, const double &mag)
+{
+    auto &t = edit_topology();
+    t.conn_id.push_back(cid);
+    t.conn_in.push_back(iid);
+    t.conn_out.push_back(oid);
+    t.conn_type.push_back(ct);
+    weight.push_back(w);
+    delay.push_back(d);
+    enable.push_back(en);
+    hebb.push_back(h);
+    plastic[0].push_back(corr);
+    plastic[1].push_back(mag);
+}
+
+
+/* @brief: insert a connection gene in the position of its id
+ * return the position inserted
+ */
+eSpinn_size Genome::insert_conn(const connID &cid, const neuronID &iid,
+    const neuronID &oid, const double &w, const synDel &d, const connType &ct)
+{
+    auto &t = edit_topology();
+    eSpinn_size pos = std::lower_bound(t.conn_id.begin(), t.conn_id.end(), cid)
+        - t.conn_id.begin();
+    t.conn_id.insert(t.conn_id.begin()+pos, cid);
+    t.conn_in.insert(t.conn_in.begin()+pos, iid);
+    t.conn_out.insert(t.conn_out.begin()+pos, oid);
+    t.conn_type.insert(t.conn_type.begin()+pos, ct);
+    weight.insert(weight.begin()+pos, w);
+    delay.insert(delay.begin()+pos, d);
+    enable.insert(enable.begin()+pos, 1);
+    hebb.insert(hebb.begin()+pos, NoHebbian);
+    plastic[0].insert(plastic[0].begin()+pos, .0);
+    plastic[1].insert(plastic[1].begin()+pos, .0);
+    return pos;
+}
+
+
+/* @brief: erase the connection gene at position pos */
+void Genome::erase_conn(const eSpinn_size &pos) {
+    auto &t = edit_topology();
+    t.conn_id.erase(t.conn_id.begin()+pos);
+    t.conn_in.erase(t.conn_in.begin()+pos);
+    t.conn_out.erase(t.conn_out.begin()+pos);
+    t.conn_type.erase(t.conn_type.begin()+pos);
+    weight.erase(weight.begin()+pos);
+    delay.erase(delay.begin()+pos);
+    enable.erase(enable.begin()+pos);
+    hebb.erase(hebb.begin()+pos);
+    plastic[0].erase(plastic[0].begin()+pos);
+    plastic[1].erase(plastic[1].begin()+pos);
+}
+
+
+/* @brief: find the position of a neuron gene by its id
+ * return neuron_size() if not found
+ */
+eSpinn_size Genome::find_neuron(const neuronID &nid) const {
+    const auto &ids = topo->neuron_id;
+    return std::find(ids.begin(), ids.end(), nid) - ids.begin();
+}
+
+
+/* @brief: get the activation sequence of the neuron at position pos
+ * inputs are 0, hiddens begin with 1, outputs are MAX_UINT
+ * the same as Neuron::n_seq in the phenotype
+ */
+eSpinn_size Genome::get_seq(const eSpinn_size &pos) const {
+    if (pos < topo->inp_size)
+        return 0;
+    else if (pos < topo->inp_size + topo->hid_size)
+        return pos - topo->inp_size + 1;
+    else
+        return -1;
+}
+
+
+/* @brief: reorder vector elements, the i-th becomes v[idx[i]] */
+template <typename T>
+static void permute(std::vector<T> &v, const std::vector<eSpinn_size> &idx) {
+    std::vector<T> tmp;
+    tmp.reserve(v.size());
+    for (auto &i : idx)
+        tmp.push_back(v[i]);
+    v.swap(tmp);
+}
+
+
+/* @brief: replace id if it is found in the map */
+template <typename T>
+static void remap_id(T &id, const std::unordered_map<T, T> &m) {
+    auto it = m.find(id);
+    if (it != m.end())
+        id = it->second;
+}
+
+
+/* @brief: replace neuron & connection ids
+ * ids not found in the maps are kept
+ * connection genes are then re-sorted by id
+ */
+void Genome::remap_ids(const std::unordered_map<neuronID, neuronID> &nmap,
+    const std::unordered_map<connID, connID> &cmap)
+{
+    if (nmap.empty() && cmap.empty())
+        return;
+    auto &t = edit_topology();
+    if (!nmap.empty()) {
+        for (auto &n : t.neuron_id)
+            remap_id(n, nmap);
+        for (auto &n : t.conn_in)
+            remap_id(n, nmap);
+        for (auto &n : t.conn_out)
+            remap_id(n, nmap);
+    }
+    for (auto &c : t.conn_id)
+        remap_id(c, cmap);
+    if (!std::is_sorted(t.conn_id.begin(), t.conn_id.end())) {
+        std::vector<eSpinn_size> idx(conn_size());
+        for (eSpinn_size i = 0; i < conn_size(); ++i)
+            idx[i] = i;
+        std::sort(idx.begin(), idx.end(), [&t](const eSpinn_size &a, const eSpinn_size &b) {
+            return t.conn_id[a] < t.conn_id[b];
+        });
+        permute(t.conn_id, idx);
+        permute(t.conn_in, idx);
+        permute(t.conn_out, idx);
+        permute(t.conn_type, idx);
+        permute(weight, idx);
+        permute(delay, idx);
+        permute(enable, idx);
+        permute(hebb, idx);
+        permute(plastic[0], idx);
+        permute(plastic[1], idx);
+    }
+    intern();
+}
+
+
+/* @brief: check if the connection already exists */
+const bool Genome::connection_exists(const neuronID &iid, const neuronID &oid) const {
+    for (eSpinn_size i = 0; i < conn_size(); ++i) {
+        if (topo->conn_in[i] == iid && topo->conn_out[i] == oid)
+            return true;
+    }
+    return false;
+}
+
+
+/* @brief: get the next available neuron id */
+const neuronID Genome::get_next_neuron_id() const {
+    neuronID n_id = 0;
+    for (auto &n : topo->neuron_id) {
+        if (n_id < n)
+            n_id = n;
+    }
+    return n_id + 1;
+}
+
+
+/* @brief: get the next available connection id */
+const connID Genome::get_next_conn_id() const {
+    connID c_id = 0;
+    for (auto &c : topo->conn_id) {
+        if (c_id < c)
+            c_id = c;
+    }
+    return c_id + 1;
+}
+
+
+/* @brief: check if the two genomes have the same topology
+ * i.e. same hidden neurons and same connection ids
+ * genomes sharing an interned topology are compared by pointer
+ */
+bool Genome::has_same_topology(const Genome &g) const {
+    if (topo == g.topo)
+        return true;
+    // don't need to compare inp size & outp size because they won't change
+    return topo->hid_size == g.topo->hid_size && topo->conn_id == g.topo->conn_id;
+}
+
+
+/* @brief: calculate the compatibility distance */
+double Genome::compat_distance(const Genome &g) const {
+    int num_disjoint = 0, num_excess = 0, num_match = 0, ddiff_total = 0;
+    double wdiff_total = 0.0;
+
+    // iterate the indices until both reach ends
+    // record the num of match and the weight difference of the match gene
+    // record the num of disjoint and excess
+    const auto &t1 = *topo, &t2 = *g.topo;
+    eSpinn_size c1 = 0, c2 = 0;
+    const eSpinn_size s1 = conn_size(), s2 = g.conn_size();
+    while (c1 != s1 || c2 != s2) {
+        if (c1 == s1) {
+            ++c2;
+            ++num_excess;
+        } else if (c2 == s2) {
+            ++c1;
+            ++num_excess;
+        } else if (t1.conn_id[c1] == t2.conn_id[c2]) {
+            ++num_match;
+            wdiff_total += std::abs(weight[c1] - g.weight[c2]);
+            ddiff_total += std::abs(int(delay[c1] - g.delay[c2]));
+            ++c1;
+            ++c2;
+        } else if (t1.conn_id[c1] < t2.conn_id[c2]) {
+            ++c1;
+            ++num_disjoint;
+        } else {
+            ++c2;
+            ++num_disjoint;
+        }
+    }
+
+    // lambda difference of sigmoid output neurons
+    double ldiff = .0;
+    const auto outp_size = t1.outp_size;
+    if (outp_size && outp_size == t2.outp_size &&
+        t1.neuron_type.back() == SIGMOID && t2.neuron_type.back() == SIGMOID)
+    {
+        const eSpinn_size n1 = neuron_size() - outp_size;
+        const eSpinn_size n2 = g.neuron_size() - outp_size;
+        for (eSpinn_size i = 0; i < outp_size; ++i) {
+            ldiff += std::abs(neuron_param[n1+i] - g.neuron_param[n2+i]);
+        }
+        ldiff /= outp_size;
+    }
+
+    /* distance = coef1 * num_dis + coef2 * num_exc + coef3 * avg_weight_diff
+     *          + coef4 * avg_delay_diff + coef5 * lambda_diff
+     */
+    return (neat::disjoint_coeff * num_disjoint
+            + neat::excess_coeff * num_excess
+            + neat::weightdiff_coeff * wdiff_total/num_match
+            + neat::delaydiff_coeff * ddiff_total/num_match
+            + neat::lambdadiff_coeff * ldiff);
+}
+
+
+/* @brief: chain hashes of all genes but the layer sizes to h */
+static std::uint64_t hash_genes(const Genome &g, std::uint64_t h) {
+    const auto &t = g.topology();
+    h = fnv1a(t.neuron_id, h);
+    h = fnv1a(t.neuron_type, h);
+    h = fnv1a(g.neuron_param, h);
+    h = fnv1a(t.conn_id, h);
+    h = fnv1a(t.conn_in, h);
+    h = fnv1a(t.conn_out, h);
+    h = fnv1a(g.weight, h);
+    h = fnv1a(g.delay, h);
+    h = fnv1a(g.enable, h);
+    h = fnv1a(t.conn_type, h);
+    h = fnv1a(g.hebb, h);
+    h = fnv1a(g.plastic[0], h);
+    return fnv1a(g.plastic[1], h);
+}
+
+
+/* @brief: content hash of all genes
+ * identical genomes have the same hash; collisions are possible
+ */
+std::uint64_t Genome::hash() const {
+    const auto &t = *topo;
+    const eSpinn_size sizes[3] = {t.inp_size, t.hid_size, t.outp_size};
+    return hash_genes(*this, fnv1a(sizes, sizeof(sizes)));
+}
+
+
+/* @brief: content hash of all genes chained to a seed
+ * genomes colliding in hash() hardly collide in it, e.g. to verify a match
+ */
+std::uint64_t Genome::hash(const std::uint64_t &seed) const {
+    const auto &t = *topo;
+    const eSpinn_size sizes[3] = {t.inp_size, t.hid_size, t.outp_size};
+    const auto h = fnv1a(&seed, sizeof(seed));
+    return hash_genes(*this, fnv1a(sizes, sizeof(sizes), h));
+}
+
+
+/* @brief: crossover with the dad genome
+ * average or random pick configurations of the matching genes
+ */
+void Genome::crossover(const Genome &dad) {
+    const auto &conn_id = topo->conn_id;
+    const auto &dad_conn_id = dad.topo->conn_id;
+    eSpinn_size c1 = 0, c2 = 0;
+    const eSpinn_size s1 = conn_size(), s2 = dad.conn_size();
+    // iterate the indices until either one reaches the end
+    while (c1 != s1 && c2 != s2) {
+        if (conn_id[c1] == dad_conn_id[c2]) {
+            // average weight
+            weight[c1] = 0.5 * (weight[c1] + dad.weight[c2]);
+            // random pick delay, hebb_type
+            if (rand() < 0.5) {
+                delay[c1] = dad.delay[c2];
+            }
+            if (rand() < 0.5) {
+                hebb[c1] = dad.hebb[c2];
+            }
+            // average plastic module, no need to cap
+            plastic[0][c1] = 0.5 * (plastic[0][c1] + dad.plastic[0][c2]);
+            plastic[1][c1] = 0.5 * (plastic[1][c1] + dad.plastic[1][c2]);
+            // enable status is the same as mom
+            ++c1;
+            ++c2;
+        } else if (conn_id[c1] < dad_conn_id[c2]) {
+            ++c1;
+        } else {
+            ++c2;
+        }
+    }
+}
+
+
+/* @brief: check if structural genes of consistent sizes are valid
+ * neurons are in layer order, neuron ids are unique,
+ * connection ids are ascending and endpoints are existing neurons
+ */
+static bool valid_topology(const Topology &t) {
+    for (eSpinn_size i = 0; i < t.neuron_layer.size(); ++i) {
+        const auto layer = i < t.inp_size ? L_INPUT
+            : i < t.inp_size + t.hid_size ? L_HIDDEN : L_OUTPUT;
+        if (t.neuron_layer[i] != layer)
+            return false;
+    }
+    auto ids = t.neuron_id;
+    std::sort(ids.begin(), ids.end());
+    if (std::adjacent_find(ids.begin(), ids.end()) != ids.end())
+        return false;
+    for (eSpinn_size i = 0; i < t.conn_id.size(); ++i) {
+        if (i && t.conn_id[i] <= t.conn_id[i-1])
+            return false;
+        if (!std::binary_search(ids.begin(), ids.end(), t.conn_in[i])
+            || !std::binary_search(ids.begin(), ids.end(), t.conn_out[i]))
+            return false;
+    }
+    return true;
+}
+
+
+/* @brief: write all genes to a binary archive */
+void Genome::archive(BinaryWriter &w) const {
+    const auto &t = *topo;
+    w.write(t.inp_size);
+    w.write(t.hid_size);
+    w.write(t.outp_size);
+    w.write(t.neuron_id);
+    w.write(t.neuron_layer);
+    w.write(t.neuron_type);
+    w.write(neuron_param);
+
+    w.write(t.conn_id);
+    w.write(t.conn_in);
+    w.write(t.conn_out);
+    w.write(weight);
+    w.write(delay);
+    w.write(enable);
+    w.write(t.conn_type);
+    w.write(hebb);
+    w.write(plastic[0]);
+    w.write(plastic[1]);
+}
+
+
+/* @brief: read all genes from a binary archive
+ * return false if the archive is corrupted, and the genome is left cleared
+ * genes must be of consistent sizes, neurons in layer order,
+ * connection ids ascending and endpoints existing neurons
+ */
+bool Genome::load(BinaryReader &r) {
+    auto &t = edit_topology();
+    r.read(t.inp_size);
+    r.read(t.hid_size);
+    r.read(t.outp_size);
+    r.read(t.neuron_id);
+    r.read(t.neuron_layer);
+    r.read(t.neuron_type);
+    r.read(neuron_param);
+
+    r.read(t.conn_id);
+    r.read(t.conn_in);
+    r.read(t.conn_out);
+    r.read(weight);
+    r.read(delay);
+    r.read(enable);
+    r.read(t.conn_type);
+    r.read(hebb);
+    r.read(plastic[0]);
+    r.read(plastic[1]);
+
+    // genes of each kind must be of the same size
+    const auto nn = neuron_size(), nc = conn_size();
+    const bool ok = r.ok() && t.inp_size + t.hid_size + t.outp_size == nn
+        && t.neuron_layer.size() == nn && t.neuron_type.size() == nn
+        && neuron_param.size() == nn
+        && t.conn_in.size() == nc && t.conn_out.size() == nc && weight.size() == nc
+        && delay.size() == nc && enable.size() == nc && t.conn_type.size() == nc
+        && hebb.size() == nc && plastic[0].size() == nc && plastic[1].size() == nc
+        && valid_topology(t);
+    if (!ok) {
+        clear();
+        return false;
+    }
+    intern();
+    return true;
+}
@@ -0,0 +1,208 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "Utilities/BinaryArchive.h"
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/* @brief: Topology
+ * structural genes of a genome, i.e. neurons & connection endpoints
+ * neuron genes are ordered as: inputs, hiddens (in activation order), outputs
+ * connection genes are sorted by connection id
+ * genomes of the same structure share one interned topology,
+ * which is never changed once interned
+ */
+namespace eSpinn {
+    struct Topology
+    {
+        /* neuron genes */
+        std::vector<neuronID> neuron_id;
+        std::vector<neuronLayer> neuron_layer;
+        std::vector<neuronType> neuron_type;
+        eSpinn_size inp_size, hid_size, outp_size;
+
+        /* connection genes */
+        std::vector<connID> conn_id;
+        std::vector<neuronID> conn_in, conn_out;
+        std::vector<connType> conn_type;
+
+        /* @brief: constructor - an empty topology */
+        Topology() : inp_size(0), hid_size(0), outp_size(0) { }
+
+        /* @brief: check if all structural genes are the same */
+        bool operator==(const Topology &t) const;
+
+        /* @brief: content hash of all structural genes */
+        std::uint64_t hash() const;
+    };
+
+
+    /* @brief: Genome
+     * compact genotype of a network, used as the unit of evolution
+     * genes are stored in contiguous arrays (structure of arrays)
+     * structural genes are kept in a shared topology,
+     * parameter genes are owned by each genome
+     * so copying a genome only copies the parameters
+     * editing the topology works on a private copy (copy-on-write),
+     * call intern() when done to share it with genomes of the same structure
+     * the phenotype (Network) is built from the genome only when evaluated
+     */
+    class Genome
+    {
+        /* @brief: overloaded <<
+         * print class info
+         */
+        friend std::ostream& operator<<(std::ostream &os, const Genome &g);
+    private:
+        /* data */
+        std::shared_ptr<Topology> topo;
+        bool draft; // topo is a private copy being edited, not interned
+    public:
+        /* neuron genes */
+        std::vector<double> neuron_param; // lambda of sigmoid neurons
+
+        /* connection genes */
+        std::vector<double> weight;
+        std::vector<synDel> delay;
+        std::vector<unsigned char> enable;
+        std::vector<HebbianType> hebb;
+        std::vector<double> plastic[2]; // indexed the same as HebbPlasticity
+    public:
+        /* @brief: constructor - an empty genome */
+        Genome();
+
+        /* @brief: copy constructor
+         * the topology is shared unless it is being edited
+         */
+        Genome(const Genome &g);
+
+        /* @brief: copy assignment
+         * the storage of parameter genes is reused
+         */
+        Genome& operator=(const Genome &g);
+
+        /* @brief: get the structural genes */
+        inline const Topology& topology() const { return *topo; }
+
+        /* @brief: get the interned topology
+         * genomes of the same structure get the same pointer
+         * nullptr if the topology is being edited
+         */
+        inline std::shared_ptr<const Topology> shared_topology() const {
+            return draft ? nullptr : topo;
+        }
+
+        /* @brief: get the structural genes for editing
+         * the topology is copied first if it is shared
+         */
+        Topology& edit_topology();
+
+        /* @brief: share the edited topology
+         * with genomes of the same structure
+         */
+        void intern();
+
+        /* @brief: remove all genes but keep the allocated storage */
+        void clear();
+
+        /* @brief: get neuron size */
+        inline const eSpinn_size neuron_size() const { return topo->neuron_id.size(); }
+
+        /* @brief: get connection size */
+        inline const eSpinn_size conn_size() const { return topo->conn_id.size(); }
+
+        /* @brief: append a neuron gene */
+        void push_neuron(const neuronID &nid, const neuronLayer &nl,
+            const neuronType &nt, const double &param);
+
+        /* @brief: insert a hidden neuron gene at position pos */
+        void insert_hid_neuron(const eSpinn_size &pos, const neuronID &nid,
+            const neuronType &nt, const double &param);
+
+        /* @brief: append a connection gene
+         * caller must keep connection ids sorted
+         */
+        void push_conn(const connID &cid, const neuronID &iid, const neuronID &oid,
+            const double &w, const synDel &d, const bool &en,
+            const connType &ct, const HebbianType &h,
+            const double &corr, const double &mag);
+
+        /* @brief: insert a connection gene in the position of its id
+         * return the position inserted
+         */
+        eSpinn_size insert_conn(const connID &cid, const neuronID &iid,
+            const neuronID &oid, const double &w, const synDel &d,
+            const connType &ct);
+
+        /* @brief: erase the connection gene at position pos */
+        void erase_conn(const eSpinn_size &pos);
+
+        /* @brief: find the position of a neuron gene by its id
+         * return neuron_size() if not found
+         */
+        eSpinn_size find_neuron(const neuronID &nid) const;
+
+        /* @brief: get the activation sequence of the neuron at position pos
+         * inputs are 0, hiddens begin with 1, outputs are MAX_UINT
+         * the same as Neuron::n_seq in the phenotype
+         */
+        eSpinn_size get_seq(const eSpinn_size &pos) const;
+
+        /* @brief: replace neuron & connection ids
+         * ids not found in the maps are kept
+         * connection genes are then re-sorted by id
+         */
+        void remap_ids(const std::unordered_map<neuronID, neuronID> &nmap,
+            const std::unordered_map<connID, connID> &cmap);
+
+        /* @brief: check if the connection already exists */
+        const bool connection_exists(const neuronID &iid, const neuronID &oid) const;
+
+        /* @brief: get the next available neuron id */
+        const neuronID get_next_neuron_id() const;
+
+        /* @brief: get the next available connection id */
+        const connID get_next_conn_id() const;
+
+        /* @brief: check if the two genomes have the same topology
+         * i.e. same hidden neurons and same connection ids
+         * genomes sharing an interned topology are compared by pointer
+         */
+        bool has_same_topology(const Genome &g) const;
+
+        /* @brief: calculate the compatibility distance */
+        double compat_distance(const Genome &g) const;
+
+        /* @brief: content hash of all genes
+         * identical genomes have the same hash; collisions are possible
+         */
+        std::uint64_t hash() const;
+
+        /* @brief: content hash of all genes chained to a seed
+         * genomes colliding in hash() hardly collide in it, e.g. to verify a match
+         */
+        std::uint64_t hash(const std::uint64_t &seed) const;
+
+        /* @brief: crossover with the dad genome
+         * average or random pick configurations of the matching genes
+         */
+        void crossover(const Genome &dad);
+
+        /* @brief: write all genes to a binary archive */
+        void archive(BinaryWriter &w) const;
+
+        /* @brief: read all genes from a binary archive
+         * return false if the archive is corrupted, the genome is left cleared
+         */
+        bool load(BinaryReader &r);
+    };
+}
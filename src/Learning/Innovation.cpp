@@ -18,3 +18,21 @@ std::ostream& eSpinn::operator<<(std::ostream &os, const Innovation &inno) {
         << " " << inno.new_weight << " " << inno.new_conn_type;
     return os;
 }
+
+
+/* @brief: check if inno is the same mutation as this innovation
+ * i.e. the same type and applied to the same place
+ */
+bool Innovation::matches(const Innovation &inno) const {
+    if (i_type != inno.i_type)
+        return false;
+    switch (i_type) {
+        case neat::NEWNODE:
+            return inodeid == inno.inodeid && onodeid == inno.onodeid &&
+                old_connid == inno.old_connid;
+        case neat::NEWCONN:
+            return inodeid == inno.inodeid && onodeid == inno.onodeid;
+        default: // NEWNODE_IN2OUT
+            return new_nodeid == inno.new_nodeid;
+    }
+}
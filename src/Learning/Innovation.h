@@ -98,6 +98,11 @@ namespace eSpinn {
             new_weight(.0), new_conn_type(DEFAULTCONN) 
         { }
 
+        /* @brief: check if inno is the same mutation as this innovation
+         * i.e. the same type and applied to the same place
+         */
+        bool matches(const Innovation &inno) const;
+
         /* @brief: default destructor */
         ~Innovation() {
             #ifdef ESPINN_VERBOSE
@@ -0,0 +1,139 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "Island.h"
+#include <cstdio>
+#include <fstream>
+using namespace eSpinn;
+
+
+/* @brief: get the archive name of a migration */
+std::string Island::filename(const eSpinn_size &src, const eSpinn_size &dst,
+    const eSpinn_size &seq) const
+{
+    return dir + "to" + std::to_string(dst) + "_from" + std::to_string(src)
+        + "_" + std::to_string(seq) + ".arch";
+}
+
+
+/* @brief: get the islands migrants are sent to */
+std::vector<eSpinn_size> Island::destinations() const {
+    std::vector<eSpinn_size> dst;
+    if (num_islands < 2)
+        return dst;
+    if (topology == RING) {
+        dst.push_back((island_id + 1) % num_islands);
+    } else {
+        for (eSpinn_size i = 0; i < num_islands; ++i) {
+            if (i != island_id)
+                dst.push_back(i);
+        }
+    }
+    return dst;
+}
+
+
+/* @brief: get the islands migrants are received from */
+std::vector<eSpinn_size> Island::sources() const {
+    std::vector<eSpinn_size> src;
+    if (num_islands < 2)
+        return src;
+    if (topology == RING) {
+        src.push_back((island_id + num_islands - 1) % num_islands);
+    } else {
+        for (eSpinn_size i = 0; i < num_islands; ++i) {
+            if (i != island_id)
+                src.push_back(i);
+        }
+    }
+    return src;
+}
+
+
+/* @brief: get island id */
+const eSpinn_size Island::getID() const {
+    return island_id;
+}
+
+
+/* @brief: exchange migrants if it is a migration generation
+ * call after evaluating the population and before epoch()
+ * return the num of immigrants
+ */
+eSpinn_size Island::migrate(const eSpinn_size &gen) {
+    if (gen % interval)
+        return 0;
+    emigrate(gen);
+    return immigrate();
+}
+
+
+/* @brief: send copies of the best organisms to destination islands */
+void Island::emigrate(const eSpinn_size &gen) {
+    Migrants m;
+    m.island = island_id;
+    m.gen = gen;
+    for (auto &o : pop->get_top_orgs(count)) {
+        auto dup = o->duplicate(o->getID(), gen);
+        dup->setFit(o->getFit());
+        m.orgs.push_back(dup);
+    }
+    // innovations are owned by the population, don't delete them
+    m.innovation = pop->innovation;
+
+    for (auto &dst : destinations()) {
+        // write to a temporary file and rename it,
+        // so that the destination never reads a partial archive
+        const auto fname = filename(island_id, dst, sent);
+        const auto tmp = fname + ".tmp";
+        std::ofstream ofs(tmp);
+        if (!ofs) {
+            std::cerr << BnR_ERROR << "Can't open file " << tmp << std::endl;
+            continue;
+        }
+        {
+            boost::archive::text_oarchive oa(ofs);
+            oa & m;
+        }
+        ofs.close();
+        if (std::rename(tmp.c_str(), fname.c_str()))
+            std::cerr << BnR_ERROR << "Can't rename file " << tmp << std::endl;
+    }
+    m.innovation.clear();
+    ++sent;
+}
+
+
+/* @brief: integrate migrants that have arrived
+ * migrants do not wait for each other, an island takes what is available
+ * return the num of immigrants
+ */
+eSpinn_size Island::immigrate() {
+    eSpinn_size num = 0;
+    for (auto &src : sources()) {
+        // read all migrations from src in order
+        while (true) {
+            const auto fname = filename(src, island_id, received[src]);
+            std::ifstream ifs(fname);
+            if (!ifs)
+                break;
+            Migrants m;
+            {
+                boost::archive::text_iarchive ia(ifs);
+                ia & m;
+            }
+            ifs.close();
+            std::remove(fname.c_str());
+            ++received[src];
+
+            num += m.orgs.size();
+            std::cout << "Island #" << island_id << " received " << m.orgs.size()
+                << " migrants from island #" << m.island << " (gen " << m.gen << ")"
+                << std::endl;
+            pop->immigrate(m.orgs, m.innovation);
+        }
+    }
+    return num;
+}
@@ -0,0 +1,119 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "OrganismBase.h"
+#include "Innovation.h"
+#include "Population.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+/* @brief: Migrants
+ * organisms sent from one island to another,
+ * together with the innovations of the source island
+ * which are used to reconcile innovation ids on the destination island
+ * migrants own the organisms & innovations
+ */
+namespace eSpinn {
+    struct Migrants
+    {
+        eSpinn_size island, gen; // source island & generation
+        std::vector<OrganismBase *> orgs;
+        std::vector<Innovation *> innovation;
+
+        Migrants() : island(0), gen(0), orgs(), innovation() { }
+        Migrants(const Migrants&) = delete;
+        Migrants& operator=(const Migrants&) = delete;
+        ~Migrants() {
+            for (auto &o : orgs)
+                delete o;
+            for (auto &i : innovation)
+                delete i;
+        }
+
+        template <typename Archive>
+        void serialize(Archive &ar, const unsigned int version) {
+            ar & island & gen;
+            ar & orgs & innovation;
+        }
+    };
+
+    /* @brief: migration topology
+     * RING: island i sends migrants to island i+1
+     * FULL: every island sends migrants to all the others
+     */
+    enum migrationTopology {
+        RING = 0,
+        FULL = 1
+    };
+
+
+    /* @brief: Island
+     * one of the populations in an island model
+     * islands evolve independently (in separate processes or threads)
+     * and exchange their best organisms every few generations
+     * migrants are exchanged through archives in a shared directory
+     * named as "to<dst>_from<src>_<seq>.arch"
+     * the directory should be emptied before a run
+     * initialization list: population, island id, num of islands, directory,
+     *      migration interval, num of migrants, topology
+     */
+    class Island
+    {
+    private:
+        /* data */
+        Population *pop;
+        eSpinn_size island_id, num_islands;
+        std::string dir;
+        eSpinn_size interval, count;
+        migrationTopology topology;
+        eSpinn_size sent; // num of migrations sent
+        std::vector<eSpinn_size> received; // num of migrations received from each island
+
+        /* @brief: get the archive name of a migration */
+        std::string filename(const eSpinn_size &src, const eSpinn_size &dst,
+            const eSpinn_size &seq) const;
+
+        /* @brief: get the islands migrants are sent to */
+        std::vector<eSpinn_size> destinations() const;
+
+        /* @brief: get the islands migrants are received from */
+        std::vector<eSpinn_size> sources() const;
+    public:
+        /* @brief: constructor
+         * the island does not own the population
+         */
+        Island(Population *const p, const eSpinn_size &id, const eSpinn_size &num,
+            const std::string &d, const eSpinn_size &i = 5, const eSpinn_size &c = 2,
+            const migrationTopology &t = RING) :
+            pop(p), island_id(id), num_islands(num), dir(d),
+            interval(i ? i : 1), count(c), topology(t), sent(0), received(num, 0) { }
+
+        /* @brief: get island id */
+        const eSpinn_size getID() const;
+
+        /* @brief: exchange migrants if it is a migration generation
+         * call after evaluating the population and before epoch()
+         * return the num of immigrants
+         */
+        eSpinn_size migrate(const eSpinn_size &gen);
+
+        /* @brief: send copies of the best organisms to destination islands */
+        void emigrate(const eSpinn_size &gen);
+
+        /* @brief: integrate migrants that have arrived
+         * migrants do not wait for each other, an island takes what is available
+         * return the num of immigrants
+         */
+        eSpinn_size immigrate();
+    };
+}
@@ -0,0 +1,224 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "MutationEngine.h"
+#include "Models/HebbPlasticity.h"
+#include "Utilities/Utilities.h"
+#include <algorithm>
+#include <cmath>
+using namespace eSpinn;
+
+
+/* @brief: mutation settings of each gene kind
+ * a gene is mutated with prob, by creep mutation with creep_prob
+ * (adding a normal value of sigma, enlarged while smaller than min)
+ * otherwise by random reset within reset[]
+ * creep mutated genes are capped within cap[]
+ */
+namespace {
+    struct GeneSettings
+    {
+        double prob, creep_prob;
+        double sigma, min;
+        double cap[2], reset[2];
+    };
+
+    const GeneSettings settings[MutationEngine::NUM_GENE_KINDS] = {
+        // WEIGHT
+        {neat::mutate_weight_prob, neat::creep_mutate_prob, 0.1, neat::mutate_weight_min,
+            {-params::MAX_WEIGHT, params::MAX_WEIGHT}, {-1.0, 1.0}},
+        // LAMBDA
+        {neat::mutate_lambda_prob, neat::creep_mutate_prob, 0.2, neat::mutate_lambda_min,
+            {params::MIN_LAMBDA, params::MAX_LAMBDA}, {params::MIN_LAMBDA, params::MAX_LAMBDA}},
+        // PLASTIC_CORR
+        {neat::mutate_plasticity_prob, neat::plasticity_creep_mutate_prob, 0.05, .0,
+            {HebbPlasticity::_corr[0], HebbPlasticity::_corr[1]}, {-1.0, 1.0}},
+        // PLASTIC_MAG
+        {neat::mutate_plasticity_prob, neat::plasticity_creep_mutate_prob, 0.05, .0,
+            {HebbPlasticity::_mag[0], HebbPlasticity::_mag[1]}, {-1.0, 1.0}},
+    };
+
+    // map 32 random bits to [0, 1)
+    constexpr double to_unit = 1.0 / 4294967296.0;
+    // num of times a small creep value is enlarged
+    constexpr eSpinn_size enlarge_times = 5;
+
+    // low & high 32 bits of a random word
+    inline std::uint32_t lo(const std::uint64_t &w) { return static_cast<std::uint32_t>(w); }
+    inline std::uint32_t hi(const std::uint64_t &w) { return static_cast<std::uint32_t>(w >> 32); }
+
+    // quantiles of the standard half-normal distribution are tabulated in
+    // 2^table_bits bins of equal probability, and interpolated within a bin
+    constexpr eSpinn_size table_bits = 12;
+    constexpr eSpinn_size table_size = 1u << table_bits;
+    constexpr eSpinn_size frac_bits = 31 - table_bits;
+
+    /* @brief: quantile of the standard half-normal distribution
+     * i.e. z of P(|Z| > z) = q, solved by Newton's method from z
+     */
+    double half_normal_quantile(const double &q, double z) {
+        const double log_q = std::log(q);
+        for (eSpinn_size i = 0; i < 50; ++i) {
+            const double p = std::erfc(z * M_SQRT1_2);
+            const double dz = (std::log(p) - log_q) * p
+                / (M_SQRT2 / std::sqrt(M_PI) * std::exp(-z*z/2));
+            z += dz;
+            if (std::abs(dz) < 1e-14 * (1 + z))
+                break;
+        }
+        return z;
+    }
+
+    /* @brief: quantile table, the last bin is not interpolated */
+    const std::vector<double>& half_normal_table() {
+        static const std::vector<double> table = [] {
+            std::vector<double> t(table_size);
+            t[0] = .0;
+            for (eSpinn_size i = 1; i < table_size; ++i)
+                t[i] = half_normal_quantile(1.0 - static_cast<double>(i) / table_size, t[i-1]);
+            return t;
+        }();
+        return table;
+    }
+
+    /* @brief: make a standard normal value from 32 random bits
+     * the top bit is the sign, the others pick the quantile
+     */
+    inline double normal_of(const std::uint32_t &w, const double *table) {
+        const std::uint32_t b = w & 0x7fffffff;
+        const std::uint32_t i = b >> frac_bits;
+        const double f = ((b & ((1u << frac_bits) - 1)) + .5) / (1u << frac_bits);
+        // the tail beyond the last bin is solved exactly, it is rarely hit
+        const double z = i + 1 < table_size ?
+            table[i] + f * (table[i+1] - table[i]) :
+            half_normal_quantile((1.0 - f) / table_size, table[i]);
+        return w >> 31 ? -z : z;
+    }
+}
+
+
+/* @brief: constructor */
+MutationEngine::MutationEngine() : num_genes(), bits(), normal() { }
+
+
+/* @brief: queue a span of genes */
+void MutationEngine::push(const GeneKind &k, double *genes, const eSpinn_size &n) {
+    if (!n)
+        return;
+    spans[k].push_back(Span{genes, n});
+    num_genes[k] += n;
+}
+
+
+/* @brief: queue connection weights of genome g */
+void MutationEngine::add_weights(Genome &g) {
+    push(WEIGHT, g.weight.data(), g.weight.size());
+}
+
+
+/* @brief: queue lambda of sigmoid neurons of genome g
+ * each run of consecutive sigmoid neurons is one span
+ */
+void MutationEngine::add_lambdas(Genome &g) {
+    const auto &type = g.topology().neuron_type;
+    for (eSpinn_size n = 0; n < type.size(); ) {
+        if (type[n] != SIGMOID) {
+            ++n;
+            continue;
+        }
+        auto begin = n;
+        while (n < type.size() && type[n] == SIGMOID)
+            ++n;
+        push(LAMBDA, &g.neuron_param[begin], n - begin);
+    }
+}
+
+
+/* @brief: queue connection plastic terms of genome g */
+void MutationEngine::add_plastic_terms(Genome &g) {
+    push(PLASTIC_CORR, g.plastic[0].data(), g.plastic[0].size());
+    push(PLASTIC_MAG, g.plastic[1].data(), g.plastic[1].size());
+}
+
+
+/* @brief: get num of queued genes */
+const eSpinn_size MutationEngine::size() const {
+    eSpinn_size s = 0;
+    for (auto &n : num_genes)
+        s += n;
+    return s;
+}
+
+
+/* @brief: mutate all queued genes and clear the queue
+ * random numbers are drawn from the calling thread's engine
+ * the genomes must stay alive and unresized until then
+ */
+void MutationEngine::mutate() {
+    for (eSpinn_size k = 0; k < NUM_GENE_KINDS; ++k) {
+        mutate(static_cast<GeneKind>(k));
+        spans[k].clear();
+        num_genes[k] = 0;
+    }
+}
+
+
+/* @brief: mutate all queued genes of kind k
+ * random words are made in bulk from a SplitMix64 stream
+ * seeded by the calling thread's engine
+ * each gene takes 2 words: whether to mutate & whether to creep,
+ * the reset value & 2 bits for each enlargement
+ * normal values are made in pairs, one word a pair,
+ * by interpolating tabulated quantiles (inverse transform sampling)
+ */
+void MutationEngine::mutate(const GeneKind &k) {
+    const auto n = num_genes[k];
+    if (!n)
+        return;
+    const auto &s = settings[k];
+    const auto pairs = (n + 1) / 2;
+
+    // draw all random numbers in bulk
+    auto &e = rand_engine();
+    const std::uint64_t seed = (static_cast<std::uint64_t>(e()) << 32) | e();
+    bits.resize(2*n + pairs);
+    for (eSpinn_size i = 0; i < bits.size(); ++i)
+        bits[i] = splitmix64(seed, i);
+    auto decide = bits.data(), reset = decide + n, u_normal = reset + n;
+    normal.resize(2*pairs);
+    const auto table = half_normal_table().data();
+    for (eSpinn_size i = 0; i < pairs; ++i) {
+        normal[2*i] = s.sigma * normal_of(lo(u_normal[i]), table);
+        normal[2*i+1] = s.sigma * normal_of(hi(u_normal[i]), table);
+    }
+
+    // a creep value shall not be too small, it is enlarged
+    // by a factor of 2~5 while it is, at most enlarge_times times
+    const double min = s.min;
+    for (eSpinn_size i = 0; i < n; ++i) {
+        std::uint32_t m = hi(reset[i]);
+        for (eSpinn_size t = 0; t < enlarge_times; ++t, m >>= 2)
+            normal[i] *= std::abs(normal[i]) < min ? 2.0 + (m & 3) : 1.0;
+    }
+
+    // creep mutation, random reset or unchanged
+    const double lo_cap = s.cap[0], hi_cap = s.cap[1];
+    const double lo_reset = s.reset[0], span_reset = s.reset[1] - s.reset[0];
+    const std::uint64_t p_mutate = static_cast<std::uint64_t>(s.prob * 4294967296.0);
+    const std::uint64_t p_creep = static_cast<std::uint64_t>(s.creep_prob * 4294967296.0);
+    const double *z = normal.data();
+    for (auto &span : spans[k]) {
+        auto x = span.genes;
+        for (eSpinn_size i = 0; i < span.size; ++i) {
+            const double creep = std::min(std::max(x[i] + z[i], lo_cap), hi_cap);
+            const double r = lo_reset + span_reset * (lo(reset[i]) * to_unit);
+            const double y = hi(decide[i]) < p_creep ? creep : r;
+            x[i] = lo(decide[i]) < p_mutate ? y : x[i];
+        }
+        z += span.size;
+        reset += span.size;
+        decide += span.size;
+    }
+}
@@ -0,0 +1,77 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "neat_def.h"
+#include "Genome.h"
+#include <cstdint>
+#include <vector>
+
+/* @brief: MutationEngine
+ * mutate the parameter genes of many genomes in one go
+ * genes are queued as contiguous spans of the genomes' storage,
+ * random numbers for all queued genes are drawn in bulk,
+ * and creep/reset/cap are applied as branch-free array operations
+ * each gene is mutated with the same probabilities and distributions
+ * as mutating it on its own, but the random stream is consumed differently
+ */
+namespace eSpinn {
+    class MutationEngine
+    {
+    public:
+        /* @brief: kinds of parameter genes */
+        enum GeneKind {
+            WEIGHT = 0,
+            LAMBDA,
+            PLASTIC_CORR,
+            PLASTIC_MAG,
+            NUM_GENE_KINDS
+        };
+    private:
+        /* @brief: a contiguous run of genes */
+        struct Span
+        {
+            double *genes;
+            eSpinn_size size;
+        };
+
+        /* data */
+        std::vector<Span> spans[NUM_GENE_KINDS];
+        eSpinn_size num_genes[NUM_GENE_KINDS];
+        // random numbers, reused between calls
+        std::vector<std::uint64_t> bits;
+        std::vector<double> normal;
+
+        /* @brief: queue a span of genes */
+        void push(const GeneKind &k, double *genes, const eSpinn_size &n);
+
+        /* @brief: mutate all queued genes of kind k */
+        void mutate(const GeneKind &k);
+    public:
+        /* @brief: constructor */
+        MutationEngine();
+
+        /* @brief: queue connection weights of genome g */
+        void add_weights(Genome &g);
+
+        /* @brief: queue lambda of sigmoid neurons of genome g */
+        void add_lambdas(Genome &g);
+
+        /* @brief: queue connection plastic terms of genome g */
+        void add_plastic_terms(Genome &g);
+
+        /* @brief: get num of queued genes */
+        const eSpinn_size size() const;
+
+        /* @brief: mutate all queued genes and clear the queue
+         * random numbers are drawn from the calling thread's engine
+         * the genomes must stay alive and unresized until then
+         */
+        void mutate();
+    };
+}
@@ -7,6 +7,8 @@
 // put include here to avoid circular dependency
 #include "Models/Network.h"
 #include "Species.h" // avoid forward declaration error
+#include "OrganismPool.h"
+#include <algorithm>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/serialization/export.hpp>
@@ -19,7 +21,7 @@ using namespace eSpinn;
 template <typename T>
 std::ostream& Organism<T>::print(std::ostream &os) const {
     OrganismBase::print(os);
-    os << *net;
+    os << *getNet();
     return os;
 }
 
@@ -30,19 +32,118 @@ std::ostream& Organism<T>::print(std::ostream &os) const {
 template <typename T>
 void Organism<T>::setID(const netID &oid) {
     org_id = oid;
-    net->setID(oid);
+    if (net)
+        net->setID(oid);
 }
 
 
 /* @brief: duplicate this organism
  * with a new id and which generation
+ * only the genome is copied
  * method use new operator, should delete the returned object
  * maually or in wrapped up classes
  */
 template <typename T>
 Organism<T>* Organism<T>::duplicate(const netID &n, const eSpinn_size &g) {
-    auto new_net = net->duplicate(n);
-    return (new Organism(new_net, g));
+    return (new Organism(genome, n, g));
+}
+
+
+/* @brief: turn this organism into a duplicate of src
+ * with a new id and which generation
+ * genome storage is reused and the phenotype is kept
+ * to be refreshed from the new genome when needed
+ * return false if src is not of the same type
+ */
+template <typename T>
+bool Organism<T>::recycle(const OrganismBase *src,
+    const netID &n, const eSpinn_size &g)
+{
+    auto o = dynamic_cast<const Organism<T>*>(src);
+    if (!o)
+        return false;
+    reset_states(n, g);
+    genome = o->genome; // vector assignment reuses the allocated storage
+    invalidate_net();
+    return true;
+}
+
+
+/* @brief: return pointer to net
+ * the phenotype is built from the genome if it does not exist
+ * a stale phenotype is refreshed in place if the topology is unchanged
+ * i.e. the genome still shares the topology net is built from,
+ * or the topology is found the same by comparing genes
+ */
+template <typename T>
+T *const Organism<T>::getNet() const {
+    if (net && stale) {
+        auto topo = genome.shared_topology();
+        if (topo && topo == net_topo) {
+            net->refresh_params(genome);
+        } else if (!net->refresh(genome)) {
+            release_net();
+        }
+        if (net) {
+            net->setID(org_id);
+            net_topo = topo;
+            ++alloc_stats().nets_reused;
+        }
+    }
+    stale = false;
+    if (!net) {
+        net = new T(org_id, genome);
+        net_topo = genome.shared_topology();
+        auto &stats = alloc_stats();
+        ++stats.nets_built;
+        stats.neurons_new += genome.neuron_size();
+        stats.conns_new += genome.conn_size();
+    }
+    return net;
+}
+
+
+/* @brief: release the phenotype
+ * it will be rebuilt from the genome when needed
+ */
+template <typename T>
+void Organism<T>::release_net() const {
+    delete net;
+    net = nullptr;
+    net_topo.reset();
+    stale = false;
+}
+
+
+/* @brief: re-encode the genome from the phenotype */
+template <typename T>
+void Organism<T>::sync_genome() {
+    if (net && !stale) {
+        net->encode(genome);
+        net_topo = genome.shared_topology();
+    }
+}
+
+
+/* @brief: set Hebbian type of all connections */
+template <typename T>
+void Organism<T>::set_connection_hebb_type(const HebbianType &h) {
+    for (auto &hebb : genome.hebb) {
+        hebb = h;
+    }
+    invalidate_net();
+}
+
+
+/* @brief: replace neuron & connection ids of the genome
+ * ids not found in the maps are kept
+ */
+template <typename T>
+void Organism<T>::remap_ids(const std::unordered_map<neuronID, neuronID> &nmap,
+    const std::unordered_map<connID, connID> &cmap)
+{
+    genome.remap_ids(nmap, cmap);
+    invalidate_net();
 }
 
 
@@ -50,12 +151,7 @@ Organism<T>* Organism<T>::duplicate(const netID &n, const eSpinn_size &g) {
  */
 template <typename T>
 const neuronID Organism<T>::get_next_neuron_id() const {
-    neuronID n_id = 0;
-    for (auto &n : net->neurons) {
-        if (n_id < n->getID())
-            n_id = n->getID();
-    }
-    return n_id + 1;
+    return genome.get_next_neuron_id();
 }
 
 
@@ -63,12 +159,7 @@ const neuronID Organism<T>::get_next_neuron_id() const {
  */
 template <typename T>
 const connID Organism<T>::get_next_conn_id() const {
-    connID c_id = 0;
-    for (auto &c : net->connections) {
-        if (c_id < c->getID())
-            c_id = c->getID();
-    }
-    return c_id + 1;
+    return genome.get_next_conn_id();
 }
 
 
@@ -83,105 +174,65 @@ double Organism<T>::calCompatDistance(OrganismBase *orgbase) {
         return neat::compat_threshold + 1;
     }
 
-    int num_disjoint = 0, num_excess = 0, num_match = 0, ddiff_total = 0;
-    double wdiff_total = 0.0;
-    
-    auto c1 = net->connections.begin();
-    auto c2 = org->net->connections.begin();
-    
-    // iterate the pointers until both reach ends
-    // record the num of match and the weight difference of the match gene
-    // record the num of disjoint and excess
-    while ((c1 != net->connections.end()) || (c2 != org->net->connections.end())) {
-        if (c1 == net->connections.end()) {
-            ++c2;
-            ++num_excess;
-        } else if (c2 == org->net->connections.end()) {
-            ++c1;
-            ++num_excess;
-        } else {
-            auto c1_id = (*c1)->getID();
-            auto c2_id = (*c2)->getID();
-            if (c1_id == c2_id) {
-                ++num_match;
-                wdiff_total += std::abs((*c1)->getWeight() - (*c2)->getWeight());
-                ddiff_total += std::abs(int((*c1)->getDelay() - (*c2)->getDelay()));
-                
-                ++c1;
-                ++c2;
-            } else if (c1_id < c2_id) {
-                ++c1;
-                ++num_disjoint;
-            } else {
-                ++c2;
-                ++num_disjoint;
-            }
-        }
-    }
-
-    double ldiff = .0;
-    if (net->get_outp_type() == typeid(SigmNeuron) && 
-        org->net->get_outp_type() == typeid(SigmNeuron))
-    {
-        auto n1 = net->outp_neurons.begin();
-        auto n2 = org->net->outp_neurons.begin();
-        for (auto i = 0; i < net->get_outp_size(); ++i) {
-            auto sn1 = dynamic_cast<SigmNeuron*>(*n1);
-            auto sn2 = dynamic_cast<SigmNeuron*>(*n2);
-            ldiff += std::abs(sn1->getLambda() - sn2->getLambda());
-            ++n1;
-            ++n2;
-        }
-        ldiff /= net->get_outp_size();
-    }
-
-    /* distance = coef1 * num_dis + coef2 * num_exc + coef3 * avg_weight_diff
-     *          + coef4 * avg_delay_diff + coef5 * lambda_diff
-     */
-    return (neat::disjoint_coeff * num_disjoint
-            + neat::excess_coeff * num_excess
-            + neat::weightdiff_coeff * wdiff_total/num_match
-            + neat::delaydiff_coeff * ddiff_total/num_match
-            + neat::lambdadiff_coeff * ldiff);
+    return genome.compat_distance(org->genome);
 }
 
 
 /* @brief: randomize connection weights */
 template <typename T>
 void Organism<T>::randomizeWeights() {
-    for (auto &c : net->connections) {
-        c->setWeight(randWeight());
+    for (auto &w : genome.weight) {
+        w = randWeight();
     }
+    invalidate_net();
 }
 
 
 /* @brief: randomize connection plastic terms */
 template <typename T>
 void Organism<T>::randomize_plastic_terms() {
-    for (auto &c : net->connections) {
+    for (eSpinn_size c = 0; c < genome.conn_size(); ++c) {
         for (eSpinn_size i = 0; i < 2; ++i) {
-            c->set_plastic_term(rand_plastic_term(), i);
+            genome.plastic[i][c] = rand_plastic_term();
         }
     }
+    invalidate_net();
 }
 
 
 /* @brief: duplicate plastic rule */
 template <typename T>
 void Organism<T>::duplicate_plastic_rule(const Organism<T> *org) {
-    net->duplicate_plastic_rule(org->getNet());
+    if (!genome.has_same_topology(org->genome)) {
+        std::cout << "Topology not met when copying plastic rule to net #"
+            << getID() << std::endl;
+        return;
+    }
+
+    std::cout << "Copying plastic rule to net #" << getID() << std::endl;
+    genome.plastic[0] = org->genome.plastic[0];
+    genome.plastic[1] = org->genome.plastic[1];
+    genome.hebb = org->genome.hebb;
+    invalidate_net();
 }
 
 
 /* @brief: evolve network
  * evolve network topology and connection weights (and delay, TODO later)
+ * parameter mutations are queued to mutation if given
  */
 template <typename T>
 void Organism<T>::evolve(neuronID &next_nid, connID &next_cid, 
-    std::vector<Innovation*> &innov, const bool &evolving_plastic_terms)
+    std::vector<Innovation*> &innov, const bool &evolving_plastic_terms,
+    MutationEngine *mutation)
 {
     if (evolving_plastic_terms) {
-        mutate_plastic_terms();
+        if (mutation) {
+            mutation->add_plastic_terms(genome);
+            invalidate_net();
+        }
+        else
+            mutate_plastic_terms();
     }
     else {
         if (rand() < neat::add_ff_node_prob)
@@ -190,6 +241,11 @@ void Organism<T>::evolve(neuronID &next_nid, connID &next_cid,
             addNeuron(next_nid, next_cid, innov);
         else if (rand() < neat::add_conn_prob)
             addConnection(next_cid, innov);
+        else if (mutation) {
+            mutation->add_weights(genome);
+            mutation->add_lambdas(genome);
+            invalidate_net();
+        }
         else {
             mutateWeights();
             mutateLambda();
@@ -204,27 +260,10 @@ void Organism<T>::mutate_plastic_terms() {
     #ifdef ESPINN_VERBOSE
     std::cout << "Mutating connection plastic terms..." << std::endl;
     #endif
-    static std::mt19937 e;
-    static std::normal_distribution<double> n(0, 0.05);
-
-    for (auto &c : net->connections) {
-        for (eSpinn_size i = 0; i < 2; ++i) {
-            if (rand() < neat::mutate_plasticity_prob) {
-                // mutation is either creep mutation (adding a small value) or
-                // uniform mutation (random reset)
-                if (rand() < neat::plasticity_creep_mutate_prob) {
-                    // use normal distribution
-                    double rand_val = n(e);
-                    c->increase_plastic_term(rand_val, i);
-                    c->cap_plastic_terms();
-                }
-                else {
-                    // random reset
-                    c->set_plastic_term(rand_plastic_term(), i);
-                }
-            }
-        }
-    } // end of for connections
+    MutationEngine mutation;
+    mutation.add_plastic_terms(genome);
+    mutation.mutate();
+    invalidate_net();
 }
 
 
@@ -234,34 +273,10 @@ void Organism<T>::mutateWeights() {
     #ifdef ESPINN_VERBOSE
     std::cout << "Mutating network connection weights..." << std::endl;
     #endif
-    static std::mt19937 e;
-    // static std::default_random_engine e;
-    static std::normal_distribution<double> n(0, 0.1);
-
-    for (auto &c : net->connections) {
-        if (rand() < neat::mutate_weight_prob) {
-            // mutation is either creep mutation (adding a small value) or
-            // uniform mutation (random reset)
-            if (rand() < neat::creep_mutate_prob) {
-                // use normal distribution
-                double rand_val = n(e);
-                // avoid infinite loop when rand_val == 0
-                eSpinn_size loop = 0;
-                while((std::abs(rand_val) < neat::mutate_weight_min) && (loop < 5)){
-                    // weight change shall not be too small
-                    rand_val *= rand(2, 5);
-                    ++loop;
-                }
-                c->increaseWeight(rand_val);
-                // cap weight between [-MAX_WEIGHT, MAX_WEIGHT]
-                c->capWeight();
-            }
-            else {
-                // random reset
-                c->setWeight(randWeight());
-            }
-        }
-    }
+    MutationEngine mutation;
+    mutation.add_weights(genome);
+    mutation.mutate();
+    invalidate_net();
 }
 
 
@@ -271,40 +286,10 @@ void Organism<T>::mutateLambda() {
     #ifdef ESPINN_VERBOSE
     std::cout << "Mutating sigmoid neurons lambda..." << std::endl;
     #endif
-    static std::mt19937 e;
-    static std::normal_distribution<double> d(0, 0.2);
-
-    for (auto &n : net->neurons) {
-        if (typeid(*n) != typeid(SigmNeuron)) {
-            continue;
-        }
-        auto sigmn = dynamic_cast<SigmNeuron*>(n);
-        if (rand() < neat::mutate_lambda_prob) {
-            // mutation is either creep mutation (adding a small value) or
-            // uniform mutation (random reset)
-            if (rand() < neat::creep_mutate_prob) {
-                // use normal distribution
-                double rand_val = d(e);
-                // avoid infinite loop when rand_val == 0
-                eSpinn_size loop = 0;
-                while((std::abs(rand_val) < neat::mutate_lambda_min) && (loop < 5)){
-                    // weight change shall not be too small
-                    rand_val *= rand(2, 5);
-                    ++loop;
-                }
-                sigmn->increaseLambda(rand_val);
-                // cap lambda between [0, MAX_LAMBDA]
-                if (sigmn->getLambda() > params::MAX_LAMBDA)
-                    sigmn->setLambda(params::MAX_LAMBDA);
-                else if (sigmn->getLambda() < params::MIN_LAMBDA)
-                    sigmn->setLambda(params::MIN_LAMBDA);
-            }
-            else {
-                // random reset
-                sigmn->setLambda(randLambda());
-            }
-        }
-    }
+    MutationEngine mutation;
+    mutation.add_lambdas(genome);
+    mutation.mutate();
+    invalidate_net();
 }
 
 
@@ -324,47 +309,8 @@ void Organism<T>::crossover(OrganismBase* dadbase) {
         return;
     }
 
-    auto c1 = net->connections.begin();
-    auto c2 = dad->net->connections.begin();
-    // iterate the pointers until either one reaches the end
-    while ((c1 != net->connections.end()) && (c2 != dad->net->connections.end())) {
-        auto c1_id = (*c1)->getID();
-        auto c2_id = (*c2)->getID();
-        if (c1_id == c2_id) {
-            // average weight
-            (*c1)->setWeight( 0.5*( (*c1)->getWeight()+(*c2)->getWeight() ) );
-            // random pick delay, hebb_type
-            if (rand() < 0.5) {
-                (*c1)->setDelay( (*c2)->getDelay() );
-            }
-            if (rand() < 0.5) {
-                (*c1)->set_hebb_type( (*c2)->get_hebb_type() );
-            }
-            // average plastic module
-            (*c1)->set_plastic_term( 
-                0.5*( (*c1)->get_plastic_term(0)+(*c2)->get_plastic_term(0) ), 0);
-            (*c1)->set_plastic_term( 
-                0.5*( (*c1)->get_plastic_term(1)+(*c2)->get_plastic_term(1) ), 1);
-            // no need to cap
-            // (*c1)->cap_plastic_terms();
-
-            // update: enable status is the same as mom
-            // corresponding connection of child is more likely to be disabled
-            // if either parent's connection is disabled
-            // if ( !(*c1)->isEnable() || !(*c2)->isEnable() ) {
-            //     if (rand() < 0.75)
-            //         (*c1)->setEnable(false);
-            // }
-
-            ++c1;
-            ++c2;
-        } else if (c1_id < c2_id) {
-            ++c1;
-        } else {
-            ++c2;
-        }
-    }
-
+    genome.crossover(dad->genome);
+    invalidate_net();
 }
 
 
@@ -374,9 +320,8 @@ void Organism<T>::crossover(OrganismBase* dadbase) {
  * create a neuron & connections
  * then check if this mutation has already existed
  * assign neuron id and connection ids
- * then insert neuron into vector hid_neurons
+ * then insert neuron into the hidden neuron genes
  * the insert position is based on the sequences that hidden neurons are activated
- * finally, assign hidden neurons sequence again
  */
 template <typename T>
 void Organism<T>::addNeuron(neuronID &next_nid, connID &next_cid, 
@@ -387,45 +332,26 @@ void Organism<T>::addNeuron(neuronID &next_nid, connID &next_cid,
     #endif
     // find an existing connection
     // if the connection is disabled, find another
-    std::vector<Connection*>::iterator conn_mut;
+    eSpinn_size conn_mut = 0;
     int count = 0; // avoid infinite loop
     do {
-        conn_mut = net->connections.begin();
-        auto shift = rand(0, net->connections.size()-1); // debug 2
-        std::advance(conn_mut, shift);
+        conn_mut = rand(0, genome.conn_size()-1); // debug 2
         ++count;
-    } while ((count < 20) && !(*conn_mut)->isEnable());
+    } while ((count < 20) && !genome.enable[conn_mut]);
     // if all are disabled, do nothing
-    if (!(*conn_mut)->isEnable())
+    if (!genome.enable[conn_mut])
         return;
-    auto in_node = (*conn_mut)->getInode();
-    auto out_node = (*conn_mut)->getOnode();
-
-    // create a neuron & connections
-    auto new_neuron = net->create_hid_neuron(0);
-    Connection *new_conn1 = nullptr, *new_conn2 = nullptr;
-    if (new_neuron->is_spike_neuron())
-        new_conn1 = new SpikeConnection(0, in_node, new_neuron,
-            (*conn_mut)->getWeight(), (*conn_mut)->getDelay());
-    else
-        new_conn1 = new Connection(0, in_node, new_neuron,
-            (*conn_mut)->getWeight(), (*conn_mut)->getDelay());
-    if (out_node->is_spike_neuron())
-        new_conn2 = new SpikeConnection(0, new_neuron, out_node,
-            (*conn_mut)->getWeight(), (*conn_mut)->getDelay());
-    else
-        new_conn2 = new Connection(0, new_neuron, out_node,
-            (*conn_mut)->getWeight(), (*conn_mut)->getDelay());
-
-    // add connections to neurons
-    new_neuron->add_inConn(new_conn1);
-    new_neuron->add_outConn(new_conn2);
-    in_node->remove_outConn(*conn_mut);
-    in_node->add_outConn(new_conn1);
-    out_node->remove_inConn(*conn_mut);
-    out_node->add_inConn(new_conn2);
+    const auto old_cid = genome.topology().conn_id[conn_mut];
+    const auto in_id = genome.topology().conn_in[conn_mut];
+    const auto out_id = genome.topology().conn_out[conn_mut];
+    const auto w = genome.weight[conn_mut];
+    const auto d = genome.delay[conn_mut];
+    const auto in_pos = genome.find_neuron(in_id);
+    const auto out_pos = genome.find_neuron(out_id);
 
     // check if the innovation (adding a node) has already existed in the vector innov
+    neuronID new_nid = 0;
+    connID new_cid1 = 0, new_cid2 = 0;
     bool found = false;
     for (auto &cur_innov : innov) {
         // the innovation already exists when:
@@ -433,26 +359,25 @@ void Organism<T>::addNeuron(neuronID &next_nid, connID &next_cid,
         // it has the same innode and outnode, and
         // it is applied to split the same connection
         if ((cur_innov->i_type == neat::NEWNODE) &&
-            ((*conn_mut)->getInodeID() == cur_innov->inodeid) &&
-            ((*conn_mut)->getOnodeID() == cur_innov->onodeid) &&
-            ((*conn_mut)->getID() == cur_innov->old_connid)) 
+            (in_id == cur_innov->inodeid) &&
+            (out_id == cur_innov->onodeid) &&
+            (old_cid == cur_innov->old_connid)) 
         {
             // assign the existing ids
-            new_neuron->setID(cur_innov->new_nodeid);
-            new_conn1->setID(cur_innov->new_connid);
-            new_conn2->setID(cur_innov->new_connid2);
+            new_nid = cur_innov->new_nodeid;
+            new_cid1 = cur_innov->new_connid;
+            new_cid2 = cur_innov->new_connid2;
             found = true;
             break;
         }
     }
     if (!found) {
         // assign new ids & record new innovation
-        new_neuron->setID(next_nid);
-        new_conn1->setID(next_cid);
-        new_conn2->setID(next_cid+1);
+        new_nid = next_nid;
+        new_cid1 = next_cid;
+        new_cid2 = next_cid+1;
         innov.emplace_back(
-            new Innovation((*conn_mut)->getInodeID(), (*conn_mut)->getOnodeID(), 
-            (*conn_mut)->getID(), next_nid, next_cid, next_cid+1));
+            new Innovation(in_id, out_id, old_cid, next_nid, next_cid, next_cid+1));
         ++next_nid;
         next_cid += 2;
     }
@@ -461,49 +386,29 @@ void Organism<T>::addNeuron(neuronID &next_nid, connID &next_cid,
     // if inode seq < onode seq
     // inode is activated before onode
     // then insert the new neuron before onode
+    // be careful that onode can be output neurons
     // if not, inode is activated after onode, or they are the same node
-    // then insert the new neuron after inode
-    auto insert_pos = net->hid_neurons.begin();
-    if ((*conn_mut)->getInodeSeq() < (*conn_mut)->getOnodeSeq()) {
-        // if inode seq < onode seq
-        // be careful that onode can be output neurons
-        // also be careful that hid_neurons can be empty
-        while (insert_pos != net->hid_neurons.end() && 
-            *insert_pos != out_node) {
-            ++insert_pos;
-        }
-    }
-    else {
-        // if inode seq >= onode seq
-        // then inode & onode are in hidden layer
-        // no need to check if inode is input neuron
-        // we should be able to find the insert position
-        while (insert_pos != net->hid_neurons.end() &&
-            *insert_pos != in_node) {
-            ++insert_pos;
-        }
-        if (insert_pos != net->hid_neurons.end())
-            // should execute this
-            ++insert_pos;
-    }
-    net->hid_neurons.insert(insert_pos, new_neuron);
-    auto neurons_ins_pos = net->neurons.end();
-    std::advance(neurons_ins_pos, -net->get_outp_size());
-    net->neurons.insert(neurons_ins_pos, new_neuron);
+    // then inode & onode are in hidden layer, insert the new neuron after inode
+    eSpinn_size insert_pos = 0;
+    if (genome.get_seq(in_pos) < genome.get_seq(out_pos))
+        insert_pos = std::min(out_pos,
+            genome.topology().inp_size + genome.topology().hid_size);
+    else
+        insert_pos = in_pos + 1;
+    const typename T::hid_type hid_proto(new_nid, L_HIDDEN);
+    genome.insert_hid_neuron(insert_pos, new_nid,
+        hid_proto.getType(), get_neuron_param(&hid_proto));
 
     // remove old connection and add new connections
-    delete *conn_mut;
-    net->connections.erase(conn_mut);
-    auto conn_ins_pos = net->connections.begin();
-    while (conn_ins_pos != net->connections.end() && 
-        (*conn_ins_pos)->getID() < new_conn1->getID()) {
-        ++conn_ins_pos;
-    }
-    conn_ins_pos = net->connections.insert(conn_ins_pos, new_conn2);
-    net->connections.insert(conn_ins_pos, new_conn1);
-
-    // assign sequence to activate
-    net->assign_hid_seq();
+    // connections linking to spiking neurons are spiking connections
+    const auto out_type = genome.topology().neuron_type[genome.find_neuron(out_id)];
+    genome.erase_conn(conn_mut);
+    genome.insert_conn(new_cid1, in_id, new_nid, w, d,
+        hid_proto.is_spike_neuron() ? SPIKECONN : DEFAULTCONN);
+    genome.insert_conn(new_cid2, new_nid, out_id, w, d,
+        isSPIKING(out_type) ? SPIKECONN : DEFAULTCONN);
+    genome.intern();
+    invalidate_net();
 }
 
 
@@ -545,71 +450,38 @@ void Organism<T>::add_neuron_in2out(
         innov.emplace_back( new Innovation(next_nid, next_cid) );
     }
 
-    auto inode = net->inp_neurons.begin();
-    auto onode = net->outp_neurons.begin();
-    int inode_size = net->get_inp_size();
-    int onode_size = net->get_outp_size();
-
-    // create a neuron
-    auto new_neuron = net->create_hid_neuron(next_nid);
-    net->hid_neurons.push_back(new_neuron);
-    auto neurons_ins_pos = net->neurons.end();
-    std::advance(neurons_ins_pos, -onode_size);
-    net->neurons.insert(neurons_ins_pos, new_neuron);
-
-    auto insert_pos = net->connections.begin();
-    while (insert_pos != net->connections.end() &&
-        (*insert_pos)->getID() < next_cid) {
-        ++insert_pos;
-    }
+    const eSpinn_size inode_size = genome.topology().inp_size;
+    const eSpinn_size onode_size = genome.topology().outp_size;
+
+    // create a neuron after the last hidden neuron
+    const typename T::hid_type hid_proto(next_nid, L_HIDDEN);
+    genome.insert_hid_neuron(inode_size + genome.topology().hid_size, next_nid,
+        hid_proto.getType(), get_neuron_param(&hid_proto));
+
     // add connections
-    if (new_neuron->is_spike_neuron()) {
-        for (auto i = 0; i < inode_size; ++i) {
-            auto new_conn = new SpikeConnection(
-                next_cid+i, *(inode+i), new_neuron, .0, randDelay() );
-            // get returned iterator because the original will become invalid
-            // when the vector is reallocated
-            insert_pos = net->connections.insert(insert_pos, new_conn);
-            ++insert_pos;
-            new_neuron->add_inConn(new_conn);
-            (*(inode+i))->add_outConn(new_conn);
-        }
-    }
-    else {
-        for (auto i = 0; i < inode_size; ++i) {
-            auto new_conn = new Connection(
-                next_cid+i, *(inode+i), new_neuron, .0, randDelay() );
-            insert_pos = net->connections.insert(insert_pos, new_conn);
-            ++insert_pos;
-            new_neuron->add_inConn(new_conn);
-            (*(inode+i))->add_outConn(new_conn);
-        }
+    const connType in_conn_type = 
+        hid_proto.is_spike_neuron() ? SPIKECONN : DEFAULTCONN;
+    // copy the ids, the topology is being edited
+    for (eSpinn_size i = 0; i < inode_size; ++i) {
+        const neuronID in_id = genome.topology().neuron_id[i];
+        genome.insert_conn(next_cid+i, in_id, next_nid,
+            .0, randDelay(), in_conn_type);
     }
-
     next_cid += inode_size;
-    if ((*onode)->is_spike_neuron()) {
-        for (auto i = 0; i < onode_size; ++i) {
-            auto new_conn = new SpikeConnection(
-                next_cid+i, new_neuron, *(onode+i), .0, randDelay() );
-            insert_pos = net->connections.insert(insert_pos, new_conn);
-            ++insert_pos;
-            new_neuron->add_outConn(new_conn);
-            (*(onode+i))->add_inConn(new_conn);
-        }
-    }
-    else {
-        for (auto i = 0; i < onode_size; ++i) {
-            auto new_conn = new Connection(
-                next_cid+i, new_neuron, *(onode+i), .0, randDelay() );
-            insert_pos = net->connections.insert(insert_pos, new_conn);
-            ++insert_pos;
-            new_neuron->add_outConn(new_conn);
-            (*(onode+i))->add_inConn(new_conn);
-        }
+
+    const eSpinn_size onode_pos = genome.neuron_size() - onode_size;
+    const connType out_conn_type = 
+        isSPIKING(genome.topology().neuron_type[onode_pos]) ? SPIKECONN : DEFAULTCONN;
+    for (eSpinn_size i = 0; i < onode_size; ++i) {
+        const neuronID out_id = genome.topology().neuron_id[onode_pos+i];
+        genome.insert_conn(next_cid+i, next_nid, out_id,
+            .0, randDelay(), out_conn_type);
     }
     next_cid += onode_size;
     if (next_cid > next_cid_global)
         next_cid_global = next_cid;
+    genome.intern();
+    invalidate_net();
 }
 
 
@@ -618,11 +490,7 @@ template <typename T>
 const bool Organism<T>::connection_exists(
     const neuronID &iid, const neuronID &oid) const 
 {
-    for (const auto &c : net->connections) {
-        if (c->getInodeID() == iid && c->getOnodeID() == oid)
-            return true;
-    }
-    return false;
+    return genome.connection_exists(iid, oid);
 }
 
 
@@ -637,12 +505,11 @@ void Organism<T>::addConnection(connID &next_cid, std::vector<Innovation*> &inno
     #ifdef ESPINN_VERBOSE
     std::cout << "Adding a connection..." << std::endl;
     #endif
-    std::vector<Neuron*>::iterator inode, onode;
     eSpinn_size tries = 20; // avoid infinite search
 
-    int inode_size = net->get_inp_size();
-    int hnode_size = net->get_hid_size();
-    int node_size = net->get_neuron_size();
+    int inode_size = genome.topology().inp_size;
+    int hnode_size = genome.topology().hid_size;
+    int node_size = genome.neuron_size();
     int ishift(0), oshift(0);
     bool found(false);
 
@@ -655,8 +522,6 @@ void Organism<T>::addConnection(connID &next_cid, std::vector<Innovation*> &inno
         return;
 
     for (auto t = 0; t < tries; ++t) {
-        inode = net->neurons.begin();
-        onode = net->neurons.begin();
         // inode cannot be from output layer
         ishift = rand(0, inode_size + hnode_size - 1);
         // if inode is in input layer
@@ -668,9 +533,9 @@ void Organism<T>::addConnection(connID &next_cid, std::vector<Innovation*> &inno
             oshift = rand(inode_size, node_size - 1);
         }
 
-        std::advance(inode, ishift);
-        std::advance(onode, oshift);
-        if (!connection_exists((*inode)->getID(), (*onode)->getID())) {
+        if (!connection_exists(genome.topology().neuron_id[ishift],
+            genome.topology().neuron_id[oshift]))
+        {
             found = true;
             break;
         }
@@ -680,49 +545,38 @@ void Organism<T>::addConnection(connID &next_cid, std::vector<Innovation*> &inno
         return;
 
     // if found, create a connection
-    Connection *new_conn(nullptr);
-    if ((*onode)->is_spike_neuron())
-        new_conn = new SpikeConnection(next_cid, *inode, *onode,
-            .0, randDelay());
-    else
-        new_conn = new Connection(next_cid, *inode, *onode,
-            .0, randDelay());
-    (*inode)->add_outConn(new_conn);
-    (*onode)->add_inConn(new_conn);
-
+    const auto in_id = genome.topology().neuron_id[ishift];
+    const auto out_id = genome.topology().neuron_id[oshift];
+    const connType ct = isSPIKING(genome.topology().neuron_type[oshift]) ? 
+        SPIKECONN : DEFAULTCONN;
 
     // check if the innovation (adding a conn) has already existed 
+    connID new_cid = next_cid;
     found = false;
     for (const auto &cur_innov : innov) {
         // the innovation already exists when:
         // it is a new connection case,
         // it has the same innode and outnode
         if ((cur_innov->i_type == neat::NEWCONN) &&
-            ((*inode)->getID() == cur_innov->inodeid) &&
-            ((*onode)->getID() == cur_innov->onodeid)) 
+            (in_id == cur_innov->inodeid) &&
+            (out_id == cur_innov->onodeid)) 
         {
             // assign the existing id
-            new_conn->setID(cur_innov->new_connid);
+            new_cid = cur_innov->new_connid;
             found = true;
             break;
         }
     }
     if (!found) {
-        // assign new id & record new innovation
-        new_conn->setID(next_cid); // can skip this
+        // record new innovation
         innov.emplace_back(
-            new Innovation((*inode)->getID(), (*onode)->getID(), 
-            next_cid, new_conn->getWeight(), new_conn->getType()));
+            new Innovation(in_id, out_id, next_cid, .0, ct));
         ++next_cid;
     }
 
-    // find the position to insert new_conn
-    auto insert_pos = net->connections.begin();
-    while (insert_pos != net->connections.end() && 
-        (*insert_pos)->getID() < new_conn->getID()) {
-        ++insert_pos;
-    }
-    net->connections.insert(insert_pos, new_conn);
+    genome.insert_conn(new_cid, in_id, out_id, .0, randDelay(), ct);
+    genome.intern();
+    invalidate_net();
 }
 
 
@@ -768,12 +622,25 @@ void Organism<T>::archive(const std::string &ofile) {
 }
 
 
-/* @brief: construct organism from file */
+/* @brief: construct organism from file
+ * the format (text or binary) is detected from the file
+ */
 template <typename T>
 void Organism<T>::load(const std::string &ifile) {
     #ifndef NDEBUG
     std::cout << "Loading organism from file " << ifile << std::endl;
     #endif
+    if (is_binary_archive(ifile)) {
+        BinaryReader r(ifile);
+        std::string key;
+        r.read(key);
+        if (r.getContent() != binarch::ORGANISM || key != type_key())
+            std::cerr << BnR_ERROR << ifile << " is not an archive of "
+                << type_key() << std::endl;
+        else if (!load(r))
+            std::cerr << BnR_ERROR << "Corrupted archive " << ifile << std::endl;
+        return;
+    }
     std::ifstream ifs(ifile);
     if (!ifs) {
         std::cerr << BnR_ERROR << "Can't open file " << ifile << std::endl;
@@ -785,6 +652,59 @@ void Organism<T>::load(const std::string &ifile) {
 }
 
 
+/* @brief: get the key of the organism type
+ * the same as its boost export key
+ */
+template <typename T>
+const char* Organism<T>::type_key() const {
+    return boost::serialization::guid<Organism<T>>();
+}
+
+
+/* @brief: read organism from a binary archive
+ * the phenotype will be rebuilt from the genome
+ * return false if the archive is corrupted
+ */
+template <typename T>
+bool Organism<T>::load(BinaryReader &r) {
+    release_net();
+    return OrganismBase::load(r);
+}
+
+
+/* @brief: archive organism to file in binary format */
+template <typename T>
+void Organism<T>::archive_binary(const std::string &ofile) {
+    #ifndef NDEBUG
+    std::cout << "Archiving organism to file " << ofile << std::endl;
+    #endif
+    BinaryWriter w(binarch::ORGANISM);
+    w.write(std::string(type_key()));
+    archive(w);
+    w.save(ofile);
+}
+
+
+/* @brief: create an organism of the type T if key matches */
+template <typename T>
+static OrganismBase* create_if(const std::string &key) {
+    return key == boost::serialization::guid<Organism<T>>() ? new Organism<T>() : nullptr;
+}
+
+
+/* @brief: create an organism of the type key
+ * used when loading binary archives
+ * return nullptr if the key is unknown
+ */
+OrganismBase* eSpinn::create_organism(const std::string &key) {
+    OrganismBase *o = nullptr;
+    (o = create_if<SigmNetwork>(key)) || (o = create_if<LinrNetwork>(key))
+        || (o = create_if<IzhiNetwork>(key)) || (o = create_if<LifNetwork>(key))
+        || (o = create_if<HybridNetwork>(key)) || (o = create_if<HybLinNetwork>(key));
+    return o;
+}
+
+
 /* @brief: explicit instantiation */
 template class eSpinn::Organism<SigmNetwork>;
 template class eSpinn::Organism<LinrNetwork>;
@@ -14,9 +14,12 @@
 #include <typeinfo>
 
 #include <boost/serialization/base_object.hpp>
+#include <boost/serialization/split_member.hpp>
 
 /* @brief: Organism 
  * wrap up networks for evolutionary algorithms
+ * the genome is evolved, the network (phenotype) is built from it
+ * only when it is needed, i.e. evaluated, printed or archived
  * initialization list: net, which gen
  */
 namespace eSpinn {
@@ -28,6 +31,25 @@ namespace eSpinn {
          */
         friend class boost::serialization::access;
 
+        /* @brief: archive the phenotype so that text archives stay compatible
+         * build the phenotype first if it does not exist
+         */
+        template <typename Archive>
+        void save(Archive &ar, const unsigned int version) const {
+            T *n = getNet();
+            ar << n;
+            ar << boost::serialization::base_object<OrganismBase>(*this);
+        }
+
+        /* @brief: load the phenotype and encode it into the genome */
+        template <typename Archive>
+        void load(Archive &ar, const unsigned int version) {
+            release_net();
+            ar >> net;
+            ar >> boost::serialization::base_object<OrganismBase>(*this);
+            net->encode(genome);
+        }
+
 	    /* @brief: template member serialize function
          * called when using i/oarchive to load/write class members via serialization
          * make serialize() private to avoid being called directly 
@@ -35,31 +57,50 @@ namespace eSpinn {
          */
         template <typename Archive>
         void serialize(Archive &ar, const unsigned int version) {
-            ar & net;
-            ar & boost::serialization::base_object<OrganismBase>(*this);
+            boost::serialization::split_member(ar, *this, version);
         }
 
     private:
         /* data */
-        T *net;
+        mutable T *net; // phenotype, built on demand
+        mutable bool stale; // true if net no longer matches genome
+        // topology net is built from, net only needs new parameters
+        // if the genome still shares it
+        mutable std::shared_ptr<const Topology> net_topo;
 
         /* @brief: print class info 
          * do the actual printing here
          */
         std::ostream& print(std::ostream &os) const override;
+
+        /* @brief: constructor
+         * constructed from a genome, the phenotype is not built
+         */
+        Organism(const Genome &g, const netID &oid, const eSpinn_size &gen) :
+            OrganismBase(oid, gen), net(nullptr), stale(false), net_topo()
+        {
+            genome = g;
+        }
     public:
+        typedef T net_type;
+
         /* @brief: constructor
          * constructed from pointer to net
          * org manages the lifecycle of net
          */
         Organism(T *const t, const eSpinn_size &g) : 
-            OrganismBase(t->getID(), g), net(t) 
+            OrganismBase(t->getID(), g), net(t), stale(false), net_topo()
         {
             #ifdef ESPINN_VERBOSE
             std::cout << "Created organism #" << getID() << std::endl;
             #endif
+            net->encode(genome);
+        }
+        Organism(T *const t) :
+            OrganismBase(t->getID(), 0), net(t), stale(false), net_topo()
+        {
+            net->encode(genome);
         }
-        Organism(T *const t) : OrganismBase(t->getID(), 0), net(t) { }
 
         /* @brief: constructor
          *  constructed with network specifications
@@ -73,18 +114,22 @@ namespace eSpinn {
         Organism(const netID &nid, const eSpinn_size &in_num,
             const eSpinn_size &hid_num, const eSpinn_size &out_num,
             const eSpinn_size &g = 0)
-            : OrganismBase(nid, g), net(new T(nid, in_num, hid_num, out_num))
-        { }
+            : OrganismBase(nid, g), net(new T(nid, in_num, hid_num, out_num)),
+            stale(false), net_topo()
+        {
+            net->encode(genome);
+        }
 
         /* @brief: default constructor for using boost serialization */
-        Organism() : OrganismBase(0, 0), net() { }
+        Organism() : OrganismBase(0, 0), net(), stale(false), net_topo() { }
         
         /* @brief: copy constructor
-         * copy the object net points to, not the pointer itself
+         * copy the genome, the phenotype will be built when needed
          */
         Organism(const Organism &org) : 
-            OrganismBase(org.org_id, org.gen), net(new T(*org.net)) 
+            OrganismBase(org.org_id, org.gen), net(nullptr), stale(false), net_topo()
         {
+            genome = org.genome;
             #ifndef NDEBUG
             std::cout << "Organism #" << getID() << " copied!" << std::endl;
             #endif
@@ -93,8 +138,7 @@ namespace eSpinn {
             #ifdef ESPINN_VERBOSE
             std::cout << "Deleting organism" << std::endl;
             #endif
-            delete net;
-            net = nullptr;
+            release_net();
         }
 
         /* @brief: set organism id
@@ -104,11 +148,27 @@ namespace eSpinn {
 
         /* @brief: duplicate this organism
          * with a new id and which generation
+         * only the genome is copied
          * method use new operator, should delete the returned object
          * maually or in wrapped up classes
          */
         Organism* duplicate(const netID &n, const eSpinn_size &g) override;
 
+        /* @brief: turn this organism into a duplicate of src
+         * with a new id and which generation
+         * genome storage is reused and the phenotype is kept
+         * to be refreshed from the new genome when needed
+         * return false if src is not of the same type
+         */
+        bool recycle(const OrganismBase *src,
+            const netID &n, const eSpinn_size &g) override;
+
+        /* @brief: replace neuron & connection ids of the genome
+         * ids not found in the maps are kept
+         */
+        void remap_ids(const std::unordered_map<neuronID, neuronID> &nmap,
+            const std::unordered_map<connID, connID> &cmap) override;
+
         /* @brief: get the next available neuron id
          */
         const neuronID get_next_neuron_id() const override;
@@ -117,8 +177,29 @@ namespace eSpinn {
          */
         const connID get_next_conn_id() const override;
 
-        /* @brief: return pointer to net */
-        T *const getNet() const { return net; }
+        /* @brief: return pointer to net
+         * the phenotype is built from the genome if it does not exist
+         * a stale phenotype is refreshed in place if the topology is unchanged
+         * if the returned net is edited (other than its runtime states),
+         * call sync_genome() to write the changes back to the genome
+         */
+        T *const getNet() const;
+
+        /* @brief: release the phenotype
+         * it will be rebuilt from the genome when needed
+         */
+        void release_net() const;
+
+        /* @brief: mark the phenotype as out of date
+         * called after the genome is mutated
+         */
+        inline void invalidate_net() const { stale = true; }
+
+        /* @brief: re-encode the genome from the phenotype */
+        void sync_genome();
+
+        /* @brief: set Hebbian type of all connections */
+        void set_connection_hebb_type(const HebbianType &h);
 
         /* @brief: calculate the compatibility distance
          */
@@ -135,10 +216,12 @@ namespace eSpinn {
 
         /* @brief: evolve network
          * evolve network topology and connection weights (and delay, TODO later)
+         * parameter mutations are queued to mutation if given
          */
         void evolve(neuronID &next_nid, connID &next_cid, 
             std::vector<Innovation*> &innov, 
-            const bool &evolving_plastic_terms) override;
+            const bool &evolving_plastic_terms,
+            MutationEngine *mutation = nullptr) override;
 
         /* @brief: mutate connection plastic terms */
         void mutate_plastic_terms();
@@ -164,9 +247,8 @@ namespace eSpinn {
          * create a neuron & connections
          * then check if this mutation has already existed
          * assign neuron id and connection ids
-         * then insert neuron into vector hid_neurons
+         * then insert neuron into the hidden neuron genes
          * the insert position is based on the sequences that hidden neurons are activated
-         * finally, assign hidden neurons sequence again    
          */
         void addNeuron(neuronID &next_nid, connID &next_cid, 
             std::vector<Innovation*> &innov);
@@ -195,11 +277,34 @@ namespace eSpinn {
 
         /* @brief: archive organism to file */
         void archive(const std::string &ofile) override;
+        using OrganismBase::archive;
 
-        /* @brief: construct organism from file */
+        /* @brief: construct organism from file
+         * the format (text or binary) is detected from the file
+         */
         void load(const std::string &ifile) override;
+
+        /* @brief: get the key of the organism type
+         * the same as its boost export key
+         */
+        const char* type_key() const override;
+
+        /* @brief: read organism from a binary archive
+         * the phenotype will be rebuilt from the genome
+         * return false if the archive is corrupted
+         */
+        bool load(BinaryReader &r) override;
+
+        /* @brief: archive organism to file in binary format */
+        void archive_binary(const std::string &ofile) override;
     };
 
+    /* @brief: create an organism of the type key
+     * used when loading binary archives
+     * return nullptr if the key is unknown
+     */
+    OrganismBase* create_organism(const std::string &key);
+
     // template<typename T>
     // bool greater_fit(const Organism<T> *o1, const Organism<T> *o2) {
     //     return *o1 > *o2;
@@ -17,6 +17,19 @@ std::ostream& OrganismBase::print(std::ostream &os) const {
 }
 
 
+/* @brief: reset organism states as if it is newly created
+ * used when recycling organisms
+ */
+void OrganismBase::reset_states(const netID &oid, const eSpinn_size &g) {
+    org_id = oid;
+    gen = g;
+    fitness = orig_fit = .0;
+    winner = eliminate = false;
+    expected_offspring = .0;
+    species = nullptr;
+}
+
+
 /* @brief: get organism id */
 const netID OrganismBase::getID() const {
     return org_id;
@@ -99,3 +112,48 @@ Species *const OrganismBase::getSpecies() const { return species; }
 
 /* @brief: set organism species */
 void OrganismBase::setSpecies(Species *s) { species = s; }
+
+
+/* @brief: replace neuron & connection ids of the genome
+ * ids not found in the maps are kept
+ */
+void OrganismBase::remap_ids(const std::unordered_map<neuronID, neuronID> &nmap,
+    const std::unordered_map<connID, connID> &cmap)
+{
+    genome.remap_ids(nmap, cmap);
+}
+
+
+/* @brief: get organism genome */
+const Genome& OrganismBase::get_genome() const { return genome; }
+
+
+/* @brief: write organism to a binary archive
+ * as a record of its states and genome
+ */
+void OrganismBase::archive(BinaryWriter &w) const {
+    const auto rec = w.begin_record();
+    w.write(org_id);
+    w.write(gen);
+    w.write(fitness);
+    w.write(orig_fit);
+    w.write(winner);
+    genome.archive(w);
+    w.end_record(rec);
+}
+
+
+/* @brief: read organism from a binary archive
+ * return false if the archive is corrupted
+ */
+bool OrganismBase::load(BinaryReader &r) {
+    const auto end = r.begin_record();
+    r.read(org_id);
+    r.read(gen);
+    r.read(fitness);
+    r.read(orig_fit);
+    r.read(winner);
+    const bool genome_ok = genome.load(r);
+    r.end_record(end);
+    return genome_ok && r.ok();
+}
@@ -8,6 +8,8 @@
 
 #include "eSpinn_def.h"
 #include "neat_def.h"
+#include "Genome.h"
+#include "MutationEngine.h"
 #include "Utilities/Utilities.h"
 #include <iostream>
 
@@ -24,6 +26,7 @@ namespace eSpinn {
     class OrganismBase
     {
         friend class Species;
+        friend class CheckpointStore;
         /* @brief: declare serialization library as friend
          * used to grant to the serialization library access to class members
          */
@@ -58,16 +61,23 @@ namespace eSpinn {
         bool winner, eliminate;
         double expected_offspring;
         Species *species;
+        Genome genome; // the unit of evolution
 
         /* @brief: print class info 
          * do the actual printing here
          */
         virtual std::ostream& print(std::ostream &os) const;
+
+        /* @brief: reset organism states as if it is newly created
+         * used when recycling organisms
+         */
+        void reset_states(const netID &oid, const eSpinn_size &g);
     public:
         /* @brief: constructor */
         OrganismBase(const netID &oid, const eSpinn_size &g) : 
             org_id(oid), gen(g), fitness(.0), orig_fit(.0),
-            winner(false), eliminate(false), expected_offspring(.0), species(nullptr) { }
+            winner(false), eliminate(false), expected_offspring(.0), species(nullptr),
+            genome() { }
         virtual ~OrganismBase() = default;
 
         /* @brief: get organism id */
@@ -80,6 +90,15 @@ namespace eSpinn {
          */
         virtual OrganismBase* duplicate(const netID &n, const eSpinn_size &g) = 0;
 
+        /* @brief: turn this organism into a duplicate of src
+         * with a new id and which generation
+         * storage of this organism is reused
+         * return false if src is not of the same type
+         */
+        virtual bool recycle(const OrganismBase *src,
+            const netID &n, const eSpinn_size &g)
+        { return false; }
+
         /* @brief: get which generation organism belong to */
         const eSpinn_size getGen() const;
         /* @brief: set which generation organism belong to */
@@ -122,6 +141,15 @@ namespace eSpinn {
         /* @brief: set organism species */
         void setSpecies(Species *s);
 
+        /* @brief: get organism genome */
+        const Genome& get_genome() const;
+
+        /* @brief: replace neuron & connection ids of the genome
+         * ids not found in the maps are kept
+         */
+        virtual void remap_ids(const std::unordered_map<neuronID, neuronID> &nmap,
+            const std::unordered_map<connID, connID> &cmap);
+
         /* @brief: get the next available neuron id
          */
         virtual const neuronID get_next_neuron_id() const = 0;
@@ -151,10 +179,13 @@ namespace eSpinn {
 
         /* @brief: evolve network
          * evolve network topology and connection weights (and delay, TODO later)
+         * parameter mutations are queued to mutation if given,
+         * and happen when mutation->mutate() is called
          */
         virtual void evolve(neuronID &next_nid, connID &next_cid, 
             std::vector<Innovation*> &innov, 
-            const bool &evolving_plastic_terms)
+            const bool &evolving_plastic_terms,
+            MutationEngine *mutation = nullptr)
         { }
 
         /* @brief: save network topology to file */
@@ -166,6 +197,24 @@ namespace eSpinn {
         /* @brief: construct organism from file */
         virtual void load(const std::string &ifile) { }
 
+        /* @brief: get the key of the organism type
+         * used to create organisms when loading binary archives
+         */
+        virtual const char* type_key() const = 0;
+
+        /* @brief: write organism to a binary archive
+         * as a record of its states and genome
+         */
+        void archive(BinaryWriter &w) const;
+
+        /* @brief: read organism from a binary archive
+         * return false if the archive is corrupted
+         */
+        virtual bool load(BinaryReader &r);
+
+        /* @brief: archive organism to file in binary format */
+        virtual void archive_binary(const std::string &ofile) { }
+
         /* relational operators */
         bool operator==(const OrganismBase &o) const {
             return fitness == o.fitness;
@@ -0,0 +1,83 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "OrganismPool.h"
+using namespace eSpinn;
+
+
+/* @brief: reset all counters */
+void AllocStats::reset() {
+    orgs_new = 0;
+    orgs_recycled = 0;
+    nets_built = 0;
+    nets_reused = 0;
+    neurons_new = 0;
+    conns_new = 0;
+}
+
+
+/* @brief: overloaded <<
+ * print a one-line report
+ */
+std::ostream& eSpinn::operator<<(std::ostream &os, const AllocStats &s) {
+    os << "Allocations: " << s.orgs_new << " new / " << s.orgs_recycled
+        << " recycled organisms, " << s.nets_built << " built / "
+        << s.nets_reused << " reused networks (" << s.neurons_new
+        << " neurons, " << s.conns_new << " connections allocated)";
+    return os;
+}
+
+
+/* @brief: get the global allocation counters */
+AllocStats& eSpinn::alloc_stats() {
+    static AllocStats stats;
+    return stats;
+}
+
+
+/* @brief: get a copy of src with a new id and which generation
+ * reuse a pooled organism if possible, otherwise duplicate src
+ */
+OrganismBase* OrganismPool::acquire(OrganismBase *const src,
+    const netID &n, const eSpinn_size &g)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!free_orgs.empty()) {
+        // prefer an organism of the same topology so that its network
+        // can be refreshed in place rather than rebuilt
+        auto it = free_orgs.end() - 1;
+        for (auto cur = free_orgs.rbegin(); cur != free_orgs.rend(); ++cur) {
+            if ((*cur)->get_genome().has_same_topology(src->get_genome())) {
+                it = cur.base() - 1;
+                break;
+            }
+        }
+        auto o = *it;
+        if (o->recycle(src, n, g)) {
+            *it = free_orgs.back();
+            free_orgs.pop_back();
+            ++alloc_stats().orgs_recycled;
+            return o;
+        }
+    }
+    ++alloc_stats().orgs_new;
+    return src->duplicate(n, g);
+}
+
+
+/* @brief: give an organism back to the pool */
+void OrganismPool::release(OrganismBase *const o) {
+    std::lock_guard<std::mutex> lock(mtx);
+    free_orgs.push_back(o);
+}
+
+
+/* @brief: delete all pooled organisms */
+void OrganismPool::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto &o : free_orgs)
+        delete o;
+    free_orgs.clear();
+}
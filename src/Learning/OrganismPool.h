@@ -0,0 +1,78 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "OrganismBase.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+/* @brief: AllocStats
+ * counters of organism & network allocations
+ * used to report how much memory churn each generation makes
+ */
+namespace eSpinn {
+    struct AllocStats
+    {
+        std::atomic<unsigned long> orgs_new, orgs_recycled;
+        std::atomic<unsigned long> nets_built, nets_reused;
+        std::atomic<unsigned long> neurons_new, conns_new;
+
+        AllocStats() { reset(); }
+
+        /* @brief: reset all counters */
+        void reset();
+    };
+
+    /* @brief: overloaded <<
+     * print a one-line report
+     */
+    std::ostream& operator<<(std::ostream &os, const AllocStats &s);
+
+    /* @brief: get the global allocation counters */
+    AllocStats& alloc_stats();
+
+
+    /* @brief: OrganismPool
+     * free list of organisms that are no longer used
+     * offspring reuse them (and the storage of their genomes & networks)
+     * instead of allocating new ones every generation
+     * the pool owns the released organisms
+     * acquire() & release() are thread-safe
+     */
+    class OrganismPool
+    {
+    private:
+        /* data */
+        std::vector<OrganismBase*> free_orgs;
+        std::mutex mtx;
+    public:
+        /* @brief: constructor */
+        OrganismPool() : free_orgs(), mtx() { }
+        OrganismPool(const OrganismPool&) = delete;
+        OrganismPool& operator=(const OrganismPool&) = delete;
+        /* @brief: destructor - delete all pooled organisms */
+        ~OrganismPool() { clear(); }
+
+        /* @brief: get the num of pooled organisms */
+        inline const eSpinn_size size() const { return free_orgs.size(); }
+
+        /* @brief: get a copy of src with a new id and which generation
+         * reuse a pooled organism if possible, otherwise duplicate src
+         */
+        OrganismBase* acquire(OrganismBase *const src,
+            const netID &n, const eSpinn_size &g);
+
+        /* @brief: give an organism back to the pool */
+        void release(OrganismBase *const o);
+
+        /* @brief: delete all pooled organisms */
+        void clear();
+    };
+}
@@ -4,6 +4,10 @@
 
 
 #include "Population.h"
+#include "CheckpointStore.h"
+#include <atomic>
+#include <thread>
+#include <unordered_map>
 using namespace eSpinn;
 
 
@@ -29,10 +33,11 @@ Population::Population(OrganismBase *const o, const eSpinn_size &num,
     gen(g), 
     next_neuron_id(0), next_conn_id(0), next_species_id(0),
     champ_fit(.0), champ_fit_ever(.0), stagnant_gens(0), solved(false),
-    evolving_plastic_term(0),
+    seed(draw_seed()), num_threads(1), evolving_plastic_term(0),
     orgs(std::vector<OrganismBase *>()), species(std::vector<Species *>()),
     innovation(std::vector<Innovation *>())
 {
+    set_threads(0);
     for (eSpinn_size i = 0; i < num; ++i) {
         auto org = o->duplicate(i, g);
         if (randomize) {
@@ -50,15 +55,38 @@ Population::Population(const eSpinn_size &g) :
     gen(g), 
     next_neuron_id(0), next_conn_id(0), next_species_id(0),
     champ_fit(.0), champ_fit_ever(.0), stagnant_gens(0), solved(false), 
-    evolving_plastic_term(0),
+    seed(draw_seed()), num_threads(1), evolving_plastic_term(0),
     orgs(), species(), innovation()
-{ }
+{
+    set_threads(0);
+}
 
 
 /* @brief: default constructor */
 Population::Population() : Population(0) { }
 
 
+/* @brief: set the seed of reproduction random streams
+ * the stream of each species is seeded by seed, generation & species id
+ * so offspring do not depend on the num of threads
+ * it's drawn from the random engine by default,
+ * so it's reproducible once the engine is seeded with seed_rand()
+ */
+void Population::set_seed(const std::uint64_t &s) {
+    seed = s;
+}
+
+
+/* @brief: set the num of threads used in reproduction
+ * 0 means using all hardware threads
+ */
+void Population::set_threads(const eSpinn_size &n) {
+    num_threads = n ? n : std::thread::hardware_concurrency();
+    if (!num_threads)
+        num_threads = 1;
+}
+
+
 /* @brief: check if this population will solve the problem */
 bool Population::issolved() const { return solved; }
 
@@ -279,32 +307,19 @@ bool Population::epoch(const eSpinn_size &generation) {
     for (auto cur_org = orgs.begin(); cur_org != orgs.end(); ) {
         if ((*cur_org)->isDying()) {
             (*cur_org)->getSpecies()->remove_org(*cur_org); // remove from species
-            delete *cur_org; // free memory
+            pool.release(*cur_org); // recycled by offspring
             cur_org = orgs.erase(cur_org); // remove from population
         } else
             ++cur_org;
     }
     
     // reproduce
-    for (curspecies = species.begin(); curspecies != species.end(); ++curspecies) {
-        if (!(*curspecies)->novel) {
-            auto curspecies_id = (*curspecies)->getID();
-            (*curspecies)->reproduce(generation, this, sorted_species);
-            // reset the iterator to the last species
-            // if there is new species added, the previous pointer becomes invalid
-            for (auto lastspecies = species.begin(); lastspecies != species.end(); ++lastspecies) {
-                if ((*lastspecies)->getID() == curspecies_id) {
-                    curspecies = lastspecies;
-                    break;
-                }
-            }
-        }
-    }
+    reproduce(generation, sorted_species);
     
-    // delete old organisms
+    // release old organisms to the pool, recycled by the next generation
     for (auto cur_org = orgs.begin(); cur_org != orgs.end(); ++cur_org) {
         (*cur_org)->getSpecies()->remove_org(*cur_org); // remove from species
-        delete *cur_org; // free memory
+        pool.release(*cur_org);
     }
     orgs.clear();
     
@@ -348,12 +363,252 @@ bool Population::epoch(const eSpinn_size &generation) {
     for (const auto &s : species)
         std::cout << *s << std::endl;
     #endif
+    // report allocations of the evaluated generation & its reproduction
+    std::cout << alloc_stats() << std::endl;
+    alloc_stats().reset();
     std::cout << std::endl;
 
     return true;
 }
 
 
+/* @brief: reproduce offspring of all species
+ * species create offspring in parallel, each with its own random stream
+ * offspring are then merged in order of species
+ */
+void Population::reproduce(const eSpinn_size &generation,
+    const std::vector<Species*> &sorted_species)
+{
+    // only species of the last generation reproduce
+    std::vector<Species*> parents;
+    for (auto &s : species) {
+        if (!s->novel)
+            parents.push_back(s);
+    }
+    std::vector<Offspring> offspring(parents.size());
+
+    // create offspring
+    // the random stream of each species is seeded by (seed, generation, species id)
+    // new innovations get temporary ids, so that species don't depend on each other
+    std::atomic<eSpinn_size> next(0);
+    auto create = [&]() {
+        for (eSpinn_size i = next++; i < parents.size(); i = next++) {
+            auto &off = offspring[i];
+            off.innov = innovation;
+            off.num_shared = innovation.size();
+            const std::uint64_t key[3] = {seed, generation, parents[i]->getID()};
+            const auto engine = rand_engine(); // keep the stream of this thread
+            seed_rand(fnv1a(key, sizeof(key)));
+            parents[i]->reproduce(generation, this, sorted_species, off);
+            rand_engine() = engine;
+        }
+    };
+    std::vector<std::thread> workers;
+    for (eSpinn_size t = 1; t < std::min<eSpinn_size>(num_threads, parents.size()); ++t)
+        workers.emplace_back(create);
+    create();
+    for (auto &w : workers)
+        w.join();
+
+    // merge offspring in order of species
+    for (auto &off : offspring)
+        merge_offspring(off);
+}
+
+
+/* @brief: merge offspring created by a species
+ * assign ids to the new innovations and speciate the children
+ */
+void Population::merge_offspring(Offspring &off) {
+    // map temporary ids to population ids
+    // an innovation may have been created by the species merged earlier
+    std::unordered_map<neuronID, neuronID> nmap;
+    std::unordered_map<connID, connID> cmap;
+    const auto num_innov = innovation.size();
+    for (eSpinn_size i = off.num_shared; i < off.innov.size(); ++i) {
+        auto inno = off.innov[i];
+        Innovation *found = nullptr;
+        for (eSpinn_size k = off.num_shared; k < num_innov; ++k) {
+            if (innovation[k]->matches(*inno)) {
+                found = innovation[k];
+                break;
+            }
+        }
+        switch (inno->i_type) {
+            case neat::NEWNODE:
+                nmap[inno->new_nodeid] = found ? found->new_nodeid : next_neuron_id++;
+                cmap[inno->new_connid] = found ? found->new_connid : next_conn_id++;
+                cmap[inno->new_connid2] = found ? found->new_connid2 : next_conn_id++;
+                break;
+            case neat::NEWCONN:
+                cmap[inno->new_connid] = found ? found->new_connid : next_conn_id++;
+                break;
+            default: { // NEWNODE_IN2OUT, connections are allocated as a block
+                const auto &g = off.children.front()->get_genome();
+                const eSpinn_size block = g.topology().inp_size + g.topology().outp_size;
+                const connID cid = found ? found->new_connid : next_conn_id;
+                for (eSpinn_size c = 0; c < block; ++c)
+                    cmap[inno->new_connid + c] = cid + c;
+                if (!found)
+                    next_conn_id += block;
+                break;
+            }
+        }
+        if (found) {
+            delete inno;
+        } else {
+            inno->new_nodeid = nmap.count(inno->new_nodeid) ? 
+                nmap[inno->new_nodeid] : inno->new_nodeid;
+            inno->new_connid = cmap[inno->new_connid];
+            if (inno->i_type == neat::NEWNODE)
+                inno->new_connid2 = cmap[inno->new_connid2];
+            innovation.push_back(inno);
+        }
+    }
+    off.innov.clear();
+
+    for (auto &child : off.children) {
+        // connection genes are sorted, children with new innovations
+        // have temporary ids at the end
+        const auto &g = child->get_genome();
+        if (g.conn_size() && g.topology().conn_id.back() >= neat::temp_id_base)
+            child->remap_ids(nmap, cmap);
+        speciate_child(child);
+    }
+    off.children.clear();
+}
+
+
+/* @brief: put an offspring into a compatible species
+ * or create a new species for it
+ * a novel species does not reproduce until the next generation
+ */
+void Population::speciate_child(OrganismBase *child, const bool novel) {
+    for (auto &ss : species) {
+        // the first organism is the representative of the species
+        auto first_net = ss->front();
+        if (child->calCompatDistance(first_net) < neat::compat_threshold) {
+            // add child to this species
+            ss->add_org(child);
+            child->setSpecies(ss);
+            return;
+        }
+    }
+    // if no match, create a new species
+    Species *newspecies = novel ? 
+        new Species(next_species_id++) : new Species(next_species_id++, 1);
+    add_species(newspecies);
+    newspecies->add_org(child);
+    child->setSpecies(newspecies);
+    #ifdef ESPINN_VERBOSE
+    std::cout << "New species created. Org representative is: "
+        << std::endl << *child << std::endl;
+    #endif
+}
+
+
+/* @brief: get the best n organisms */
+std::vector<OrganismBase*> Population::get_top_orgs(const eSpinn_size &n) const {
+    std::vector<OrganismBase*> top(orgs);
+    const auto num = std::min<eSpinn_size>(n, top.size());
+    std::partial_sort(top.begin(), top.begin()+num, top.end(), 
+        static_cast<bool (*)(const OrganismBase*, const OrganismBase*)>(greater_fit));
+    top.resize(num);
+    return top;
+}
+
+
+/* @brief: integrate organisms from another population (island)
+ * innovation ids are reconciled by matching the source innovations:
+ * the same mutation gets the local ids, a novel one is registered with new ids
+ * each immigrant replaces the worst organism & the population owns it
+ * call after evaluation and before epoch()
+ */
+void Population::immigrate(std::vector<OrganismBase*> &migrants,
+    const std::vector<Innovation*> &src_innov)
+{
+    if (migrants.empty())
+        return;
+
+    // map source ids to local ids
+    // source innovations are in the order they were created,
+    // so the ids they refer to have been mapped before
+    // ids not created by innovations (i.e. of the initial network) are kept
+    std::unordered_map<neuronID, neuronID> nmap;
+    std::unordered_map<connID, connID> cmap;
+    auto local_nid = [&nmap](const neuronID &n) {
+        auto it = nmap.find(n);
+        return it == nmap.end() ? n : it->second;
+    };
+    auto local_cid = [&cmap](const connID &c) {
+        auto it = cmap.find(c);
+        return it == cmap.end() ? c : it->second;
+    };
+    const auto &g = migrants.front()->get_genome();
+    const eSpinn_size block = g.topology().inp_size + g.topology().outp_size; // size of IN2OUT conns
+    for (auto &s : src_innov) {
+        Innovation t(*s);
+        t.inodeid = local_nid(s->inodeid);
+        t.onodeid = local_nid(s->onodeid);
+        t.old_connid = local_cid(s->old_connid);
+        Innovation *found = nullptr;
+        for (auto &i : innovation) {
+            if (i->matches(t)) {
+                found = i;
+                break;
+            }
+        }
+        switch (s->i_type) {
+            case neat::NEWNODE:
+                if (!found) {
+                    found = new Innovation(t.inodeid, t.onodeid, t.old_connid,
+                        next_neuron_id++, next_conn_id, next_conn_id+1);
+                    next_conn_id += 2;
+                    innovation.push_back(found);
+                }
+                nmap[s->new_nodeid] = found->new_nodeid;
+                cmap[s->new_connid] = found->new_connid;
+                cmap[s->new_connid2] = found->new_connid2;
+                break;
+            case neat::NEWCONN:
+                if (!found) {
+                    found = new Innovation(t.inodeid, t.onodeid, next_conn_id++,
+                        s->new_weight, s->new_conn_type);
+                    innovation.push_back(found);
+                }
+                cmap[s->new_connid] = found->new_connid;
+                break;
+            default: // NEWNODE_IN2OUT
+                if (!found) {
+                    found = new Innovation(s->new_nodeid, next_conn_id);
+                    next_conn_id += block;
+                    innovation.push_back(found);
+                }
+                for (eSpinn_size c = 0; c < block; ++c)
+                    cmap[s->new_connid + c] = found->new_connid + c;
+                break;
+        }
+    }
+
+    for (auto &m : migrants) {
+        m->remap_ids(nmap, cmap);
+        // replace the worst organism
+        auto worst = std::min_element(orgs.begin(), orgs.end(), less_fit);
+        auto s = (*worst)->getSpecies();
+        s->remove_org(*worst);
+        pool.release(*worst);
+        if (s->orgs.empty()) {
+            species.erase(std::find(species.begin(), species.end(), s));
+            delete s;
+        }
+        *worst = m;
+        // immigrants can reproduce in this generation
+        speciate_child(m, false);
+    }
+    migrants.clear();
+}
+
+
 /* @brief: save population to file */
 void Population::archive(const std::string &ofile) {
     #ifndef NDEBUG
@@ -371,11 +626,17 @@ void Population::archive(const std::string &ofile) {
 }
 
 
-/* @brief: construct population from file */
+/* @brief: construct population from file
+ * the format (text or binary) is detected from the file
+ */
 void Population::load(const std::string &ifile) {
     #ifndef NDEBUG
     std::cout << "Loading population from file " << ifile << std::endl;
     #endif
+    if (is_binary_archive(ifile)) {
+        load_binary(ifile);
+        return;
+    }
     std::ifstream ifs(ifile);
     if (!ifs) {
         std::cerr << BnR_ERROR << "Can't open file " << ifile << std::endl;
@@ -385,3 +646,221 @@ void Population::load(const std::string &ifile) {
     ia & *this;
     ifs.close();
 }
+
+
+/* @brief: write the states of population to a binary archive */
+void Population::archive_states(BinaryWriter &w) const {
+    const auto rec = w.begin_record();
+    w.write(gen);
+    w.write(next_neuron_id);
+    w.write(next_conn_id);
+    w.write(next_species_id);
+    w.write(champ_fit);
+    w.write(champ_fit_ever);
+    w.write(stagnant_gens);
+    w.write(solved);
+    w.write(evolving_plastic_term);
+    w.end_record(rec);
+}
+
+
+/* @brief: read the states of population from a binary archive */
+void Population::load_states(BinaryReader &r) {
+    const auto end = r.begin_record();
+    r.read(gen);
+    r.read(next_neuron_id);
+    r.read(next_conn_id);
+    r.read(next_species_id);
+    r.read(champ_fit);
+    r.read(champ_fit_ever);
+    r.read(stagnant_gens);
+    r.read(solved);
+    r.read(evolving_plastic_term);
+    r.end_record(end);
+}
+
+
+/* @brief: write innovations from the first-th to a binary archive */
+void Population::archive_innovation(BinaryWriter &w, const eSpinn_size &first) const {
+    w.write(static_cast<std::uint32_t>(innovation.size() - first));
+    for (auto i = innovation.begin() + first; i != innovation.end(); ++i) {
+        const auto rec = w.begin_record();
+        w.write((*i)->i_type);
+        w.write((*i)->inodeid);
+        w.write((*i)->onodeid);
+        w.write((*i)->old_connid);
+        w.write((*i)->new_nodeid);
+        w.write((*i)->new_connid);
+        w.write((*i)->new_connid2);
+        w.write((*i)->new_weight);
+        w.write((*i)->new_conn_type);
+        w.end_record(rec);
+    }
+}
+
+
+/* @brief: read innovations from a binary archive
+ * and append them to the population
+ */
+void Population::load_innovation(BinaryReader &r) {
+    std::uint32_t num = 0;
+    r.read(num);
+    for (std::uint32_t k = 0; k < num && r.ok(); ++k) {
+        const auto end = r.begin_record();
+        neat::innoType t;
+        r.read(t);
+        auto i = new Innovation(t);
+        r.read(i->inodeid);
+        r.read(i->onodeid);
+        r.read(i->old_connid);
+        r.read(i->new_nodeid);
+        r.read(i->new_connid);
+        r.read(i->new_connid2);
+        r.read(i->new_weight);
+        r.read(i->new_conn_type);
+        r.end_record(end);
+        innovation.push_back(i);
+    }
+}
+
+
+/* @brief: write species to a binary archive
+ * organisms are referred to by their index in orgs
+ */
+void Population::archive_species(BinaryWriter &w) const {
+    std::unordered_map<const OrganismBase*, std::uint32_t> index;
+    for (std::uint32_t k = 0; k < orgs.size(); ++k)
+        index[orgs[k]] = k;
+
+    w.write(static_cast<std::uint32_t>(species.size()));
+    for (auto &s : species) {
+        const auto rec = w.begin_record();
+        w.write(s->s_id);
+        w.write(s->age);
+        w.write(s->age_last_improved);
+        w.write(s->novel);
+        std::vector<std::uint32_t> members;
+        for (auto &o : s->orgs)
+            members.push_back(index[o]);
+        w.write(members);
+        w.end_record(rec);
+    }
+}
+
+
+/* @brief: read species from a binary archive
+ * put the loaded organisms into species and the population
+ * organisms not in any species are deleted
+ * return false if the archive is corrupted
+ */
+bool Population::load_species(BinaryReader &r, const std::vector<OrganismBase*> &loaded,
+    bool good)
+{
+    std::uint32_t num = 0;
+    r.read(num);
+    for (std::uint32_t k = 0; k < num && good; ++k) {
+        const auto end = r.begin_record();
+        auto s = new Species();
+        r.read(s->s_id);
+        r.read(s->age);
+        r.read(s->age_last_improved);
+        r.read(s->novel);
+        std::vector<std::uint32_t> members;
+        r.read(members);
+        r.end_record(end);
+        species.push_back(s);
+        for (auto &m : members) {
+            if (m >= loaded.size() || loaded[m]->getSpecies()) {
+                good = false;
+                break;
+            }
+            s->add_org(loaded[m]);
+            loaded[m]->setSpecies(s);
+        }
+    }
+    good = good && r.ok();
+
+    // the population owns organisms through species
+    for (auto &o : loaded) {
+        if (good && o->getSpecies())
+            orgs.push_back(o);
+        else if (!o->getSpecies())
+            delete o;
+    }
+    return good;
+}
+
+
+/* @brief: save population to file in binary format
+ * much faster & smaller than the text archive
+ */
+void Population::archive_binary(const std::string &ofile) const {
+    #ifndef NDEBUG
+    std::cout << "Archiving population to file " << ofile << std::endl;
+    #endif
+    BinaryWriter w(binarch::POPULATION);
+    archive_binary(w);
+    w.save(ofile);
+}
+
+
+/* @brief: write population to a binary archive
+ * the writer is of content POPULATION
+ */
+void Population::archive_binary(BinaryWriter &w) const {
+    archive_states(w);
+    archive_innovation(w, 0);
+    w.write(static_cast<std::uint32_t>(orgs.size()));
+    for (auto &o : orgs) {
+        w.write(std::string(o->type_key()));
+        o->archive(w);
+    }
+    archive_species(w);
+}
+
+
+/* @brief: construct population from a binary archive
+ * the archive is either a full snapshot or a checkpoint delta
+ * return false if the archive is corrupted
+ */
+bool Population::load_binary(const std::string &ifile) {
+    BinaryReader r(ifile);
+    if (r.getContent() == binarch::CHECKPOINT_DELTA)
+        return CheckpointStore::restore(*this, ifile);
+    const bool good = load_binary(r);
+    if (!good)
+        std::cerr << BnR_ERROR << "Corrupted archive " << ifile << std::endl;
+    return good;
+}
+
+
+/* @brief: construct population from a binary archive of content POPULATION
+ * return false if the archive is corrupted
+ */
+bool Population::load_binary(BinaryReader &r) {
+    if (r.getContent() != binarch::POPULATION) {
+        std::cerr << BnR_ERROR << "Not a population archive" << std::endl;
+        return false;
+    }
+    load_states(r);
+    load_innovation(r);
+
+    bool good = r.ok();
+    std::vector<OrganismBase*> loaded;
+    std::uint32_t num = 0;
+    r.read(num);
+    for (std::uint32_t k = 0; k < num && good; ++k) {
+        std::string key;
+        r.read(key);
+        auto o = create_organism(key);
+        if (!o) {
+            std::cerr << BnR_ERROR << "Unknown organism type " << key << std::endl;
+            good = false;
+            break;
+        }
+        loaded.push_back(o);
+        good = o->load(r);
+    }
+
+    return load_species(r, loaded, good);
+}
@@ -9,10 +9,12 @@
 #include "eSpinn_def.h"
 #include "OrganismBase.h"
 #include "Organism.h"
+#include "OrganismPool.h"
 #include "Species.h"
 #include "Innovation.h"
 #include "Models/Network.h"
 #include "Utilities/Utilities.h"
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -28,6 +30,8 @@ namespace eSpinn {
     class Population
     {
         friend class Species;
+        friend class SteadyStateScheduler;
+        friend class CheckpointStore;
         /* @brief: declare serialization library as friend
          * used to grant to the serialization library access to class members
          */
@@ -56,11 +60,59 @@ namespace eSpinn {
         double champ_fit, champ_fit_ever;
         eSpinn_size stagnant_gens;
         bool solved;
+        std::uint64_t seed; // seed of reproduction random streams
+        eSpinn_size num_threads; // threads used in reproduction
+
+        /* @brief: reproduce offspring of all species
+         * species create offspring in parallel, each with its own random stream
+         * offspring are then merged in order of species
+         */
+        void reproduce(const eSpinn_size &generation,
+            const std::vector<Species*> &sorted_species);
+
+        /* @brief: merge offspring created by a species
+         * assign ids to the new innovations and speciate the children
+         */
+        void merge_offspring(Offspring &off);
+
+        /* @brief: put an offspring into a compatible species
+         * or create a new species for it
+         * a novel species does not reproduce until the next generation
+         */
+        void speciate_child(OrganismBase *child, const bool novel = true);
+
+        /* @brief: write the states of population to a binary archive */
+        void archive_states(BinaryWriter &w) const;
+
+        /* @brief: read the states of population from a binary archive */
+        void load_states(BinaryReader &r);
+
+        /* @brief: write innovations from the first-th to a binary archive */
+        void archive_innovation(BinaryWriter &w, const eSpinn_size &first) const;
+
+        /* @brief: read innovations from a binary archive
+         * and append them to the population
+         */
+        void load_innovation(BinaryReader &r);
+
+        /* @brief: write species to a binary archive
+         * organisms are referred to by their index in orgs
+         */
+        void archive_species(BinaryWriter &w) const;
+
+        /* @brief: read species from a binary archive
+         * put the loaded organisms into species and the population
+         * organisms not in any species are deleted
+         * return false if the archive is corrupted
+         */
+        bool load_species(BinaryReader &r, const std::vector<OrganismBase*> &loaded,
+            bool good);
     public:
         bool evolving_plastic_term; // true when evolving p terms
         std::vector<OrganismBase *> orgs;
         std::vector<Species *> species;
         std::vector<Innovation *> innovation;
+        OrganismPool pool; // recycled organisms, not archived
         // std::vector<eSpinn_size> winners;
     public:
         /* @brief: constructors */
@@ -114,6 +166,21 @@ namespace eSpinn {
             next_species_id = s_id;
         }
 
+        /* @brief: set the seed of reproduction random streams
+         * the stream of each species is seeded by seed, generation & species id
+         * so offspring do not depend on the num of threads
+         * it's drawn from the random engine by default
+         */
+        void set_seed(const std::uint64_t &s);
+
+        /* @brief: get the seed of reproduction random streams */
+        inline const std::uint64_t get_seed() const { return seed; }
+
+        /* @brief: set the num of threads used in reproduction
+         * 0 means using all hardware threads
+         */
+        void set_threads(const eSpinn_size &n);
+
         /* @brief: check if this population will solve the problem */
         bool issolved() const;
 
@@ -167,11 +234,46 @@ namespace eSpinn {
          */
         bool epoch(const eSpinn_size &g);
 
+        /* @brief: get the best n organisms */
+        std::vector<OrganismBase*> get_top_orgs(const eSpinn_size &n) const;
+
+        /* @brief: integrate organisms from another population (island)
+         * innovation ids are reconciled by matching the source innovations:
+         * the same mutation gets the local ids, a novel one is registered with new ids
+         * each immigrant replaces the worst organism & the population owns it
+         * call after evaluation and before epoch()
+         */
+        void immigrate(std::vector<OrganismBase*> &migrants,
+            const std::vector<Innovation*> &src_innov);
+
         /* @brief: save population to file */
         void archive(const std::string &ofile);
 
-        /* @brief: construct population from file */
+        /* @brief: construct population from file
+         * the format (text or binary) is detected from the file
+         */
         void load(const std::string &ifile);
+
+        /* @brief: save population to file in binary format
+         * much faster & smaller than the text archive
+         */
+        void archive_binary(const std::string &ofile) const;
+
+        /* @brief: write population to a binary archive
+         * the writer is of content POPULATION
+         */
+        void archive_binary(BinaryWriter &w) const;
+
+        /* @brief: construct population from a binary archive
+         * the archive is either a full snapshot or a checkpoint delta
+         * return false if the archive is corrupted
+         */
+        bool load_binary(const std::string &ifile);
+
+        /* @brief: construct population from a binary archive of content POPULATION
+         * return false if the archive is corrupted
+         */
+        bool load_binary(BinaryReader &r);
     };
     
 }
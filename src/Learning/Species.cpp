@@ -102,13 +102,36 @@ void Species::incExpOffspring(const eSpinn_size &exp_num) {
 }
 
 
-/* @brief: calculate the expected size of offspring */
+/* @brief: get the num of organisms that survive adjustFit()
+ * at least one will survive
+ */
+const eSpinn_size Species::num_survivors() const {
+    if (neat::survival_thresh >= 1.0)
+        return size();
+    return neat::survival_thresh * size() + 1;
+}
+
+
+/* @brief: get the factor adjustFit() scales fitness by
+ * i.e. 1/size, and a penalty if the species is not progressing
+ */
+const double Species::fit_share() const {
+    int age_debt = age - age_last_improved - neat::dropoff_age;
+    return (age_debt >= 0 ? .01 : 1.0) / size();
+}
+
+
+/* @brief: calculate the expected size of offspring
+ * a sum within neat::offspring_tol below an integer is rounded up,
+ * e.g. the offspring of the last species add up to the population size
+ * whatever the rounding errors
+ */
 void Species::count_offspring(double &fracpart) {
     double expected_num = fracpart;
     for (auto &o : orgs) {
         expected_num += o->getExpectedOffspring();
     }
-    expected_offspring = (eSpinn_size) floor(expected_num);
+    expected_offspring = (eSpinn_size) floor(expected_num + neat::offspring_tol);
     fracpart = expected_num - expected_offspring;
 }
 
@@ -149,13 +172,8 @@ void Species::adjustFit() {
     }
     
     // mark survivors, at least one will survive
-    int num_survivor = 1;
-    if (neat::survival_thresh >= 1.0)
-        num_survivor = size();
-    else
-        num_survivor = neat::survival_thresh * size() + 1;
     auto cur_org = orgs.begin();
-    std::advance(cur_org, num_survivor);
+    std::advance(cur_org, num_survivors());
     while (cur_org != orgs.end()) {
         (*cur_org)->setDead();
         ++cur_org;
@@ -163,13 +181,73 @@ void Species::adjustFit() {
 }
 
 
-/* @brief: reproduce offspring */
+/* @brief: share fitness within the species
+ * like adjustFit() but organisms are neither sorted nor marked
+ * used by steady-state evolution whenever the species changes
+ */
+void Species::share_fit() {
+    int age_debt = age - age_last_improved - neat::dropoff_age;
+    champ = nullptr;
+    for (auto &o : orgs) {
+        o->fitness = o->orig_fit;
+        if (age_debt >= 0)
+            // penalty for not progressing
+            o->fitness *= 0.01;
+        o->fitness /= size();
+        if (!champ || o->orig_fit > champ->orig_fit)
+            champ = o;
+    }
+
+    // update age_last_improved
+    max_fitness = champ ? champ->orig_fit : .0;
+    if (max_fitness > max_fit_ever) {
+        max_fit_ever = max_fitness;
+        age_last_improved = age;
+    }
+}
+
+
+/* @brief: record the fitness of an evaluated organism
+ * and share fitness within the species
+ */
+void Species::record_fit(OrganismBase *const o, const double &f) {
+    o->orig_fit = f;
+    share_fit();
+}
+
+
+/* @brief: increase the age
+ * a novel species becomes old without aging
+ */
+void Species::grow() {
+    if (novel)
+        novel = false;
+    else
+        ++age;
+}
+
+
+/* @brief: reproduce offspring
+ * only parents are read, offspring are not speciated here
+ * random numbers are drawn from the calling thread's engine
+ * parameter mutations of all offspring are done in one go at the end
+ * organisms in skip (e.g. not yet evaluated) are never parents,
+ * the champion of another species in skip is replaced by its best other organism
+ */
 void Species::reproduce(const eSpinn_size &gen, Population *pop,
-    const std::vector<Species*> &sorted_species) 
+    const std::vector<Species*> &sorted_species, Offspring &off,
+    const std::unordered_set<OrganismBase *> *skip) const
 {
+    MutationEngine mutation;
+    std::vector<OrganismBase *> parents;
+    for (auto &o : orgs) {
+        if (!skip || !skip->count(o))
+            parents.push_back(o);
+    }
+    assert((!expected_offspring || !parents.empty()) && "Error: no parent in species!");
     // choose dad org from sorted_species
     bool champ_done = false;
-    auto parent_size = size();
+    auto parent_size = parents.size();
     for (eSpinn_size count = 0; count < expected_offspring; ++count) {
         // Network *child = new Network(gen);
         OrganismBase *child = nullptr;
@@ -178,21 +256,21 @@ void Species::reproduce(const eSpinn_size &gen, Population *pop,
         if (!champ_done && expected_offspring > 5) {
             // std::cout << "Clone the best organism in species " << s_id << std::endl;
             // by this time the first organism should be the champion 
-            child = front()->duplicate(count, gen);
+            child = pop->pool.acquire(parents.front(), count, gen);
             champ_done = true;
         }
         else if (rand() < neat::mutate_only_prob) {
             // duplicate and mutate
             auto index = rand(0, parent_size-1); // use the parent orgs
-            child = orgs[index]->duplicate(count, gen);
-            child->evolve(pop->next_neuron_id, pop->next_conn_id, pop->innovation,
-                pop->evolving_plastic_term);
+            child = pop->pool.acquire(parents[index], count, gen);
+            child->evolve(off.next_nid, off.next_cid, off.innov,
+                pop->evolving_plastic_term, &mutation);
         }
         else {
             // crossover (mate)
             // first pick mom
             auto index_mom = rand(0, parent_size-1);
-            auto mom = orgs[index_mom];
+            auto mom = parents[index_mom];
 
             // pick dad, either a random one from this species or 
             // the champ of a diffrent species
@@ -200,7 +278,7 @@ void Species::reproduce(const eSpinn_size &gen, Population *pop,
             if (rand() < neat::mate_within_species_rate) {
                 // mate within species
                 auto index_dad = rand(0, parent_size-1);
-                dad = orgs[index_dad];
+                dad = parents[index_dad];
             }
             else {
                 // mate interspecies
@@ -211,7 +289,19 @@ void Species::reproduce(const eSpinn_size &gen, Population *pop,
                 // the possibility of mating mom with a newly created child
                 int index_species = static_cast<int>(floor(
                             species_rank*(sorted_species.size()-1)+0.5 ));
-                dad = sorted_species[index_species]->front();
+                auto dad_species = sorted_species[index_species];
+                dad = dad_species->front();
+                if (skip && skip->count(dad)) {
+                    OrganismBase *best = nullptr;
+                    for (auto &o : dad_species->orgs) {
+                        if (skip->count(o))
+                            continue;
+                        if (!best || o->getOrigFit() > best->getOrigFit())
+                            best = o;
+                    }
+                    // mate with mom if the species has no parent
+                    dad = best ? best : mom;
+                }
             }
             // set mom as the better parent
             // auto parent = (*mom > *dad) ? mom : dad;
@@ -221,39 +311,17 @@ void Species::reproduce(const eSpinn_size &gen, Population *pop,
 
             // mating: inherit from mom and crossover with dad
             // mutate if parents are the same org
-            child = mom->duplicate(count, gen);
+            child = pop->pool.acquire(mom, count, gen);
             if (mom == dad) {
-                child->evolve(pop->next_neuron_id, pop->next_conn_id, 
-                    pop->innovation, pop->evolving_plastic_term);
+                child->evolve(off.next_nid, off.next_cid, 
+                    off.innov, pop->evolving_plastic_term, &mutation);
             }
             else {
                 child->crossover(dad);
             }
         }
 
-        // add the child to species
-        bool match = false;
-        for (auto &ss : pop->species) {
-            // the first organism is the representative of the species
-            auto first_net = ss->front();
-            if (child->calCompatDistance(first_net) < neat::compat_threshold) {
-                // add child to this species
-                ss->add_org(child);
-                child->setSpecies(ss);
-                match = true;
-                break;
-            }
-        }
-        // if no match, create a new species
-        if (!match) {
-            Species *newspecies = new Species(pop->next_species_id++);
-            pop->add_species(newspecies);
-            newspecies->add_org(child);
-            child->setSpecies(newspecies);
-            #ifdef ESPINN_VERBOSE
-            std::cout << "New species created. Org representative is: "
-                << std::endl << *child << std::endl;
-            #endif
-        }
+        off.children.push_back(child);
     }
+    mutation.mutate();
 }
@@ -12,6 +12,7 @@
 #include "Utilities/Utilities.h"
 #include <iostream>
 #include <vector>
+#include <unordered_set>
 #include <algorithm>
 
 /* @brief: Species 
@@ -20,9 +21,29 @@
  */
 namespace eSpinn {
     class Population;
+
+    /* @brief: Offspring
+     * offspring created by a species during reproduction
+     * innovations are recorded in a local list with temporary ids
+     * so that species can reproduce independently (in parallel)
+     * ids are assigned when offspring are merged into the population
+     */
+    struct Offspring
+    {
+        std::vector<OrganismBase *> children;
+        std::vector<Innovation *> innov; // population's innovations, then new ones
+        eSpinn_size num_shared; // num of population's innovations
+        neuronID next_nid; // next temporary ids
+        connID next_cid;
+
+        Offspring() : children(), innov(), num_shared(0), 
+            next_nid(neat::temp_id_base), next_cid(neat::temp_id_base) { }
+    };
+
     class Species
     {
         friend class Population;
+        friend class SurvivalCutoff;
         /* @brief: declare serialization library as friend
          * used to grant to the serialization library access to class members
          */
@@ -88,6 +109,14 @@ namespace eSpinn {
         /* @brief: get the size of organisms */
         inline const eSpinn_size size() const { return orgs.size(); }
 
+        /* @brief: get the num of organisms that survive adjustFit()
+         * at least one will survive
+         */
+        const eSpinn_size num_survivors() const;
+
+        /* @brief: get the factor adjustFit() scales fitness by */
+        const double fit_share() const;
+
         /* @brief: add an organism */
         void add_org(OrganismBase *const o);
 
@@ -127,9 +156,48 @@ namespace eSpinn {
          */
         void adjustFit();
 
-        /* @brief: reproduce offspring */
+        /* @brief: share fitness within the species
+         * like adjustFit() but organisms are neither sorted nor marked
+         * used by steady-state evolution whenever the species changes
+         */
+        void share_fit();
+
+        /* @brief: record the fitness of an evaluated organism
+         * and share fitness within the species
+         */
+        void record_fit(OrganismBase *const o, const double &f);
+
+        /* @brief: get the average shared fitness of organisms
+         * organisms in skip (e.g. not yet evaluated) are not counted
+         * return 0 if no organism is counted
+         */
+        template <typename Set>
+        double avg_fit(const Set &skip) const {
+            double sum = .0;
+            eSpinn_size num = 0;
+            for (auto &o : orgs) {
+                if (skip.count(o))
+                    continue;
+                sum += o->getFit();
+                ++num;
+            }
+            return num ? sum / num : .0;
+        }
+
+        /* @brief: increase the age
+         * a novel species becomes old without aging
+         */
+        void grow();
+
+        /* @brief: reproduce offspring
+         * only parents are read, offspring are not speciated here
+         * random numbers are drawn from the calling thread's engine
+         * organisms in skip (e.g. not yet evaluated) are never parents,
+         * the species must have an organism not in skip
+         */
         void reproduce(const eSpinn_size &gen, Population *pop,
-            const std::vector<Species*> &sorted_species);
+            const std::vector<Species*> &sorted_species, Offspring &off,
+            const std::unordered_set<OrganismBase *> *skip = nullptr) const;
 
         /* relational operators */
         bool operator==(const Species &s) const {
@@ -0,0 +1,246 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "SteadyStateScheduler.h"
+#include <algorithm>
+#include <thread>
+using namespace eSpinn;
+
+
+/* @brief: constructor
+ * all organisms of the population are dispatched for evaluation
+ * 0 workers means using all hardware threads
+ */
+SteadyStateScheduler::SteadyStateScheduler(Population *const p, const Evaluator &e,
+    const eSpinn_size &workers) :
+    pop(p), evaluator(e), num_workers(workers), winner_fit(1.0),
+    ready(), busy(), evaluated(0), births(0), next_org_id(0), mtx(), cv()
+{
+    if (!num_workers)
+        num_workers = std::max<eSpinn_size>(std::thread::hardware_concurrency(), 1);
+    for (auto &o : pop->orgs) {
+        ready.push_back(o);
+        busy.insert(o);
+        next_org_id = std::max<netID>(next_org_id, o->getID() + 1);
+    }
+}
+
+
+/* @brief: set the fitness that solves the problem */
+void SteadyStateScheduler::set_winner_fit(const double &f) {
+    winner_fit = f;
+}
+
+
+/* @brief: get the num of evaluations */
+const eSpinn_size SteadyStateScheduler::get_evaluated() const {
+    return evaluated;
+}
+
+
+/* @brief: get the num of offspring created */
+const eSpinn_size SteadyStateScheduler::get_births() const {
+    return births;
+}
+
+
+/* @brief: get the evaluated organism with the highest original fitness */
+OrganismBase *const SteadyStateScheduler::get_champ() const {
+    OrganismBase *champ = nullptr;
+    for (auto &o : pop->orgs) {
+        if (busy.count(o))
+            continue;
+        if (!champ || o->getOrigFit() > champ->getOrigFit())
+            champ = o;
+    }
+    return champ;
+}
+
+
+/* @brief: evaluate organisms until num more evaluations are done
+ * or the problem is solved
+ * organisms still waiting are dispatched in the next run
+ * return true if solved
+ */
+bool SteadyStateScheduler::run(const eSpinn_size &num) {
+    assert(!pop->species.empty() && "Error: no species in population!");
+    const auto target = evaluated + num;
+    std::vector<std::thread> workers;
+    for (eSpinn_size w = 1; w < num_workers; ++w)
+        workers.emplace_back(&SteadyStateScheduler::work, this, w, target);
+    work(0, target);
+    for (auto &w : workers)
+        w.join();
+    return pop->issolved();
+}
+
+
+/* @brief: worker loop
+ * take an organism, evaluate it and report the fitness
+ * until the target num of evaluations is dispatched
+ */
+void SteadyStateScheduler::work(const eSpinn_size &worker, const eSpinn_size &target) {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        // being evaluated by other workers
+        auto running = [this]() { return busy.size() - ready.size(); };
+        cv.wait(lock, [&]() {
+            return !ready.empty() || pop->issolved()
+                || evaluated + running() >= target || !running();
+        });
+        if (ready.empty() || pop->issolved() || evaluated + running() >= target)
+            break;
+        auto o = ready.front();
+        ready.pop_front();
+
+        lock.unlock();
+        const auto f = evaluator(o, worker);
+        lock.lock();
+
+        report(o, f);
+        cv.notify_all();
+    }
+    cv.notify_all();
+}
+
+
+/* @brief: record fitness of an evaluated organism
+ * and replace the worst organism with an offspring
+ * called with the lock held
+ */
+void SteadyStateScheduler::report(OrganismBase *const o, const double &f) {
+    busy.erase(o);
+    ++evaluated;
+    o->setFit(f);
+    if (o->setWinner(winner_fit))
+        pop->set_solved();
+    o->getSpecies()->record_fit(o, f);
+    if (pop->issolved())
+        return;
+
+    auto child = replace();
+    if (child) {
+        ready.push_back(child);
+        busy.insert(child);
+    }
+}
+
+
+/* @brief: replace the worst evaluated organism with an offspring
+ * return the offspring, or nullptr if nothing can be replaced
+ * called with the lock held
+ */
+OrganismBase* SteadyStateScheduler::replace() {
+    // keep at least one evaluated organism as parent
+    if (pop->size() < busy.size() + 2)
+        return nullptr;
+
+    // remove the worst evaluated organism, the champion is kept
+    const auto champ = get_champ();
+    auto worst = pop->orgs.end();
+    for (auto o = pop->orgs.begin(); o != pop->orgs.end(); ++o) {
+        if (busy.count(*o) || *o == champ)
+            continue;
+        if (worst == pop->orgs.end() || (*o)->getFit() < (*worst)->getFit())
+            worst = o;
+    }
+    auto worst_species = (*worst)->getSpecies();
+    worst_species->remove_org(*worst);
+    pop->pool.release(*worst); // recycled by the offspring
+    pop->orgs.erase(worst);
+    if (!worst_species->size()) {
+        pop->species.erase(std::find(pop->species.begin(), pop->species.end(),
+            worst_species));
+        delete worst_species;
+    } else
+        worst_species->share_fit();
+
+    // choose the parent species by average shared fitness
+    Species *parent = nullptr;
+    double total = .0;
+    std::vector<double> avg;
+    for (auto &s : pop->species) {
+        avg.push_back(s->avg_fit(busy));
+        total += avg.back();
+    }
+    auto pick = rand() * total;
+    for (eSpinn_size i = 0; i < avg.size(); ++i) {
+        if (avg[i] <= .0)
+            continue;
+        parent = pop->species[i];
+        if (pick < avg[i])
+            break;
+        pick -= avg[i];
+    }
+    // no fitness yet, use the species of any evaluated organism
+    if (!parent) {
+        for (auto &o : pop->orgs) {
+            if (!busy.count(o)) {
+                parent = o->getSpecies();
+                break;
+            }
+        }
+    }
+
+    // reproduce a single offspring of evaluated organisms
+    std::vector<Species*> sorted_species = pop->species;
+    pop->sort(sorted_species);
+    Offspring off;
+    off.innov = pop->innovation;
+    off.num_shared = pop->innovation.size();
+    const auto expected = parent->getExpOffspring();
+    parent->setExpOffspring(1);
+    parent->reproduce(pop->getGen(), pop, sorted_species, off, &busy);
+    parent->setExpOffspring(expected);
+    auto child = off.children.front();
+    pop->merge_offspring(off);
+    child->setID(next_org_id++);
+    pop->orgs.push_back(child);
+    child->getSpecies()->share_fit();
+
+    if (!(++births % pop->size()))
+        next_gen();
+    return child;
+}
+
+
+/* @brief: update ages & stagnation after pop size of births
+ * called with the lock held
+ */
+void SteadyStateScheduler::next_gen() {
+    for (auto &s : pop->species) {
+        s->grow();
+        s->share_fit();
+    }
+
+    // check if population stagnant
+    auto champ = get_champ();
+    pop->champ_fit = champ ? champ->getOrigFit() : .0;
+    if (pop->champ_fit > pop->champ_fit_ever) {
+        pop->champ_fit_ever = pop->champ_fit;
+        pop->stagnant_gens = 0;
+        std::cout << "New fitness record: " << pop->champ_fit << std::endl;
+    } else {
+        ++pop->stagnant_gens;
+    }
+    // if stagnant, give the best two species a fresh start
+    // the others will be penalized for not progressing and replaced
+    if (pop->stagnant_gens >= neat::stagnant_gen) {
+        pop->stagnant_gens = 0;
+        std::vector<Species*> sorted_species = pop->species;
+        pop->sort(sorted_species);
+        for (eSpinn_size i = 0; i < std::min<eSpinn_size>(2, sorted_species.size()); ++i) {
+            sorted_species[i]->record_age_improved();
+            sorted_species[i]->share_fit();
+        }
+    }
+
+    pop->incrementGen();
+    std::cout << "Gen #" << pop->getGen() << " (" << evaluated << " evaluations): "
+        << pop->species.size() << " species, champ fit = " << pop->champ_fit << std::endl;
+    // report allocations of the last pop size of births
+    std::cout << alloc_stats() << std::endl;
+    alloc_stats().reset();
+}
@@ -0,0 +1,108 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "OrganismBase.h"
+#include "Species.h"
+#include "Population.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+/* @brief: SteadyStateScheduler
+ * asynchronous steady-state evolution (rtNEAT)
+ * workers evaluate organisms continuously, there is no generational barrier
+ * whenever an evaluation is returned, the worst evaluated organism
+ * is replaced by an offspring of a species chosen by its average shared fitness,
+ * and the offspring is dispatched immediately
+ * organisms waiting or being evaluated are never replaced, nor is the champion,
+ * and are never parents, as their fitness is unknown
+ * fitness sharing & species ages are maintained incrementally,
+ * pop size of births count as a generation
+ * offspring depend on the order evaluations return, i.e. runs are not reproducible
+ * initialization list: population, evaluator, num of workers
+ */
+namespace eSpinn {
+    class SteadyStateScheduler
+    {
+    public:
+        /* @brief: evaluator
+         * return the fitness of an organism
+         * called concurrently, each worker with its own index
+         * it must not change anything other than the organism's phenotype
+         */
+        typedef std::function<double(OrganismBase *, const eSpinn_size &)> Evaluator;
+    private:
+        /* data */
+        Population *pop;
+        Evaluator evaluator;
+        eSpinn_size num_workers;
+        double winner_fit;
+        std::deque<OrganismBase *> ready; // waiting to be evaluated
+        std::unordered_set<OrganismBase *> busy; // waiting or being evaluated
+        eSpinn_size evaluated, births;
+        netID next_org_id;
+        std::mutex mtx;
+        std::condition_variable cv;
+
+        /* @brief: worker loop
+         * take an organism, evaluate it and report the fitness
+         * until the target num of evaluations is dispatched
+         */
+        void work(const eSpinn_size &worker, const eSpinn_size &target);
+
+        /* @brief: record fitness of an evaluated organism
+         * and replace the worst organism with an offspring
+         * called with the lock held
+         */
+        void report(OrganismBase *const o, const double &f);
+
+        /* @brief: replace the worst evaluated organism with an offspring
+         * return the offspring, or nullptr if nothing can be replaced
+         * called with the lock held
+         */
+        OrganismBase* replace();
+
+        /* @brief: update ages & stagnation after pop size of births
+         * called with the lock held
+         */
+        void next_gen();
+    public:
+        /* @brief: constructor
+         * all organisms of the population are dispatched for evaluation
+         * 0 workers means using all hardware threads
+         */
+        SteadyStateScheduler(Population *const p, const Evaluator &e,
+            const eSpinn_size &workers = 0);
+        SteadyStateScheduler(const SteadyStateScheduler&) = delete;
+        SteadyStateScheduler& operator=(const SteadyStateScheduler&) = delete;
+
+        /* @brief: set the fitness that solves the problem */
+        void set_winner_fit(const double &f);
+
+        /* @brief: get the num of evaluations */
+        const eSpinn_size get_evaluated() const;
+
+        /* @brief: get the num of offspring created */
+        const eSpinn_size get_births() const;
+
+        /* @brief: get the evaluated organism with the highest original fitness */
+        OrganismBase *const get_champ() const;
+
+        /* @brief: evaluate organisms until num more evaluations are done
+         * or the problem is solved
+         * organisms still waiting are dispatched in the next run
+         * return true if solved
+         */
+        bool run(const eSpinn_size &num);
+    };
+}
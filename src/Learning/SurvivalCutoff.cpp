@@ -0,0 +1,129 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "SurvivalCutoff.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+using namespace eSpinn;
+
+
+/* @brief: constructor */
+SurvivalCutoff::SurvivalCutoff(const Population &pop, const double &winner) :
+    top(pop.species.size()), num_survivors(), species_of(), ranges(),
+    pop(&pop), winner_fit(winner), num_stopped(0), num_finished(0)
+{
+    for (eSpinn_size k = 0; k < pop.species.size(); ++k) {
+        auto s = pop.species[k];
+        num_survivors.push_back(s->num_survivors());
+        for (auto &o : s->orgs)
+            species_of[o] = k;
+    }
+}
+
+
+/* @brief: get the fitness organism o has to reach to survive or win
+ * i.e. the lower of the winner fitness and the cutoff of its species,
+ * which is the num_survivors()-th highest fitness evaluated in the species
+ * -inf if it may survive whatever its fitness
+ * its evaluation can stop once its fitness bound is below it
+ */
+const double SurvivalCutoff::threshold(const OrganismBase *o) const {
+    auto s = species_of.find(o);
+    if (s == species_of.end() || top[s->second].size() < num_survivors[s->second])
+        return -std::numeric_limits<double>::infinity();
+    // a tie may still survive
+    return std::min(top[s->second].top(), winner_fit);
+}
+
+
+/* @brief: record the fitness of an evaluated organism */
+void SurvivalCutoff::record(const OrganismBase *o, const double &fit) {
+    auto s = species_of.find(o);
+    if (s == species_of.end())
+        return;
+    auto &heap = top[s->second];
+    if (heap.size() < num_survivors[s->second]) {
+        heap.push(fit);
+    } else if (fit > heap.top()) {
+        heap.pop();
+        heap.push(fit);
+    }
+}
+
+
+/* @brief: record an organism whose evaluation stopped early
+ * its fitness is in [lowest, bound]
+ */
+void SurvivalCutoff::stopped(const OrganismBase *o, const double &lowest,
+    const double &bound)
+{
+    ranges[o] = std::make_pair(lowest, bound);
+    ++num_stopped;
+}
+
+
+/* @brief: get a stopped organism to be evaluated to the end
+ * nullptr if offspring counts are the same as with full evaluations
+ * Population::epoch() gives species k
+ * floor(n*p[k]/sum + tol) - floor(n*p[k-1]/sum + tol) offspring,
+ * where p[k] is the sum of shared fitness of species 0 ... k,
+ * n*p[k]/sum is the highest if stopped organisms of species 0 ... k
+ * are at their bounds and the others at their lowest, & vice versa,
+ * the counts are the same if all floor(n*p[k]/sum + tol) are
+ * the stopped organism of the widest range is returned otherwise
+ */
+OrganismBase* SurvivalCutoff::unresolved() const {
+    if (ranges.empty())
+        return nullptr;
+    const auto &ss = pop->species;
+    const double n = pop->size();
+    // lowest & highest sums of shared fitness of each species
+    std::vector<double> lo(ss.size(), .0), hi(ss.size(), .0);
+    double lo_sum = .0, hi_sum = .0;
+    OrganismBase *widest = nullptr;
+    double width = .0;
+    for (eSpinn_size k = 0; k < ss.size(); ++k) {
+        const auto share = ss[k]->fit_share();
+        for (auto &o : ss[k]->orgs) {
+            double l = o->getFit(), h = l;
+            auto r = ranges.find(o);
+            if (r != ranges.end()) {
+                l = r->second.first;
+                h = r->second.second;
+                if (!widest || (h - l) * share > width) {
+                    widest = o;
+                    width = (h - l) * share;
+                }
+            }
+            lo[k] += l * share;
+            hi[k] += h * share;
+        }
+        lo_sum += lo[k];
+        hi_sum += hi[k];
+    }
+    // margin of rounding errors of the sums, well below the tolerance
+    const double eps = 1e-12 * n, tol = neat::offspring_tol;
+    double lo_pre = .0, hi_pre = .0;
+    for (eSpinn_size k = 0; k < ss.size(); ++k) {
+        lo_pre += lo[k];
+        hi_pre += hi[k];
+        const double lo_all = lo_pre + (hi_sum - hi_pre);
+        const double hi_all = hi_pre + (lo_sum - lo_pre);
+        if (lo_all <= .0 || hi_all <= .0)
+            return widest;
+        if (std::floor(n * lo_pre / lo_all + tol - eps)
+            != std::floor(n * hi_pre / hi_all + tol + eps))
+            return widest;
+    }
+    return nullptr;
+}
+
+
+/* @brief: record that stopped organism o is evaluated to the end */
+void SurvivalCutoff::finished(const OrganismBase *o) {
+    if (ranges.erase(o))
+        ++num_finished;
+}
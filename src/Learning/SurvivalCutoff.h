@@ -0,0 +1,84 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "OrganismBase.h"
+#include "Population.h"
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* @brief: SurvivalCutoff
+ * early termination of hopeless evaluations in a generation
+ * an organism survives adjustFit() only if it is among the top
+ * num_survivors() of its species, and the fitness values of the evaluated
+ * organisms of its species give a cutoff it has to exceed
+ * the task evaluating an organism tracks an upper bound of its fitness,
+ * and can stop once the bound falls below threshold(),
+ * i.e. the organism can neither survive nor be a winner
+ * setting its fitness to the bound keeps the survivors, champions & winners
+ * the same as if it had been evaluated to the end
+ * but not the expected offspring of Population::epoch(),
+ * which are shares of the fitness sum of all organisms
+ * a stopped organism's fitness is only known to be in [lowest, bound],
+ * and unresolved() gives stopped organisms to be evaluated to the end
+ * until the offspring counts of species are the same
+ * whatever fitness in their ranges the others have,
+ * i.e. the same as if all had been evaluated to the end
+ * organisms are evaluated in a single thread
+ * initialization list: population to evaluate, winner fitness
+ */
+namespace eSpinn {
+    class SurvivalCutoff
+    {
+    private:
+        /* data */
+        typedef std::priority_queue<double, std::vector<double>,
+            std::greater<double>> minHeap;
+        // top fitness values & num of survivors of each species
+        std::vector<minHeap> top;
+        std::vector<eSpinn_size> num_survivors;
+        std::unordered_map<const OrganismBase*, eSpinn_size> species_of;
+        // fitness ranges of stopped organisms not evaluated to the end
+        std::unordered_map<const OrganismBase*, std::pair<double, double>> ranges;
+        const Population *pop;
+        double winner_fit;
+        eSpinn_size num_stopped, num_finished;
+    public:
+        /* @brief: constructor */
+        SurvivalCutoff(const Population &pop, const double &winner);
+
+        /* @brief: get the fitness organism o has to reach to survive or win
+         * its evaluation can stop once its fitness bound is below it
+         */
+        const double threshold(const OrganismBase *o) const;
+
+        /* @brief: record the fitness of an evaluated organism */
+        void record(const OrganismBase *o, const double &fit);
+
+        /* @brief: record an organism whose evaluation stopped early
+         * its fitness is in [lowest, bound]
+         */
+        void stopped(const OrganismBase *o, const double &lowest, const double &bound);
+
+        /* @brief: get a stopped organism to be evaluated to the end
+         * nullptr if offspring counts are the same as with full evaluations
+         */
+        OrganismBase* unresolved() const;
+
+        /* @brief: record that stopped organism o is evaluated to the end */
+        void finished(const OrganismBase *o);
+
+        /* @brief: get num of organisms whose evaluation stopped early */
+        inline const eSpinn_size get_stopped() const { return num_stopped; }
+
+        /* @brief: get num of stopped organisms evaluated to the end */
+        inline const eSpinn_size get_finished() const { return num_finished; }
+    };
+}
@@ -0,0 +1,192 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <utility>
+using namespace eSpinn;
+
+
+/* @brief: start recording an episode of org
+ * org is at position p of the evaluated organisms
+ */
+void Trace::begin(const OrganismBase *o, const eSpinn_size &p,
+    const eSpinn_size &w, const eSpinn_size &cap)
+{
+    org = o;
+    pos = p;
+    width = w;
+    capacity = cap;
+    num = 0;
+}
+
+
+/* @brief: get the next row to be written,
+ * overwriting the oldest one if the buffer is full
+ * the buffer grows to the rows needed, up to capacity rows
+ */
+double *Trace::next_row() {
+    const auto r = num++ % capacity;
+    if (rows.size() < (r + 1) * width)
+        rows.resize((r + 1) * width);
+    return rows.data() + r * width;
+}
+
+
+/* @brief: get num of rows kept */
+const eSpinn_size Trace::length() const {
+    return std::min(num, capacity);
+}
+
+
+/* @brief: get num of the earliest rows overwritten */
+const eSpinn_size Trace::get_skipped() const {
+    return num - length();
+}
+
+
+/* @brief: get value of column col at the ts-th row kept */
+const double Trace::at(const eSpinn_size &ts, const eSpinn_size &col) const {
+    return rows[((get_skipped() + ts) % capacity) * width + col];
+}
+
+
+/* @brief: save columns [first, first+n) to file, a row per line
+ * the num of columns is written first if header
+ */
+bool Trace::save(const std::string &ofile, const eSpinn_size &first,
+    const eSpinn_size &n, const bool &header) const
+{
+    if (first + n > width) {
+        std::cerr << BnR_ERROR << "columns out of range of the trace" << std::endl;
+        return false;
+    }
+    std::ofstream ofs(ofile);
+    if (!ofs) {
+        std::cerr << BnR_ERROR << "can't open file " << ofile << std::endl;
+        return false;
+    }
+    if (header)
+        ofs << n << '\n';
+    for (eSpinn_size ts = 0; ts < length(); ++ts) {
+        for (eSpinn_size c = first; c < first + n; ++c)
+            ofs << at(ts, c) << (c + 1 < first + n ? ' ' : '\n');
+    }
+    ofs.close();
+    return true;
+}
+
+
+/* @brief: constructor */
+TraceRecorder::TraceRecorder(const eSpinn_size &cap, const eSpinn_size &n) :
+    capacity(cap), slots(n), on(n, 0), best(),
+    best_fit(-std::numeric_limits<double>::infinity()) { }
+
+
+/* @brief: set max num of rows kept per trace
+ * 0 disables recording
+ */
+void TraceRecorder::set_capacity(const eSpinn_size &cap) {
+    capacity = cap;
+    clear();
+}
+
+
+/* @brief: set num of slots, i.e. episodes recorded at the same time
+ * buffers of existing slots are kept
+ */
+void TraceRecorder::set_slots(const eSpinn_size &n) {
+    slots.resize(n);
+    on.assign(n, 0);
+}
+
+
+/* @brief: forget the kept trace, e.g. before evaluating a generation */
+void TraceRecorder::clear() {
+    best.begin(nullptr, 0, 0, 0);
+    best_fit = -std::numeric_limits<double>::infinity();
+    std::fill(on.begin(), on.end(), 0);
+}
+
+
+/* @brief: check if trace of fitness fit at position pos
+ * is better than the kept one
+ */
+bool TraceRecorder::better(const double &fit, const eSpinn_size &pos) const {
+    if (!best.get_org())
+        return true;
+    return fit > best_fit || (fit == best_fit && pos < best.get_pos());
+}
+
+
+/* @brief: start recording org in slot s
+ * org is at position pos of the evaluated organisms,
+ * rows are of w values
+ */
+void TraceRecorder::begin(const eSpinn_size &s, const OrganismBase *org,
+    const eSpinn_size &pos, const eSpinn_size &w)
+{
+    if (!capacity || !w)
+        return;
+    slots[s].begin(org, pos, w, capacity);
+    on[s] = 1;
+}
+
+
+/* @brief: get the next row of slot s to be written
+ * return nullptr if slot s is not recording
+ */
+double *TraceRecorder::next_row(const eSpinn_size &s) {
+    return on[s] ? slots[s].next_row() : nullptr;
+}
+
+
+/* @brief: stop recording slot s */
+void TraceRecorder::drop(const eSpinn_size &s) {
+    on[s] = 0;
+}
+
+
+/* @brief: stop recording slot s if its organism,
+ * whose fitness will be at most fit_bound, can't beat the kept trace
+ */
+void TraceRecorder::drop_below(const eSpinn_size &s, const double &fit_bound) {
+    if (on[s] && !better(fit_bound, slots[s].get_pos()))
+        on[s] = 0;
+}
+
+
+/* @brief: finish recording slot s of fitness fit
+ * keep the trace if it's better,
+ * the buffer of the replaced trace is reused by the slot
+ */
+void TraceRecorder::end(const eSpinn_size &s, const double &fit) {
+    if (!on[s])
+        return;
+    on[s] = 0;
+    if (better(fit, slots[s].get_pos())) {
+        std::swap(best, slots[s]);
+        best_fit = fit;
+    }
+}
+
+
+/* @brief: take the kept trace of r if it's better, e.g. of another worker */
+void TraceRecorder::merge(TraceRecorder &r) {
+    if (r.best.get_org() && better(r.best_fit, r.best.get_pos())) {
+        std::swap(best, r.best);
+        best_fit = r.best_fit;
+    }
+    r.clear();
+}
+
+
+/* @brief: check if the kept trace is of org */
+bool TraceRecorder::has(const OrganismBase *org) const {
+    return org && best.get_org() == org;
+}
@@ -0,0 +1,158 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "OrganismBase.h"
+#include <string>
+#include <vector>
+
+/* @brief: Trace
+ * rows of values an organism produced every time slot of an episode,
+ * e.g. plant states, controller outputs & connection weights
+ * rows are kept in a ring buffer of capacity rows,
+ * i.e. the latest capacity rows of a longer episode are kept
+ * the buffer grows as rows are recorded and is reused by the next episode
+ */
+namespace eSpinn {
+    class Trace
+    {
+    private:
+        /* data */
+        std::vector<double> rows;
+        eSpinn_size width;    // num of values per row
+        eSpinn_size capacity; // max num of rows kept
+        eSpinn_size num;      // num of rows recorded
+        const OrganismBase *org;
+        eSpinn_size pos;      // position of org in the evaluation
+    public:
+        /* @brief: constructor */
+        Trace() : rows(), width(0), capacity(0), num(0), org(nullptr), pos(0) { }
+
+        /* @brief: start recording an episode of org
+         * org is at position p of the evaluated organisms
+         */
+        void begin(const OrganismBase *o, const eSpinn_size &p,
+            const eSpinn_size &w, const eSpinn_size &cap);
+
+        /* @brief: get the next row to be written,
+         * overwriting the oldest one if the buffer is full
+         */
+        double *next_row();
+
+        /* @brief: get the traced organism */
+        inline const OrganismBase *get_org() const { return org; }
+
+        /* @brief: get position of the traced organism in the evaluation */
+        inline const eSpinn_size get_pos() const { return pos; }
+
+        /* @brief: get num of values per row */
+        inline const eSpinn_size get_width() const { return width; }
+
+        /* @brief: get num of rows kept */
+        const eSpinn_size length() const;
+
+        /* @brief: get num of the earliest rows overwritten */
+        const eSpinn_size get_skipped() const;
+
+        /* @brief: get value of column col at the ts-th row kept */
+        const double at(const eSpinn_size &ts, const eSpinn_size &col) const;
+
+        /* @brief: save columns [first, first+n) to file, a row per line
+         * the num of columns is written first if header
+         */
+        bool save(const std::string &ofile, const eSpinn_size &first,
+            const eSpinn_size &n, const bool &header = false) const;
+    };
+
+
+    /* @brief: TraceRecorder
+     * record traces of organisms while they are being evaluated
+     * and keep the one of the best organism, i.e. the champion's,
+     * so the champion's logs come from the episode that produced its fitness
+     * instead of re-running it
+     * episodes in flight are recorded in slots,
+     * a slot is dropped as soon as its organism can't beat the kept trace,
+     * finished ones replace the kept trace if better, or are discarded,
+     * of organisms of the same fitness the earliest positioned is kept,
+     * the same as Population::get_champ_org()
+     * recording is disabled if capacity is 0
+     * initialization list: capacity of traces, num of slots
+     */
+    class TraceRecorder
+    {
+    private:
+        /* data */
+        eSpinn_size capacity;
+        std::vector<Trace> slots;
+        std::vector<char> on; // 1 if slot is recording
+        Trace best;
+        double best_fit;
+
+        /* @brief: check if trace of fitness fit at position pos
+         * is better than the kept one
+         */
+        bool better(const double &fit, const eSpinn_size &pos) const;
+    public:
+        /* @brief: constructor */
+        TraceRecorder(const eSpinn_size &cap = 0, const eSpinn_size &n = 1);
+
+        /* @brief: set max num of rows kept per trace
+         * 0 disables recording
+         */
+        void set_capacity(const eSpinn_size &cap);
+
+        /* @brief: get max num of rows kept per trace */
+        inline const eSpinn_size get_capacity() const { return capacity; }
+
+        /* @brief: check if recording is enabled */
+        inline bool isenabled() const { return capacity; }
+
+        /* @brief: set num of slots, i.e. episodes recorded at the same time */
+        void set_slots(const eSpinn_size &n);
+
+        /* @brief: get num of slots */
+        inline const eSpinn_size num_slots() const { return slots.size(); }
+
+        /* @brief: forget the kept trace, e.g. before evaluating a generation */
+        void clear();
+
+        /* @brief: start recording org in slot s
+         * org is at position pos of the evaluated organisms,
+         * rows are of w values
+         */
+        void begin(const eSpinn_size &s, const OrganismBase *org,
+            const eSpinn_size &pos, const eSpinn_size &w);
+
+        /* @brief: get the next row of slot s to be written
+         * return nullptr if slot s is not recording
+         */
+        double *next_row(const eSpinn_size &s);
+
+        /* @brief: stop recording slot s */
+        void drop(const eSpinn_size &s);
+
+        /* @brief: stop recording slot s if its organism,
+         * whose fitness will be at most fit_bound, can't beat the kept trace
+         */
+        void drop_below(const eSpinn_size &s, const double &fit_bound);
+
+        /* @brief: finish recording slot s of fitness fit
+         * keep the trace if it's better
+         */
+        void end(const eSpinn_size &s, const double &fit);
+
+        /* @brief: take the kept trace of r if it's better, e.g. of another worker */
+        void merge(TraceRecorder &r);
+
+        /* @brief: check if the kept trace is of org */
+        bool has(const OrganismBase *org) const;
+
+        /* @brief: get the kept trace */
+        inline const Trace &get_trace() const { return best; }
+    };
+}
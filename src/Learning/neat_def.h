@@ -29,6 +29,9 @@ namespace eSpinn {
         const double survival_thresh = 0.2;
         const eSpinn_size dropoff_age = 15;
         constexpr eSpinn_size stagnant_gen = 12;
+        // expected offspring this close below an integer are rounded up,
+        // so counts don't depend on rounding errors of fitness sums
+        constexpr double offspring_tol = 1e-9;
 
         const double compat_threshold = 3.0;
         const double disjoint_coeff = 1.0;
@@ -37,6 +40,10 @@ namespace eSpinn {
         const double delaydiff_coeff = 0.1;
         const double lambdadiff_coeff = 0.1;
 
+        // ids of innovations created during reproduction start from here
+        // until they are merged into the population
+        constexpr unsigned int temp_id_base = 1u << 31;
+
         constexpr double mutate_only_prob = 0.5;
         constexpr double mate_within_species_rate = 0.8;
 
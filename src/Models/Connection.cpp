@@ -206,18 +206,32 @@ void Connection::setEnable(const bool &status) {
 }
 
 
-/* @brief: push output from in_node */
+/* @brief: push output from in_node
+ * the receptor keeps the latest synapse_delay outputs,
+ * or none if it doesn't have synapse_delay outputs with r
+ * the storage is kept, so pushing doesn't allocate memory once it's warmed up
+ */
 void Connection::pushReceptor(const double &r) {
-    receptor.push_front(r);
-    while(!receptor.empty() && receptor.size() != synapse_delay){
-        receptor.pop_back();
-    }    
+    if (!synapse_delay || receptor.size() + 1 < synapse_delay) {
+        receptor.clear();
+        return;
+    }
+    if (receptor.size() >= synapse_delay)
+        receptor.erase(receptor.begin(), receptor.end() - (synapse_delay - 1));
+    receptor.push_back(r);
+}
+
+
+/* @brief: clear receptor */
+void Connection::clearReceptor() {
+    receptor.clear();
 }
 
+
 /* @brief: get the delayed recent receptor */
 const double Connection::getRecentReceptor() const {
     if (receptor.size())
-        return receptor.back();
+        return receptor.front();
     else {
         #ifdef ESPINN_VERBOSE
         std::cerr << "Connection receptor from neuron #" << getInodeID() 
@@ -10,7 +10,7 @@
 #include "HebbPlasticity.h"
 #include "Utilities/Utilities.h"
 #include <iostream>
-#include <deque>
+#include <vector>
 #include <cassert>
 #include <boost/serialization/access.hpp>
 
@@ -64,7 +64,7 @@ namespace eSpinn {
         bool enable;
         connType c_type;
         HebbianType hebb;
-        std::deque<double> receptor; // archive outputs from in_node
+        std::vector<double> receptor; // archive outputs from in_node, the latest last
 
         /* @brief: print class info 
          * do the major printing here
@@ -88,8 +88,8 @@ namespace eSpinn {
         c_id(cid), in_node(inn), out_node(outn), 
         weight(w), weight_pre(w), synapse_delay(d), enable(en), c_type(ct),
         hebb(h),
-        // create a new empty std::deque<double> and assign to pointer receptor
-        receptor(std::deque<double>()) 
+        // create a new empty receptor
+        receptor() 
         , plastic_module()
         {
             #ifdef ESPINN_MAX_WEIGHT
@@ -120,7 +120,7 @@ namespace eSpinn {
         weight(conn.weight), weight_pre(conn.weight),
         synapse_delay(conn.synapse_delay),
         enable(conn.enable), c_type(conn.c_type), hebb(conn.hebb),
-        receptor(std::deque<double>()) 
+        receptor() 
         , plastic_module(conn.plastic_module)
         {
             #ifdef ESPINN_VERBOSE
@@ -232,6 +232,9 @@ namespace eSpinn {
         /* @brief: push output from in_node */
         void pushReceptor(const double &r);
 
+        /* @brief: clear receptor */
+        void clearReceptor();
+
         /* @brief: get the delayed recent receptor */
         const double getRecentReceptor() const;
     };
@@ -4,6 +4,7 @@
 
 
 #include "Network.h"
+#include <unordered_map>
 using namespace eSpinn;
 
 
@@ -153,7 +154,79 @@ Network<Ti, Th, To>::Network(const netID &nid,
 }
 
 
-/* copy constructor 
+/* @brief: build the phenotype of a genome
+ * neurons & connections are created from the genes
+ */
+template <typename Ti, typename Th, typename To>
+Network<Ti, Th, To>::Network(const netID &nid, const Genome &g) :
+    NetworkBase(nid),
+    neurons(), inp_neurons(), hid_neurons(), outp_neurons(),
+    connections(), outputs(), comment("network built from genome")
+{
+    #ifdef ESPINN_VERBOSE
+    std::cout << std::endl << comment << std::endl;
+    #endif
+
+    /* create neurons
+     * genes are ordered as inputs, hiddens & outputs
+     */
+    const auto &t = g.topology();
+    neurons.reserve(g.neuron_size());
+    std::unordered_map<neuronID, Neuron*> by_id;
+    eSpinn_size i = 0;
+    for (; i < t.inp_size; ++i) {
+        auto innode = new Ti(t.neuron_id[i], L_INPUT);
+        innode->setSeq(0);
+        innode->setType(t.neuron_type[i]);
+        set_neuron_param(innode, g.neuron_param[i]);
+        neurons.push_back(innode);
+        inp_neurons.push_back(innode);
+    }
+    for (eSpinn_size s = 1; i < t.inp_size + t.hid_size; ++i) {
+        auto hidnode = new Th(t.neuron_id[i], L_HIDDEN);
+        hidnode->setSeq(s++);
+        hidnode->setType(t.neuron_type[i]);
+        set_neuron_param(hidnode, g.neuron_param[i]);
+        neurons.push_back(hidnode);
+        hid_neurons.push_back(hidnode);
+    }
+    for (; i < g.neuron_size(); ++i) {
+        auto outnode = new To(t.neuron_id[i], L_OUTPUT);
+        outnode->setSeq(-1);
+        outnode->setType(t.neuron_type[i]);
+        set_neuron_param(outnode, g.neuron_param[i]);
+        neurons.push_back(outnode);
+        outp_neurons.push_back(outnode);
+    }
+    for (auto &n : neurons)
+        by_id[n->getID()] = n;
+
+    /* create connections
+     * genes are sorted by id so are the connections
+     */
+    connections.reserve(g.conn_size());
+    for (i = 0; i < g.conn_size(); ++i) {
+        Neuron *innode = by_id.at(t.conn_in[i]);
+        Neuron *outnode = by_id.at(t.conn_out[i]);
+        Connection *conn;
+        if (t.conn_type[i] == SPIKECONN)
+            conn = new SpikeConnection(t.conn_id[i], innode, outnode,
+                g.weight[i], g.delay[i], g.enable[i]);
+        else
+            conn = new Connection(t.conn_id[i], innode, outnode,
+                g.weight[i], g.delay[i], g.enable[i]);
+        conn->set_hebb_type(g.hebb[i]);
+        conn->set_plastic_term(g.plastic[0][i], 0);
+        conn->set_plastic_term(g.plastic[1][i], 1);
+        connections.push_back(conn);
+
+        innode->add_outConn(conn);
+        outnode->add_inConn(conn);
+    }
+}
+
+
+/* copy constructor
  * first create copies of neurons and connections
  * do NOT just copy the vector - they are pointers
  * copy the instances the pointers point at
@@ -198,27 +271,24 @@ Network<Ti, Th, To>::Network(const Network &net) : NetworkBase(net),
     // which belong to the constructor parameter &net,
     // so we need to reconfigure it later
 
-    /* set connections and neurons */
+    /* set connections and neurons
+     * neurons are looked up by their ids
+     */
+    std::unordered_map<neuronID, Neuron*> by_id;
+    for (auto &n : neurons)
+        by_id[n->getID()] = n;
     for (auto &c : connections) {
-        bool ifound(false), ofound(false);
-        for (auto &n : neurons) {
-            if (n->getID() == c->getInodeID()) {
-                c->setInode(n); // re-assign this->node to Connection in_node
-                n->add_outConn(c);
-                ifound = true;
-            }
-            if (n->getID() == c->getOnodeID()) {
-                c->setOnode(n); // re-assign this->node to Connection in_node
-                n->add_inConn(c);
-                ofound = true;
-            }
-            if (ifound && ofound)
-                break;
-        }
-        if (!ifound || !ofound) {
+        auto in = by_id.find(c->getInodeID());
+        auto out = by_id.find(c->getOnodeID());
+        if (in == by_id.end() || out == by_id.end()) {
             std::cerr << BnR_ERROR 
             << "Failed to find connection neurons!" << std::endl; // TODO
+            continue;
         }
+        c->setInode(in->second); // re-assign this->node to Connection in_node
+        in->second->add_outConn(c);
+        c->setOnode(out->second); // re-assign this->node to Connection out_node
+        out->second->add_inConn(c);
     }
 }
 
@@ -252,6 +322,97 @@ Network<Ti, Th, To>* Network<Ti, Th, To>::duplicate(const netID n) {
 }
 
 
+/* @brief: encode network into a genome
+ * the storage of the genome is reused
+ */
+template<typename Ti, typename Th, typename To>
+void Network<Ti, Th, To>::encode(Genome &g) const {
+    g.clear();
+    for (auto &n : inp_neurons) {
+        g.push_neuron(n->getID(), L_INPUT, n->getType(), get_neuron_param(n));
+    }
+    for (auto &n : hid_neurons) {
+        g.push_neuron(n->getID(), L_HIDDEN, n->getType(), get_neuron_param(n));
+    }
+    for (auto &n : outp_neurons) {
+        g.push_neuron(n->getID(), L_OUTPUT, n->getType(), get_neuron_param(n));
+    }
+    for (auto &c : connections) {
+        g.push_conn(c->getID(), c->getInodeID(), c->getOnodeID(),
+            c->getWeight(), c->getDelay(), c->isEnable(),
+            c->getType(), c->get_hebb_type(),
+            c->get_plastic_term(0), c->get_plastic_term(1));
+    }
+    g.intern();
+}
+
+
+/* @brief: update the network from a genome of the same topology
+ * parameters are copied from the genes and runtime states are reset
+ * so the network behaves the same as a newly-built phenotype
+ * return false (and change nothing) if the topology differs
+ */
+template<typename Ti, typename Th, typename To>
+bool Network<Ti, Th, To>::refresh(const Genome &g) {
+    // compare neuron genes, including the order of hidden neurons
+    const auto &t = g.topology();
+    if (t.inp_size != get_inp_size() || t.hid_size != get_hid_size() ||
+        t.outp_size != get_outp_size() || g.conn_size() != get_connection_size())
+        return false;
+    for (eSpinn_size i = 0; i < g.neuron_size(); ++i) {
+        if (neurons[i]->getID() != t.neuron_id[i] ||
+            neurons[i]->getType() != t.neuron_type[i])
+            return false;
+    }
+    // compare connection genes
+    for (eSpinn_size i = 0; i < g.conn_size(); ++i) {
+        auto c = connections[i];
+        if (c->getID() != t.conn_id[i] || c->getType() != t.conn_type[i] ||
+            c->getInodeID() != t.conn_in[i] || c->getOnodeID() != t.conn_out[i])
+            return false;
+    }
+    refresh_params(g);
+    return true;
+}
+
+
+/* @brief: update the network from a genome known to be of the same topology
+ * parameters are copied from the genes and runtime states are reset
+ */
+template<typename Ti, typename Th, typename To>
+void Network<Ti, Th, To>::refresh_params(const Genome &g) {
+    eSpinn_size i = 0;
+    for (auto &n : inp_neurons)
+        set_neuron_param(n, g.neuron_param[i++]);
+    for (auto &n : hid_neurons)
+        set_neuron_param(n, g.neuron_param[i++]);
+    for (auto &n : outp_neurons)
+        set_neuron_param(n, g.neuron_param[i++]);
+    for (i = 0; i < g.conn_size(); ++i) {
+        auto c = connections[i];
+        c->setWeight(g.weight[i]);
+        c->backupWeight();
+        c->setDelay(g.delay[i]);
+        c->setEnable(g.enable[i]);
+        c->set_hebb_type(g.hebb[i]);
+        c->set_plastic_term(g.plastic[0][i], 0);
+        c->set_plastic_term(g.plastic[1][i], 1);
+    }
+    reset();
+}
+
+
+/* @brief: reset runtime states of neurons & connections */
+template<typename Ti, typename Th, typename To>
+void Network<Ti, Th, To>::reset() {
+    for (auto &n : neurons)
+        n->reset();
+    for (auto &c : connections)
+        c->clearReceptor();
+    outputs.clear();
+}
+
+
 /* @brief: settings after loading network using serialization
  * add connections to neurons & copy pointers to neurons
  */
@@ -335,6 +496,16 @@ const std::vector<double> Network<Ti, Th, To>::get_connection_weights() const {
     return w;
 }
 
+/* @brief: write connection weights to w[0 ... connection size)
+ * without allocating, e.g. to record them every time slot
+ */
+template<typename Ti, typename Th, typename To>
+void Network<Ti, Th, To>::get_connection_weights(double *w) const {
+    for (auto &c : connections) {
+        *w++ = c->getWeight();
+    }
+}
+
 /* @brief: back up connection weights */
 template<typename Ti, typename Th, typename To>
 void Network<Ti, Th, To>::backup_connection_weights() {
@@ -16,6 +16,7 @@
 #include "Connection.h"
 #include "SpikeConnection.h"
 #include "NetworkBase.h"
+#include "Learning/Genome.h"
 // #include "Learning/Organism.h"
 // use friend-injection flag in cmake to remove this dependency
 
@@ -27,6 +28,16 @@
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/vector.hpp>
 
+/* @brief: get the evolvable neuron parameter
+ * i.e. lambda of sigmoid neurons, other neurons have none
+ */
+namespace eSpinn {
+    inline double get_neuron_param(const Neuron *n) { return .0; }
+    inline double get_neuron_param(const SigmNeuron *n) { return n->getLambda(); }
+    inline void set_neuron_param(Neuron *n, const double &p) { }
+    inline void set_neuron_param(SigmNeuron *n, const double &p) { n->setLambda(p); }
+}
+
 /* @brief: Network class
  * with 3 layer neurons
  * initialization list: net id, neuron type, neuron num ... 
@@ -91,6 +102,10 @@ namespace eSpinn {
          */
         std::ostream& print(std::ostream &os) const override;
     public:
+        typedef Ti inp_type;
+        typedef Th hid_type;
+        typedef To outp_type;
+
         std::string comment;
 
         /* @brief: build a 3-layer network
@@ -107,6 +122,11 @@ namespace eSpinn {
          */
         Network() : Network(0) { }
 
+        /* @brief: build the phenotype of a genome
+         * neurons & connections are created from the genes
+         */
+        Network(const netID &nid, const Genome &g);
+
         /* @brief: copy construct a network
          * neurons & connections are newly-created copies
          */
@@ -125,6 +145,26 @@ namespace eSpinn {
         /* @brief: duplicate this network with a new id */
         Network* duplicate(const netID n);
 
+        /* @brief: encode network into a genome
+         * the storage of the genome is reused
+         */
+        void encode(Genome &g) const;
+
+        /* @brief: update the network from a genome of the same topology
+         * parameters are copied from the genes and runtime states are reset
+         * so the network behaves the same as a newly-built phenotype
+         * return false (and change nothing) if the topology differs
+         */
+        bool refresh(const Genome &g);
+
+        /* @brief: update the network from a genome known to be of the same topology
+         * parameters are copied from the genes and runtime states are reset
+         */
+        void refresh_params(const Genome &g);
+
+        /* @brief: reset runtime states of neurons & connections */
+        void reset();
+
         /* @brief: settings after loading network using serialization
          * add connections to neurons & copy pointers to neurons
          */
@@ -157,6 +197,11 @@ namespace eSpinn {
         /* @brief: get connection weights */
         const std::vector<double> get_connection_weights() const override;
 
+        /* @brief: write connection weights to w[0 ... connection size)
+         * without allocating, e.g. to record them every time slot
+         */
+        void get_connection_weights(double *w) const;
+
         /* @brief: back up connection weights */
         void backup_connection_weights();
 
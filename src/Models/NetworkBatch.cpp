@@ -0,0 +1,244 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "NetworkBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <unordered_map>
+using namespace eSpinn;
+
+
+/* @brief: check if the genome can be run in a batch
+ * the topology must be interned and hidden neurons rate-based,
+ * connections can't be plastic and must be of ONE timestep delay
+ */
+template <typename T>
+bool NetworkBatch<T>::batchable(const Genome &g) {
+    if (!g.shared_topology())
+        return false;
+    if (!std::is_same<typename T::hid_type, SigmNeuron>::value
+        && g.topology().hid_size)
+        return false;
+    for (eSpinn_size i = 0; i < g.conn_size(); ++i) {
+        if (g.hebb[i] != NoHebbian || g.delay[i] != 1)
+            return false;
+    }
+    return true;
+}
+
+
+/* @brief: group batchable genomes by their interned topology
+ * return positions of genomes in each group,
+ * positions of the other genomes are pushed to rest
+ */
+template <typename T>
+std::vector<std::vector<eSpinn_size>> NetworkBatch<T>::group(
+    const std::vector<const Genome*> &genomes, std::vector<eSpinn_size> &rest)
+{
+    std::vector<std::vector<eSpinn_size>> groups;
+    std::unordered_map<const Topology*, eSpinn_size> by_topo;
+    for (eSpinn_size i = 0; i < genomes.size(); ++i) {
+        if (!batchable(*genomes[i])) {
+            rest.push_back(i);
+            continue;
+        }
+        auto t = genomes[i]->shared_topology().get();
+        auto found = by_topo.find(t);
+        if (found == by_topo.end()) {
+            by_topo[t] = groups.size();
+            groups.push_back(std::vector<eSpinn_size>{i});
+        }
+        else
+            groups[found->second].push_back(i);
+    }
+    return groups;
+}
+
+
+/* @brief: constructor
+ * all genomes must be batchable and share one interned topology
+ * incoming connections of each neuron are kept in the order of connection ids,
+ * the same order as the phenotype accumulates synaptic inputs
+ */
+template <typename T>
+NetworkBatch<T>::NetworkBatch(const std::vector<const Genome*> &genomes) :
+    topo(genomes.empty() ? nullptr : genomes.front()->shared_topology()),
+    batch(genomes.size()), inp_size(0), outp_size(0), shared(false),
+    in_begin(), in_src(), weight(), lambda(), val(), acc(batch)
+{
+    if (!topo) {
+        std::cerr << BnR_ERROR << "Can't batch genomes of no interned topology" << std::endl;
+        batch = 0;
+        return;
+    }
+    for (auto &g : genomes) {
+        if (g->shared_topology() != topo || !batchable(*g)) {
+            std::cerr << BnR_ERROR << "Can't batch genomes of different topologies" << std::endl;
+            topo = nullptr;
+            batch = 0;
+            return;
+        }
+    }
+    auto &t = *topo;
+    auto n_size = t.neuron_id.size(), c_size = t.conn_id.size();
+    inp_size = t.inp_size;
+    outp_size = t.outp_size;
+
+    std::unordered_map<neuronID, eSpinn_size> pos;
+    for (eSpinn_size n = 0; n < n_size; ++n)
+        pos[t.neuron_id[n]] = n;
+
+    // bucket connections by their target neuron, stable in id order
+    std::vector<eSpinn_size> target(c_size);
+    in_begin.assign(n_size + 1, 0);
+    for (eSpinn_size c = 0; c < c_size; ++c) {
+        target[c] = pos.at(t.conn_out[c]);
+        ++in_begin[target[c] + 1];
+    }
+    for (eSpinn_size n = 0; n < n_size; ++n)
+        in_begin[n+1] += in_begin[n];
+    std::vector<eSpinn_size> slot(in_begin.begin(), in_begin.end() - 1);
+    std::vector<eSpinn_size> order(c_size);
+    in_src.resize(c_size);
+    for (eSpinn_size c = 0; c < c_size; ++c) {
+        auto s = slot[target[c]]++;
+        order[s] = c;
+        in_src[s] = pos.at(t.conn_in[c]);
+    }
+
+    // stack parameters with the batch as the innermost dimension
+    weight.resize(c_size * batch);
+    for (eSpinn_size s = 0; s < c_size; ++s) {
+        for (eSpinn_size b = 0; b < batch; ++b)
+            weight[s*batch + b] = genomes[b]->weight[order[s]];
+    }
+    lambda.resize(n_size * batch);
+    for (eSpinn_size n = 0; n < n_size; ++n) {
+        for (eSpinn_size b = 0; b < batch; ++b)
+            lambda[n*batch + b] = genomes[b]->neuron_param[n];
+    }
+    val.assign(n_size * batch, .0);
+}
+
+
+/* @brief: constructor of n copies of the network of genome
+ * the genome must be batchable, parameters are shared,
+ * i.e. they are stacked as a batch of one
+ */
+template <typename T>
+NetworkBatch<T>::NetworkBatch(const Genome &genome, const eSpinn_size &n) :
+    NetworkBatch(std::vector<const Genome*>{&genome})
+{
+    if (!topo)
+        return;
+    batch = n;
+    shared = true;
+    val.assign(topo->neuron_id.size() * batch, .0);
+    acc.assign(batch, .0);
+}
+
+
+/* @brief: reset all networks */
+template <typename T>
+void NetworkBatch<T>::reset() {
+    std::fill(val.begin(), val.end(), .0);
+}
+
+
+/* @brief: accumulate synaptic inputs of neuron n over the batch
+ * sources not forwarded yet in this time slot give their last outputs,
+ * the same as the receptors of the phenotype
+ * a shared weight is broadcast over the batch
+ */
+static inline void accumulate(const eSpinn_size &n, const eSpinn_size &batch,
+    const std::vector<eSpinn_size> &in_begin, const std::vector<eSpinn_size> &in_src,
+    const std::vector<double> &weight, const std::vector<double> &val,
+    std::vector<double> &acc, const bool &shared)
+{
+    auto a = acc.data();
+    std::fill(acc.begin(), acc.end(), .0);
+    for (auto s = in_begin[n]; s < in_begin[n+1]; ++s) {
+        auto v = &val[in_src[s]*batch];
+        if (shared) {
+            const auto w = weight[s];
+            for (eSpinn_size b = 0; b < batch; ++b)
+                a[b] += w * v[b];
+            continue;
+        }
+        auto w = &weight[s*batch];
+        for (eSpinn_size b = 0; b < batch; ++b)
+            a[b] += w[b] * v[b];
+    }
+}
+
+
+/* @brief: activate neuron n over the batch
+ * sigmoid or linear (capped within [-1.0, 1.0]) by the neuron type
+ * a shared lambda is broadcast over the batch
+ */
+template <typename N>
+static inline void activate(const eSpinn_size &n, const eSpinn_size &batch,
+    const std::vector<double> &lambda, const std::vector<double> &acc,
+    std::vector<double> &val, const bool &shared)
+{
+    auto v = &val[n*batch];
+    if (std::is_same<N, SigmNeuron>::value && shared) {
+        const auto l = lambda[n];
+        for (eSpinn_size b = 0; b < batch; ++b)
+            v[b] = 1 / (1+std::exp(-acc[b]*l));
+    }
+    else if (std::is_same<N, SigmNeuron>::value) {
+        auto l = &lambda[n*batch];
+        for (eSpinn_size b = 0; b < batch; ++b)
+            v[b] = 1 / (1+std::exp(-acc[b]*l[b]));
+    }
+    else {
+        for (eSpinn_size b = 0; b < batch; ++b)
+            v[b] = acc[b] > 1.0 ? 1.0 : (acc[b] < -1.0 ? -1.0 : acc[b]);
+    }
+}
+
+
+/* @brief: run all networks for ONE time slot
+ * inputs of network b are inps[b*inp_size ...]
+ * outputs of network b are written to outps[b*outp_size ...]
+ * neurons are forwarded in the same sequence as Network::run()
+ */
+template <typename T>
+void NetworkBatch<T>::run(const double *inps, double *outps) {
+    if (!topo)
+        return;
+    auto n_size = topo->neuron_id.size();
+    auto hid_end = inp_size + topo->hid_size;
+
+    for (eSpinn_size n = 0; n < inp_size; ++n) {
+        auto v = &val[n*batch];
+        for (eSpinn_size b = 0; b < batch; ++b) {
+            auto x = inps[b*inp_size + n];
+            v[b] = x > 1.0 ? 1.0 : (x < -1.0 ? -1.0 : x);
+        }
+    }
+    for (auto n = inp_size; n < hid_end; ++n) {
+        accumulate(n, batch, in_begin, in_src, weight, val, acc, shared);
+        activate<typename T::hid_type>(n, batch, lambda, acc, val, shared);
+    }
+    for (auto n = hid_end; n < n_size; ++n) {
+        accumulate(n, batch, in_begin, in_src, weight, val, acc, shared);
+        activate<typename T::outp_type>(n, batch, lambda, acc, val, shared);
+    }
+
+    for (eSpinn_size b = 0; b < batch; ++b) {
+        for (eSpinn_size o = 0; o < outp_size; ++o)
+            outps[b*outp_size + o] = val[(hid_end+o)*batch + b];
+    }
+}
+
+
+/* @brief: explicit instantiation */
+template class eSpinn::NetworkBatch<SigmNetwork>;
+template class eSpinn::NetworkBatch<LinrNetwork>;
+template class eSpinn::NetworkBatch<HybridNetwork>;
+template class eSpinn::NetworkBatch<HybLinNetwork>;
@@ -0,0 +1,92 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include "eSpinn_def.h"
+#include "Network.h"
+#include "Learning/Genome.h"
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/* @brief: NetworkBatch
+ * run a group of rate-based networks of the same topology in lockstep
+ * networks are built directly from genomes sharing an interned topology
+ * parameters are stacked with the batch as the innermost dimension,
+ * i.e. weights are a [connection x batch] matrix,
+ * so one time slot of the whole group is a batched matrix product
+ * followed by a vectorized activation
+ * the results are the same as running each Network<T> on its own
+ * a batch can also be copies of ONE network, e.g. for episodes run in lockstep,
+ * whose parameters are shared and only neuron values are replicated
+ * supported networks are those of rate-based (sigmoid) or no hidden neurons,
+ * with non-plastic connections of ONE timestep delay
+ */
+namespace eSpinn {
+    template <typename T>
+    class NetworkBatch
+    {
+    private:
+        /* data */
+        std::shared_ptr<const Topology> topo;
+        eSpinn_size batch;
+        eSpinn_size inp_size, outp_size;
+        bool shared; // parameters are shared by the batch
+        std::vector<eSpinn_size> in_begin; // incoming connections of neuron n
+        std::vector<eSpinn_size> in_src;   // are [in_begin[n], in_begin[n+1])
+        std::vector<double> weight; // [incoming connection][batch], or [.] if shared
+        std::vector<double> lambda; // [neuron][batch], or [neuron] if shared
+        std::vector<double> val;    // [neuron][batch], output of last forward
+        std::vector<double> acc;    // [batch]
+    public:
+        /* @brief: check if the genome can be run in a batch */
+        static bool batchable(const Genome &g);
+
+        /* @brief: group batchable genomes by their interned topology
+         * return positions of genomes in each group,
+         * positions of the other genomes are pushed to rest
+         */
+        static std::vector<std::vector<eSpinn_size>> group(
+            const std::vector<const Genome*> &genomes, std::vector<eSpinn_size> &rest);
+
+        /* @brief: constructor
+         * all genomes must be batchable and share one interned topology
+         */
+        NetworkBatch(const std::vector<const Genome*> &genomes);
+
+        /* @brief: constructor of n copies of the network of genome
+         * the genome must be batchable, parameters are shared
+         */
+        NetworkBatch(const Genome &genome, const eSpinn_size &n);
+
+        /* @brief: destructor */
+        ~NetworkBatch() { }
+
+        /* @brief: get num of networks */
+        inline const eSpinn_size size() const { return batch; }
+
+        /* @brief: get input size of each network */
+        inline const eSpinn_size get_inp_size() const { return inp_size; }
+
+        /* @brief: get output size of each network */
+        inline const eSpinn_size get_outp_size() const { return outp_size; }
+
+        /* @brief: reset all networks */
+        void reset();
+
+        /* @brief: run all networks for ONE time slot
+         * inputs of network b are inps[b*inp_size ...]
+         * outputs of network b are written to outps[b*outp_size ...]
+         */
+        void run(const double *inps, double *outps);
+    };
+
+    typedef NetworkBatch<SigmNetwork> SigmNetworkBatch;
+    typedef NetworkBatch<LinrNetwork> LinrNetworkBatch;
+    typedef NetworkBatch<HybridNetwork> HybridNetworkBatch;
+    typedef NetworkBatch<HybLinNetwork> HybLinNetworkBatch;
+}
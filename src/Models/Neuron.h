@@ -182,6 +182,11 @@ namespace eSpinn {
          * & handle plasticity
          */
         virtual void forward() { }
+
+        /* @brief: reset neuron status
+         * restore runtime states as if the neuron is newly created
+         */
+        virtual void reset() { }
     };
         
 }
@@ -70,3 +70,9 @@ void Sensor::forward() {
     transmit(sense_val);
     plasticify_preConn();
 }
+
+
+/* @brief: reset neuron status */
+void Sensor::reset() {
+    sense_val = .0;
+}
@@ -109,6 +109,9 @@ namespace eSpinn {
          * then call transmit()
          */
         void forward() override;
+
+        /* @brief: reset neuron status */
+        void reset() override;
     };
     typedef Sensor LinrNeuron;
 }
@@ -69,3 +69,10 @@ void SigmNeuron::forward() {
     transmit(o);            
     plasticify_preConn();
 }
+
+
+/* @brief: reset neuron status */
+void SigmNeuron::reset() {
+    i = .0;
+    o = .0;
+}
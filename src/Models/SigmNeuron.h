@@ -132,6 +132,9 @@ namespace eSpinn {
          */
         void forward() override;
 
+        /* @brief: reset neuron status */
+        void reset() override;
+
     };
     
     
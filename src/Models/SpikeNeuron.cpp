@@ -62,6 +62,7 @@ const eSpinn_size SpikeNeuron::getSpikeNum() const {
 void SpikeNeuron::reset() {
     spike = 0;
     inc = 0;
+    spike_train.reset();
 }
 
 
@@ -100,7 +100,7 @@ namespace eSpinn {
         virtual void step() { }
 
         /* @brief: reset neuron status */
-        virtual void reset();
+        void reset() override;
 
         /* @brief: load input data
          * use this method for input-layer neurons
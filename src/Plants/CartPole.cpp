@@ -8,6 +8,23 @@
 using namespace eSpinn;
 
 
+// definition of static members
+constexpr double CartPole::_4THIRDS;
+constexpr double CartPole::_1deg;
+constexpr double CartPole::_3deg;
+constexpr double CartPole::_12deg;
+constexpr double CartPole::_0m3;
+constexpr double CartPole::_2m4;
+constexpr double CartPole::G;
+constexpr double CartPole::CART_MASS;
+constexpr double CartPole::POLE_MASS;
+constexpr double CartPole::TOTAL_MASS;
+constexpr double CartPole::POLE_L;
+constexpr double CartPole::xRANGE[];
+constexpr double CartPole::xdotRANGE[];
+constexpr double CartPole::thetaRANGE[];
+constexpr double CartPole::thetadotRANGE[];
+
 /* @brief: random initialization
  * randomly initialize system states
  */
@@ -33,6 +50,17 @@ const std::vector<double> CartPole::get_states() const {
 }
 
 
+/* @brief: write current states to states[0 ... 4)
+ * in the same order as get_states()
+ */
+void CartPole::get_states(double *states) const {
+    states[0] = x;
+    states[1] = theta;
+    states[2] = x_dot;
+    states[3] = theta_dot;
+}
+
+
 /* @brief: update the system states */
 bool CartPole::update(const double &force) {
     double costheta = std::cos(theta);
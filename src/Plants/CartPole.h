@@ -13,22 +13,24 @@
  */
 namespace eSpinn {
     class CartPoleLogger;
+    class CartPoleBatch;
     class CartPole {
         friend class CartPoleLogger;
+        friend class CartPoleBatch;
     private:
         /* math constants */
-        const double _4THIRDS = 1.33333333;
-        const double _1deg = M_PI / 180.0;
-        const double _3deg = 3 * _1deg;
-        const double _12deg = 12 * _1deg;
-        const double _0m3 = 0.3;
-        const double _2m4 = 2.4;
+        static constexpr double _4THIRDS = 1.33333333;
+        static constexpr double _1deg = M_PI / 180.0;
+        static constexpr double _3deg = 3 * _1deg;
+        static constexpr double _12deg = 12 * _1deg;
+        static constexpr double _0m3 = 0.3;
+        static constexpr double _2m4 = 2.4;
         /* system params */
-        const double G = 9.8;
-        const double CART_MASS = 1.0;
-        const double POLE_MASS = 0.1;
-        const double TOTAL_MASS = CART_MASS + POLE_MASS;
-        const double POLE_L = 0.5;
+        static constexpr double G = 9.8;
+        static constexpr double CART_MASS = 1.0;
+        static constexpr double POLE_MASS = 0.1;
+        static constexpr double TOTAL_MASS = CART_MASS + POLE_MASS;
+        static constexpr double POLE_L = 0.5;
         /* data */
         double tau;              // time step in second
         double x, x_dot;         // cart position and velocity
@@ -36,10 +38,10 @@ namespace eSpinn {
 
     public:
         // state variables should not exceed the following boundaries
-        const double xRANGE[2] = {-_2m4, _2m4};
-        const double xdotRANGE[2] = {-1.0, 1.0};
-        const double thetaRANGE[2] = {-_12deg, _12deg};
-        const double thetadotRANGE[2] = {-1.5, 1.5};
+        static constexpr double xRANGE[2] = {-_2m4, _2m4};
+        static constexpr double xdotRANGE[2] = {-1.0, 1.0};
+        static constexpr double thetaRANGE[2] = {-_12deg, _12deg};
+        static constexpr double thetadotRANGE[2] = {-1.5, 1.5};
         /* @brief: constructor */
         CartPole(const double &del_t = 0.01) :
             tau(del_t),
@@ -61,9 +63,17 @@ namespace eSpinn {
         /* @brief: reset system states */
         void reset();
 
+        /* @brief: get time step */
+        inline const double get_tau() const { return tau; }
+
         /* @brief: get current states */
         const std::vector<double> get_states() const;
 
+        /* @brief: write current states to states[0 ... 4)
+         * in the same order as get_states()
+         */
+        void get_states(double *states) const;
+
         /* @brief: update the system states */
         bool update(const double &force);
 
@@ -0,0 +1,130 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "CartPoleBatch.h"
+using namespace eSpinn;
+
+
+/* @brief: sine & cosine of a small angle
+ * evaluated by their Taylor series up to x^13 & x^14,
+ * the truncation errors are below double precision for |x| < 0.5 rad,
+ * which covers running poles (within +/-12 deg) and their last step
+ * inlined in loops, they are vectorized where std::sin/std::cos are not
+ */
+static inline double small_sin(const double &x) {
+    const double x2 = x*x;
+    return x * (1 - x2/6 * (1 - x2/20 * (1 - x2/42 * (1 - x2/72
+        * (1 - x2/110 * (1 - x2/156))))));
+}
+
+
+static inline double small_cos(const double &x) {
+    const double x2 = x*x;
+    return 1 - x2/2 * (1 - x2/12 * (1 - x2/30 * (1 - x2/56
+        * (1 - x2/90 * (1 - x2/132 * (1 - x2/182))))));
+}
+
+
+/* @brief: constructor */
+CartPoleBatch::CartPoleBatch(const eSpinn_size &n, const double &del_t) :
+    num(n), tau(del_t),
+    x(n), x_dot(n), theta(n), theta_dot(n),
+    alive(n), steps(n), num_alive(0)
+{
+    reset();
+}
+
+
+/* @brief: reset all carts */
+void CartPoleBatch::reset() {
+    for (eSpinn_size i = 0; i < num; ++i)
+        reset(i);
+}
+
+
+/* @brief: reset cart i
+ * randomly initialize its states as CartPole::reset()
+ */
+void CartPoleBatch::reset(const eSpinn_size &i) {
+    x[i] = rand(-CartPole::_0m3, CartPole::_0m3);
+    theta[i] = rand(-CartPole::_3deg, CartPole::_3deg);
+    x_dot[i] = .0;
+    theta_dot[i] = .0;
+    steps[i] = 0;
+    if (!alive[i]) {
+        alive[i] = 1;
+        ++num_alive;
+    }
+}
+
+
+/* @brief: write current states to a matrix
+ * states of cart i are written to states[i*stride ...]
+ * in the order of CartPole::get_states(), the first width ones
+ */
+void CartPoleBatch::get_states(double *states, const eSpinn_size &stride,
+    const eSpinn_size &width) const
+{
+    const double *const vars[4] = {x.data(), theta.data(), x_dot.data(), theta_dot.data()};
+    for (eSpinn_size v = 0; v < width && v < 4; ++v) {
+        auto var = vars[v];
+        for (eSpinn_size i = 0; i < num; ++i)
+            states[i*stride + v] = var[i];
+    }
+}
+
+
+/* @brief: write current states of cart i to states[0 ... 4)
+ * in the order of CartPole::get_states()
+ */
+void CartPoleBatch::get_states(const eSpinn_size &i, double *states) const {
+    states[0] = x[i];
+    states[1] = theta[i];
+    states[2] = x_dot[i];
+    states[3] = theta_dot[i];
+}
+
+
+/* @brief: update states of running carts
+ * force[i] drives cart i, ignored if it has failed
+ * return true if any cart is still running
+ * all carts are computed, states of the failed ones are masked out
+ */
+bool CartPoleBatch::update(const double *force) {
+    constexpr double PML = CartPole::POLE_MASS * CartPole::POLE_L;
+    constexpr double TOTAL_MASS = CartPole::TOTAL_MASS;
+    const double x_lo = CartPole::xRANGE[0], x_hi = CartPole::xRANGE[1];
+    const double theta_lo = CartPole::thetaRANGE[0], theta_hi = CartPole::thetaRANGE[1];
+    auto px = x.data(), pxd = x_dot.data(), pt = theta.data(), ptd = theta_dot.data();
+    auto pa = alive.data();
+    auto ps = steps.data();
+
+    eSpinn_size n_alive = 0;
+    for (eSpinn_size i = 0; i < num; ++i) {
+        double costheta = small_cos(pt[i]);
+        double sintheta = small_sin(pt[i]);
+
+        double temp = (force[i] + PML * ptd[i]*ptd[i] * sintheta) / TOTAL_MASS;
+        double thetaacc = (CartPole::G * sintheta - costheta * temp) / (CartPole::POLE_L * (
+                          CartPole::_4THIRDS - CartPole::POLE_MASS * costheta*costheta / TOTAL_MASS));
+        double xacc  = temp - PML * thetaacc * costheta / TOTAL_MASS;
+
+        // update the four state variables using Euler's method
+        const bool a = pa[i];
+        const double nx = px[i] + tau * pxd[i];
+        const double nt = pt[i] + tau * ptd[i];
+        px[i]  = a ? nx : px[i];
+        pxd[i] = a ? pxd[i] + tau * xacc : pxd[i];
+        pt[i]  = a ? nt : pt[i];
+        ptd[i] = a ? ptd[i] + tau * thetaacc : ptd[i];
+        ps[i] += a;
+
+        const bool in = nx >= x_lo && nx <= x_hi && nt >= theta_lo && nt <= theta_hi;
+        pa[i] = a && in;
+        n_alive += pa[i];
+    }
+    num_alive = n_alive;
+    return num_alive;
+}
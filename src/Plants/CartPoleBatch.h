@@ -0,0 +1,77 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "CartPole.h"
+#include <vector>
+
+/* @brief: CartPoleBatch
+ * a group of cart pole systems stepped in lockstep
+ * states are kept as arrays of each variable (x[cart], theta[cart], ...)
+ * so one update of all carts is a set of branch-free array operations
+ * carts out of boundary are masked out and hold their states,
+ * the others keep running until all have failed
+ * each cart follows the same dynamics & initial distributions as CartPole
+ */
+namespace eSpinn {
+    class CartPoleBatch {
+    private:
+        /* data */
+        eSpinn_size num;         // num of carts
+        double tau;              // time step in second
+        std::vector<double> x, x_dot;         // cart position and velocity
+        std::vector<double> theta, theta_dot; // pole angle and angular rate
+        std::vector<char> alive;              // 1 if cart is still running
+        std::vector<eSpinn_size> steps;       // num of updates taken
+        eSpinn_size num_alive;
+    public:
+        /* @brief: constructor */
+        CartPoleBatch(const eSpinn_size &n, const double &del_t = 0.01);
+
+        /* @brief: destructor */
+        ~CartPoleBatch() = default;
+
+        /* @brief: get num of carts */
+        inline const eSpinn_size size() const { return num; }
+
+        /* @brief: reset all carts */
+        void reset();
+
+        /* @brief: reset cart i
+         * randomly initialize its states as CartPole::reset()
+         */
+        void reset(const eSpinn_size &i);
+
+        /* @brief: write current states to a matrix
+         * states of cart i are written to states[i*stride ...]
+         * in the order of CartPole::get_states(), the first width ones
+         */
+        void get_states(double *states, const eSpinn_size &stride,
+            const eSpinn_size &width = 4) const;
+
+        /* @brief: write current states of cart i to states[0 ... 4)
+         * in the order of CartPole::get_states()
+         */
+        void get_states(const eSpinn_size &i, double *states) const;
+
+        /* @brief: update states of running carts
+         * force[i] drives cart i, ignored if it has failed
+         * return true if any cart is still running
+         */
+        bool update(const double *force);
+
+        /* @brief: check if cart i is still running */
+        inline const bool running(const eSpinn_size &i) const { return alive[i]; }
+
+        /* @brief: get num of running carts */
+        inline const eSpinn_size num_running() const { return num_alive; }
+
+        /* @brief: get num of updates cart i has taken
+         * including the one that drives it out of boundary
+         */
+        inline const eSpinn_size get_steps(const eSpinn_size &i) const { return steps[i]; }
+    };
+}
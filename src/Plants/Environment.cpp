@@ -0,0 +1,128 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "Environment.h"
+
+using namespace eSpinn;
+
+
+/* @brief: get num of values traced every time slot
+ * 0 by default, i.e. the environment isn't traced
+ */
+const eSpinn_size Environment::trace_size() const {
+    return 0;
+}
+
+
+/* @brief: write values of the time slot to row[0 ... trace_size)
+ * i.e. states & the action about to be taken by act
+ */
+void Environment::trace(const double *act, double *row) const { }
+
+
+/* @brief: make n environments stepped in lockstep
+ * by default n clones of this environment, stepped one by one
+ */
+std::unique_ptr<EnvironmentBatch> Environment::make_batch(const eSpinn_size &n) const {
+    return std::unique_ptr<EnvironmentBatch>(new ClonedEnvironmentBatch(*this, n));
+}
+
+
+/* @brief: get num of values traced every time slot
+ * 0 by default, i.e. environments aren't traced
+ */
+const eSpinn_size EnvironmentBatch::trace_size() const {
+    return 0;
+}
+
+
+/* @brief: write values of the time slot of environment i
+ * to row[0 ... trace_size), the same as Environment::trace()
+ */
+void EnvironmentBatch::trace(const eSpinn_size &i, const double *act,
+    const eSpinn_size &stride, double *row) const { }
+
+
+/* @brief: constructor */
+ClonedEnvironmentBatch::ClonedEnvironmentBatch(const Environment &env,
+    const eSpinn_size &n) :
+    envs()
+{
+    for (eSpinn_size i = 0; i < n; ++i)
+        envs.push_back(env.clone());
+}
+
+
+/* @brief: get num of environments */
+const eSpinn_size ClonedEnvironmentBatch::size() const {
+    return envs.size();
+}
+
+
+/* @brief: start a new episode of all environments */
+void ClonedEnvironmentBatch::reset() {
+    for (auto &e : envs)
+        e->reset();
+}
+
+
+/* @brief: write normalized observations of environment i
+ * to obs[i*stride ...]
+ */
+void ClonedEnvironmentBatch::observe(double *obs, const eSpinn_size &stride) {
+    for (eSpinn_size i = 0; i < envs.size(); ++i) {
+        if (!envs[i]->done())
+            envs[i]->observe(obs + i*stride);
+    }
+}
+
+
+/* @brief: act on environments that are not done for ONE time slot
+ * environment i by network outputs act[i*stride ...]
+ */
+void ClonedEnvironmentBatch::step(const double *act, const eSpinn_size &stride) {
+    for (eSpinn_size i = 0; i < envs.size(); ++i) {
+        if (!envs[i]->done())
+            envs[i]->step(act + i*stride);
+    }
+}
+
+
+/* @brief: check if the episode of environment i is over */
+bool ClonedEnvironmentBatch::done(const eSpinn_size &i) const {
+    return envs[i]->done();
+}
+
+
+/* @brief: check if episodes of all environments are over */
+bool ClonedEnvironmentBatch::done() const {
+    for (auto &e : envs) {
+        if (!e->done())
+            return false;
+    }
+    return true;
+}
+
+
+/* @brief: get fitness of the episode of environment i */
+const double ClonedEnvironmentBatch::score(const eSpinn_size &i) const {
+    return envs[i]->score();
+}
+
+
+/* @brief: get num of values traced every time slot */
+const eSpinn_size ClonedEnvironmentBatch::trace_size() const {
+    return envs.empty() ? 0 : envs[0]->trace_size();
+}
+
+
+/* @brief: write values of the time slot of environment i
+ * to row[0 ... trace_size)
+ */
+void ClonedEnvironmentBatch::trace(const eSpinn_size &i, const double *act,
+    const eSpinn_size &stride, double *row) const
+{
+    envs[i]->trace(act + i*stride, row);
+}
@@ -0,0 +1,169 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "eSpinn_def.h"
+#include <memory>
+#include <vector>
+
+/* @brief: Environment
+ * a closed-loop control task seen by a controller
+ * an episode starts with reset(), then at every time slot
+ * the controller observes the environment and acts on it by step(),
+ * until done(), and score() gives the fitness of the episode
+ * observations are normalized, ready to be loaded to networks,
+ * actions are raw network outputs, to be post-processed by the environment
+ */
+namespace eSpinn {
+    class EnvironmentBatch;
+    class Environment {
+    public:
+        /* @brief: destructor */
+        virtual ~Environment() = default;
+
+        /* @brief: make a copy of this environment
+         * e.g. one for each worker thread
+         */
+        virtual std::unique_ptr<Environment> clone() const = 0;
+
+        /* @brief: get num of observations */
+        virtual const eSpinn_size obs_size() const = 0;
+
+        /* @brief: get num of actions */
+        virtual const eSpinn_size act_size() const = 0;
+
+        /* @brief: start a new episode */
+        virtual void reset() = 0;
+
+        /* @brief: write normalized observations to obs[0 ... obs_size) */
+        virtual void observe(double *obs) = 0;
+
+        /* @brief: act on the environment for ONE time slot
+         * by network outputs act[0 ... act_size)
+         */
+        virtual void step(const double *act) = 0;
+
+        /* @brief: check if the episode is over */
+        virtual bool done() const = 0;
+
+        /* @brief: get fitness of the episode */
+        virtual const double score() const = 0;
+
+        /* @brief: get num of values traced every time slot
+         * 0 by default, i.e. the environment isn't traced
+         */
+        virtual const eSpinn_size trace_size() const;
+
+        /* @brief: write values of the time slot to row[0 ... trace_size)
+         * i.e. states & the action about to be taken by act
+         */
+        virtual void trace(const double *act, double *row) const;
+
+        /* @brief: make n environments stepped in lockstep
+         * by default n clones of this environment, stepped one by one,
+         * environments of vectorized models should override it
+         */
+        virtual std::unique_ptr<EnvironmentBatch> make_batch(const eSpinn_size &n) const;
+    };
+
+
+    /* @brief: EnvironmentBatch
+     * a group of environments stepped in lockstep,
+     * each controlled by its own network
+     * observations & actions of environment i are row i of a matrix
+     * environments that are done hold their states
+     */
+    class EnvironmentBatch {
+    public:
+        /* @brief: destructor */
+        virtual ~EnvironmentBatch() = default;
+
+        /* @brief: get num of environments */
+        virtual const eSpinn_size size() const = 0;
+
+        /* @brief: start a new episode of all environments */
+        virtual void reset() = 0;
+
+        /* @brief: write normalized observations of environment i
+         * to obs[i*stride ...]
+         */
+        virtual void observe(double *obs, const eSpinn_size &stride) = 0;
+
+        /* @brief: act on environments that are not done for ONE time slot
+         * environment i by network outputs act[i*stride ...]
+         */
+        virtual void step(const double *act, const eSpinn_size &stride) = 0;
+
+        /* @brief: check if the episode of environment i is over */
+        virtual bool done(const eSpinn_size &i) const = 0;
+
+        /* @brief: check if episodes of all environments are over */
+        virtual bool done() const = 0;
+
+        /* @brief: get fitness of the episode of environment i */
+        virtual const double score(const eSpinn_size &i) const = 0;
+
+        /* @brief: get num of values traced every time slot
+         * 0 by default, i.e. environments aren't traced
+         */
+        virtual const eSpinn_size trace_size() const;
+
+        /* @brief: write values of the time slot of environment i
+         * to row[0 ... trace_size), the same as Environment::trace()
+         * i.e. its states & the action about to be taken by act[i*stride ...]
+         */
+        virtual void trace(const eSpinn_size &i, const double *act,
+            const eSpinn_size &stride, double *row) const;
+    };
+
+
+    /* @brief: ClonedEnvironmentBatch
+     * environments stepped in lockstep, one by one
+     * initialization list: prototype environment, num of clones
+     */
+    class ClonedEnvironmentBatch : public EnvironmentBatch {
+    private:
+        /* data */
+        std::vector<std::unique_ptr<Environment>> envs;
+    public:
+        /* @brief: constructor */
+        ClonedEnvironmentBatch(const Environment &env, const eSpinn_size &n);
+
+        /* @brief: get num of environments */
+        const eSpinn_size size() const override;
+
+        /* @brief: start a new episode of all environments */
+        void reset() override;
+
+        /* @brief: write normalized observations of environment i
+         * to obs[i*stride ...]
+         */
+        void observe(double *obs, const eSpinn_size &stride) override;
+
+        /* @brief: act on environments that are not done for ONE time slot
+         * environment i by network outputs act[i*stride ...]
+         */
+        void step(const double *act, const eSpinn_size &stride) override;
+
+        /* @brief: check if the episode of environment i is over */
+        bool done(const eSpinn_size &i) const override;
+
+        /* @brief: check if episodes of all environments are over */
+        bool done() const override;
+
+        /* @brief: get fitness of the episode of environment i */
+        const double score(const eSpinn_size &i) const override;
+
+        /* @brief: get num of values traced every time slot */
+        const eSpinn_size trace_size() const override;
+
+        /* @brief: write values of the time slot of environment i
+         * to row[0 ... trace_size)
+         */
+        void trace(const eSpinn_size &i, const double *act,
+            const eSpinn_size &stride, double *row) const override;
+    };
+}
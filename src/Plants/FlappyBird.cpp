@@ -0,0 +1,208 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "FlappyBird.h"
+#include "Utilities/Utilities.h"
+#include <algorithm>
+
+using namespace eSpinn;
+
+
+// definition of static members
+constexpr int FlappyBird::WIDTH;
+constexpr int FlappyBird::HEIGHT;
+constexpr int FlappyBird::SPEED;
+constexpr int FlappyBird::PIPEGAP;
+constexpr int FlappyBird::PIPEGAP_H;
+constexpr int FlappyBird::BASE_Y;
+constexpr int FlappyBird::BIRD_W;
+constexpr int FlappyBird::BIRD_H;
+constexpr int FlappyBird::PIPE_W;
+constexpr int FlappyBird::PIPE_H;
+constexpr int FlappyBird::BIRD_X;
+constexpr int FlappyBird::BIRD_Y;
+constexpr int FlappyBird::yTOP;
+constexpr int FlappyBird::yBOTTOM;
+constexpr int FlappyBird::velMAXY;
+constexpr int FlappyBird::ACCY;
+constexpr int FlappyBird::flapVel;
+constexpr double FlappyBird::errxRANGE[];
+constexpr double FlappyBird::erryRANGE[];
+
+
+/* @brief: hitmasks of sprites, from the alpha of the images
+ * each row of a bird sprite is a run of opaque pixels [begin, end),
+ * the art is drawn in 2x2 pixels, so a mask row is 2 image rows
+ * a pipe is opaque but the 2 pixels on both sides of its body,
+ * its cap (next to the gap) is opaque across the whole width
+ */
+namespace {
+    struct Span
+    {
+        int begin, end;
+    };
+
+    // upflap, midflap & downflap
+    const Span bird_mask[3][FlappyBird::BIRD_H/2] = {
+        {{12, 24}, {8, 26}, {6, 28}, {2, 30}, {0, 30}, {0, 30},
+         {0, 32}, {2, 34}, {4, 32}, {4, 32}, {6, 30}, {10, 20}},
+        {{12, 24}, {8, 26}, {6, 28}, {4, 30}, {2, 30}, {2, 30},
+         {0, 32}, {0, 34}, {2, 32}, {4, 32}, {6, 30}, {10, 20}},
+        {{12, 24}, {8, 26}, {6, 28}, {4, 30}, {2, 30}, {2, 30},
+         {2, 32}, {0, 34}, {0, 32}, {0, 32}, {2, 30}, {10, 20}},
+    };
+
+    constexpr int PIPE_CAP = 24; // height of pipe cap
+    constexpr int PIPE_RIM = 2;  // transparent pixels on both sides of pipe body
+
+    // birds flap their wings every 10 frames in the cycle
+    constexpr int WING_FRAMES = 10;
+    const eSpinn_size wing_cycle[4] = {0, 1, 2, 1};
+
+    // gap of pipes is within [0.2baseY, 0.8baseY-PIPEGAP)
+    constexpr int GAP_MIN = static_cast<int>(FlappyBird::BASE_Y * .2);
+    constexpr int GAP_RANGE = static_cast<int>(FlappyBird::BASE_Y * .6 - FlappyBird::PIPEGAP);
+}
+
+
+/* @brief: constructor */
+FlappyBird::FlappyBird(const eSpinn_size &n, const std::uint64_t &s) :
+    num(n), seed(s), num_pipes(0), pipes(), frames(0),
+    y(n), vel_y(n), alive(n), dist(n), num_alive(0)
+{
+    reset();
+}
+
+
+/* @brief: set seed of the course, used from the next reset */
+void FlappyBird::set_seed(const std::uint64_t &s) {
+    seed = s;
+}
+
+
+/* @brief: create a pair of pipes at x, the gap is drawn from the course */
+FlappyBird::Pipe FlappyBird::create_pipe(const int &x) {
+    int gap_y = static_cast<int>(splitmix64(seed, num_pipes++) % GAP_RANGE);
+    return Pipe{x, gap_y + GAP_MIN};
+}
+
+
+/* @brief: start a new game
+ * the course is regenerated from the seed,
+ * birds start around the middle, randomly shifted by +/-10
+ */
+void FlappyBird::reset() {
+    num_pipes = 0;
+    pipes.clear();
+    pipes.push_back(create_pipe(WIDTH + 200));
+    pipes.push_back(create_pipe(WIDTH + 200 + PIPE_W + PIPEGAP_H));
+    frames = 0;
+    for (eSpinn_size i = 0; i < num; ++i) {
+        y[i] = BIRD_Y + rand(-10, 10);
+        vel_y[i] = flapVel;
+        alive[i] = 1;
+        dist[i] = 0;
+    }
+    num_alive = num;
+}
+
+
+/* @brief: write states of bird i to states[i*stride ...]
+ * err_x & err_y to the pipe ahead
+ */
+void FlappyBird::get_states(double *states, const eSpinn_size &stride) const {
+    // the first pipe whose right edge is ahead of birds
+    auto p = pipes.begin();
+    while (p + 1 != pipes.end() && p->x + PIPE_W <= BIRD_X)
+        ++p;
+    const double err_x = p->x + PIPE_W - BIRD_X;
+    const int gap_mid = p->gap_y + PIPEGAP/2;
+    for (eSpinn_size i = 0; i < num; ++i) {
+        states[i*stride] = err_x;
+        states[i*stride + 1] = y[i] - gap_mid;
+    }
+}
+
+
+/* @brief: move pipes, create new pipes & remove old pipes */
+void FlappyBird::update_pipes() {
+    for (auto &p : pipes)
+        p.x -= SPEED;
+    if (0 < pipes[0].x && pipes[0].x < SPEED+1) {
+        auto diff = pipes[1].x - pipes[0].x;
+        pipes.push_back(create_pipe(pipes[1].x + diff));
+    }
+    if (pipes[0].x < -PIPE_W)
+        pipes.erase(pipes.begin());
+}
+
+
+/* @brief: get current wing mode */
+const eSpinn_size FlappyBird::wing() const {
+    if (frames < WING_FRAMES)
+        return 0;
+    return wing_cycle[(frames/WING_FRAMES - 1) % 4];
+}
+
+
+/* @brief: check if bird at height by collides with base or pipes
+ * w is the wing mode
+ */
+bool FlappyBird::crash(const int &by, const eSpinn_size &w) const {
+    if (by >= yBOTTOM)
+        return true;
+
+    for (auto &p : pipes) {
+        if (BIRD_X + BIRD_W <= p.x || p.x + PIPE_W <= BIRD_X)
+            continue;
+        const int upper = p.gap_y - PIPE_H, lower = p.gap_y + PIPEGAP;
+        for (int r = 0; r < BIRD_H; ++r) {
+            const int row = by + r;
+            bool cap;
+            if (upper <= row && row < p.gap_y)
+                cap = row >= p.gap_y - PIPE_CAP;
+            else if (lower <= row && row < lower + PIPE_H)
+                cap = row < lower + PIPE_CAP;
+            else
+                continue;
+            const int rim = cap ? 0 : PIPE_RIM;
+            const auto &s = bird_mask[w][r/2];
+            if (std::max(BIRD_X + s.begin, p.x + rim)
+                < std::min(BIRD_X + s.end, p.x + PIPE_W - rim))
+                return true;
+        }
+    }
+    return false;
+}
+
+
+/* @brief: update the game for ONE frame
+ * bird i flaps if flap[i] is non-zero, ignored if it has crashed
+ * return true if any bird is still flying
+ * birds move, then pipes move & wings flap, then crashes are checked
+ */
+bool FlappyBird::update(const char *flap) {
+    for (eSpinn_size i = 0; i < num; ++i) {
+        if (!alive[i])
+            continue;
+        if (flap[i])
+            vel_y[i] = flapVel;
+        else if (vel_y[i] < velMAXY)
+            vel_y[i] += ACCY;
+        y[i] = std::min(std::max(y[i] + vel_y[i], yTOP), yBOTTOM);
+        ++dist[i];
+    }
+    update_pipes();
+    ++frames;
+
+    const auto w = wing();
+    for (eSpinn_size i = 0; i < num; ++i) {
+        if (alive[i] && crash(y[i], w)) {
+            alive[i] = 0;
+            --num_alive;
+        }
+    }
+    return num_alive;
+}
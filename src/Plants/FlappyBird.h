@@ -0,0 +1,127 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "eSpinn_def.h"
+#include <cstdint>
+#include <vector>
+
+/* @brief: FlappyBird
+ * headless Flappy Bird game of game/flappybird.py, without rendering
+ * a flock of birds fly through one course of pipes in lockstep,
+ * as birds of a generation do in tasks/sim_flappy.py
+ * the course is generated from a seed, so it can be replayed
+ * dynamics, sizes & collisions (pixel hitmasks of sprites) are the same
+ * as the game, except that each bird flaps its wings on its own
+ * rather than sharing one wing cycle with the whole flock
+ * initialization list: num of birds, seed of the course
+ */
+namespace eSpinn {
+    class FlappyBird {
+    public:
+        // window & game definitions, the same as game/flappybird.py
+        static constexpr int WIDTH = 288;
+        static constexpr int HEIGHT = 512;
+        static constexpr int SPEED = 4;       // moving speed
+        static constexpr int PIPEGAP = 100;   // gap between upper and lower part of pipe
+        static constexpr int PIPEGAP_H = 100; // horizontal gap between adjacent pipes
+        static constexpr int BASE_Y = 404;    // int(HEIGHT * .79)
+        // sprite sizes
+        static constexpr int BIRD_W = 34, BIRD_H = 24;
+        static constexpr int PIPE_W = 52, PIPE_H = 320;
+        // bird states
+        static constexpr int BIRD_X = 57;     // int(WIDTH * .2)
+        static constexpr int BIRD_Y = 244;    // int((HEIGHT - BIRD_H) / 2)
+        static constexpr int yTOP = -24;
+        static constexpr int yBOTTOM = BASE_Y - BIRD_H;
+        static constexpr int velMAXY = 10;    // max descend velocity
+        static constexpr int ACCY = 1;
+        static constexpr int flapVel = -9;
+        // ranges of the states birds observe, the same as tasks/sim_flappy.py
+        // err_x: horizontal dist btw bird (left edge) & pipe (right edge)
+        // err_y: height dist btw bird (top edge) & pipe gap (middle)
+        static constexpr double errxRANGE[2] = {0, PIPEGAP_H + PIPE_W};
+        static constexpr double erryRANGE[2] = {
+            yTOP - static_cast<int>(.8*BASE_Y - PIPEGAP/2),
+            yBOTTOM - static_cast<int>(.2*BASE_Y + PIPEGAP/2)};
+    private:
+        /* @brief: a pair of upper & lower pipes */
+        struct Pipe
+        {
+            int x;     // left edge
+            int gap_y; // top of the gap
+        };
+
+        /* data */
+        eSpinn_size num;         // num of birds
+        std::uint64_t seed;      // seed of the course
+        eSpinn_size num_pipes;   // num of pipes created
+        std::vector<Pipe> pipes;
+        eSpinn_size frames;
+        std::vector<int> y, vel_y;
+        std::vector<char> alive;       // 1 if bird hasn't crashed
+        std::vector<eSpinn_size> dist; // num of frames flown
+        eSpinn_size num_alive;
+
+        /* @brief: create a pair of pipes at x, the gap is drawn from the course */
+        Pipe create_pipe(const int &x);
+
+        /* @brief: move pipes, create new pipes & remove old pipes */
+        void update_pipes();
+
+        /* @brief: get current wing mode */
+        const eSpinn_size wing() const;
+
+        /* @brief: check if bird at height by collides with base or pipes */
+        bool crash(const int &by, const eSpinn_size &w) const;
+    public:
+        /* @brief: constructor */
+        FlappyBird(const eSpinn_size &n, const std::uint64_t &s = 0);
+
+        /* @brief: destructor */
+        ~FlappyBird() = default;
+
+        /* @brief: get num of birds */
+        inline const eSpinn_size size() const { return num; }
+
+        /* @brief: set seed of the course, used from the next reset */
+        void set_seed(const std::uint64_t &s);
+
+        /* @brief: start a new game
+         * the course is regenerated from the seed,
+         * birds start around the middle, randomly shifted by +/-10
+         */
+        void reset();
+
+        /* @brief: write states of bird i to states[i*stride ...]
+         * err_x & err_y to the pipe ahead
+         */
+        void get_states(double *states, const eSpinn_size &stride) const;
+
+        /* @brief: update the game for ONE frame
+         * bird i flaps if flap[i] is non-zero, ignored if it has crashed
+         * return true if any bird is still flying
+         */
+        bool update(const char *flap);
+
+        /* @brief: get num of frames since the game started */
+        inline const eSpinn_size get_frames() const { return frames; }
+
+        /* @brief: get height of bird i */
+        inline const int getY(const eSpinn_size &i) const { return y[i]; }
+
+        /* @brief: check if bird i is still flying */
+        inline const bool running(const eSpinn_size &i) const { return alive[i]; }
+
+        /* @brief: get num of flying birds */
+        inline const eSpinn_size num_running() const { return num_alive; }
+
+        /* @brief: get num of frames bird i has flown
+         * including the one it crashes in
+         */
+        inline const eSpinn_size get_dist(const eSpinn_size &i) const { return dist[i]; }
+    };
+}
@@ -0,0 +1,144 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "FlappyEnv.h"
+
+using namespace eSpinn;
+
+
+// definition of static members
+constexpr eSpinn_size FlappyEnv::MAX_DIST;
+
+
+/* @brief: normalize err_x & err_y in place, the same as Injector */
+static inline void normalize(double *states) {
+    states[0] = 1.0/(FlappyBird::errxRANGE[1] - FlappyBird::errxRANGE[0])
+        * (states[0] + -FlappyBird::errxRANGE[0]);
+    states[1] = 1.0/(FlappyBird::erryRANGE[1] - FlappyBird::erryRANGE[0])
+        * (states[1] + -FlappyBird::erryRANGE[0]);
+}
+
+
+/* @brief: constructor */
+FlappyEnv::FlappyEnv(const std::uint64_t &s) :
+    game(1, s), seed(s) { }
+
+
+/* @brief: set seed of the course */
+void FlappyEnv::set_seed(const std::uint64_t &s) {
+    seed = s;
+    game.set_seed(s);
+}
+
+
+/* @brief: make a copy of this environment */
+std::unique_ptr<Environment> FlappyEnv::clone() const {
+    return std::unique_ptr<Environment>(new FlappyEnv(*this));
+}
+
+
+/* @brief: get num of observations */
+const eSpinn_size FlappyEnv::obs_size() const {
+    return 2;
+}
+
+
+/* @brief: get num of actions */
+const eSpinn_size FlappyEnv::act_size() const {
+    return 1;
+}
+
+
+/* @brief: start a new episode */
+void FlappyEnv::reset() {
+    game.reset();
+}
+
+
+/* @brief: write normalized observations to obs[0 ... obs_size) */
+void FlappyEnv::observe(double *obs) {
+    game.get_states(obs, obs_size());
+    normalize(obs);
+}
+
+
+/* @brief: act on the bird for ONE frame
+ * the bird flaps if the network output is positive
+ */
+void FlappyEnv::step(const double *act) {
+    const char flap = act[0] > .0;
+    game.update(&flap);
+}
+
+
+/* @brief: check if the episode is over */
+bool FlappyEnv::done() const {
+    return !game.running(0) || game.get_frames() >= MAX_DIST;
+}
+
+
+/* @brief: get fitness of the episode */
+const double FlappyEnv::score() const {
+    return game.get_dist(0) + game.running(0);
+}
+
+
+/* @brief: make n environments of birds flying together */
+std::unique_ptr<EnvironmentBatch> FlappyEnv::make_batch(const eSpinn_size &n) const {
+    return std::unique_ptr<EnvironmentBatch>(new FlappyEnvBatch(n, seed));
+}
+
+
+/* @brief: constructor */
+FlappyEnvBatch::FlappyEnvBatch(const eSpinn_size &n, const std::uint64_t &s) :
+    game(n, s), flap(n) { }
+
+
+/* @brief: get num of environments */
+const eSpinn_size FlappyEnvBatch::size() const {
+    return game.size();
+}
+
+
+/* @brief: start a new episode of all birds */
+void FlappyEnvBatch::reset() {
+    game.reset();
+}
+
+
+/* @brief: write normalized observations of bird i to obs[i*stride ...] */
+void FlappyEnvBatch::observe(double *obs, const eSpinn_size &stride) {
+    game.get_states(obs, stride);
+    for (eSpinn_size i = 0; i < game.size(); ++i)
+        normalize(obs + i*stride);
+}
+
+
+/* @brief: act on flying birds for ONE frame
+ * bird i flaps if its network output is positive
+ */
+void FlappyEnvBatch::step(const double *act, const eSpinn_size &stride) {
+    for (eSpinn_size i = 0; i < game.size(); ++i)
+        flap[i] = act[i*stride] > .0;
+    game.update(flap.data());
+}
+
+
+/* @brief: check if the episode of bird i is over */
+bool FlappyEnvBatch::done(const eSpinn_size &i) const {
+    return !game.running(i) || game.get_frames() >= FlappyEnv::MAX_DIST;
+}
+
+
+/* @brief: check if episodes of all birds are over */
+bool FlappyEnvBatch::done() const {
+    return !game.num_running() || game.get_frames() >= FlappyEnv::MAX_DIST;
+}
+
+
+/* @brief: get fitness of the episode of bird i */
+const double FlappyEnvBatch::score(const eSpinn_size &i) const {
+    return game.get_dist(i) + game.running(i);
+}
@@ -0,0 +1,101 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "Environment.h"
+#include "FlappyBird.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/* @brief: FlappyEnv
+ * headless Flappy Bird as an environment
+ * observations are normalized err_x & err_y to the pipe ahead,
+ * the bird flaps if the network output is positive
+ * the episode is over when the bird crashes or after MAX_DIST frames,
+ * the score is the num of frames flown, plus one if the bird survives
+ * every episode flies the same course until the seed is changed,
+ * so all organisms of a generation are scored on the same pipes
+ * initialization list: seed of the course
+ */
+namespace eSpinn {
+    class FlappyEnv : public Environment {
+    public:
+        static constexpr eSpinn_size MAX_DIST = 10000;
+    private:
+        /* data */
+        FlappyBird game;
+        std::uint64_t seed;
+    public:
+        /* @brief: constructor */
+        FlappyEnv(const std::uint64_t &s = 0);
+
+        /* @brief: set seed of the course */
+        void set_seed(const std::uint64_t &s);
+
+        /* @brief: make a copy of this environment */
+        std::unique_ptr<Environment> clone() const override;
+
+        /* @brief: get num of observations */
+        const eSpinn_size obs_size() const override;
+
+        /* @brief: get num of actions */
+        const eSpinn_size act_size() const override;
+
+        /* @brief: start a new episode */
+        void reset() override;
+
+        /* @brief: write normalized observations to obs[0 ... obs_size) */
+        void observe(double *obs) override;
+
+        /* @brief: act on the bird for ONE frame */
+        void step(const double *act) override;
+
+        /* @brief: check if the episode is over */
+        bool done() const override;
+
+        /* @brief: get fitness of the episode */
+        const double score() const override;
+
+        /* @brief: make n environments of birds flying together */
+        std::unique_ptr<EnvironmentBatch> make_batch(const eSpinn_size &n) const override;
+    };
+
+
+    /* @brief: FlappyEnvBatch
+     * a flock of birds flying through the same course in lockstep
+     */
+    class FlappyEnvBatch : public EnvironmentBatch {
+    private:
+        /* data */
+        FlappyBird game;
+        std::vector<char> flap;
+    public:
+        /* @brief: constructor */
+        FlappyEnvBatch(const eSpinn_size &n, const std::uint64_t &s = 0);
+
+        /* @brief: get num of environments */
+        const eSpinn_size size() const override;
+
+        /* @brief: start a new episode of all birds */
+        void reset() override;
+
+        /* @brief: write normalized observations of bird i to obs[i*stride ...] */
+        void observe(double *obs, const eSpinn_size &stride) override;
+
+        /* @brief: act on flying birds for ONE frame */
+        void step(const double *act, const eSpinn_size &stride) override;
+
+        /* @brief: check if the episode of bird i is over */
+        bool done(const eSpinn_size &i) const override;
+
+        /* @brief: check if episodes of all birds are over */
+        bool done() const override;
+
+        /* @brief: get fitness of the episode of bird i */
+        const double score(const eSpinn_size &i) const override;
+    };
+}
@@ -9,6 +9,13 @@ using namespace eSpinn;
 
 
 // definition of static members
+constexpr double Hexacopter::kt;
+constexpr double Hexacopter::kv;
+constexpr double Hexacopter::b;
+constexpr double Hexacopter::kb;
+constexpr double Hexacopter::b_h;
+constexpr double Hexacopter::kb_t;
+constexpr double Hexacopter::posMAX;
 constexpr double Hexacopter::velRANGE[];
 constexpr double Hexacopter::pos_errRANGE[];
 constexpr double Hexacopter::battRange[];
@@ -11,11 +11,13 @@
  * linearized hexacopter heave model
  */
 namespace eSpinn {
+    class HexacopterBatch;
     class Hexacopter {
+        friend class HexacopterBatch;
     private:
-        const double kt = 15.5, kv = -0.052, b = .3; // acc ~ thr + rate
-        const double kb = -0.05274, b_h = 0.87942; // hover ~ batt
-        const double kb_t = 0.0049109; // battery voltage decrease rate vs. time
+        static constexpr double kt = 15.5, kv = -0.052, b = .3; // acc ~ thr + rate
+        static constexpr double kb = -0.05274, b_h = 0.87942; // hover ~ batt
+        static constexpr double kb_t = 0.0049109; // battery voltage decrease rate vs. time
         double dt; // time interval in second
         double acc, vel, pos;
         double hover; // hover thr
@@ -0,0 +1,149 @@
+/* Copyright (C) 2021 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "HexacopterBatch.h"
+
+using namespace eSpinn;
+
+
+/* @brief: constructor
+ * all hexacopters start with battery voltage init_b
+ */
+HexacopterBatch::HexacopterBatch(const eSpinn_size &n, const double &del_t,
+    const double &init_b) :
+    HexacopterBatch(std::vector<double>(n, init_b), del_t)
+{ }
+
+
+/* @brief: constructor
+ * hexacopter i starts with battery voltage init_b[i]
+ */
+HexacopterBatch::HexacopterBatch(const std::vector<double> &init_b,
+    const double &del_t) :
+    num(init_b.size()), dt(del_t),
+    acc(num), vel(num), pos(num),
+    hover(num), batt(init_b), init_batt(init_b),
+    alive(num), steps(num), num_alive(0)
+{
+    reset();
+}
+
+
+/* @brief: get approximated hover value of hexacopter i from current batt */
+const double HexacopterBatch::getApproxHover(const eSpinn_size &i,
+    const double &thr) const
+{
+    return Hexacopter::kb * (batt[i] - 1*(thr-hover[i])) + Hexacopter::b_h;
+}
+
+
+/* @brief: get approximated hover values of all from current batt
+ * thr[i] is the previous thr of hexacopter i
+ */
+void HexacopterBatch::getApproxHover(const double *thr, double *hov) const {
+    for (eSpinn_size i = 0; i < num; ++i)
+        hov[i] = Hexacopter::kb * (batt[i] - 1*(thr[i]-hover[i])) + Hexacopter::b_h;
+}
+
+
+/* @brief: set battery voltage */
+void HexacopterBatch::setBatt(const eSpinn_size &i, const double &b) {
+    batt[i] = b;
+}
+
+
+/* @brief: set initial battery voltage, restored when reset */
+void HexacopterBatch::setInitBatt(const eSpinn_size &i, const double &b) {
+    init_batt[i] = b;
+}
+
+
+/* @brief: run running hexacopters for ONE time slot
+ * thr[i] drives hexacopter i, ignored if it has failed
+ * hexacopters out of boundary afterwards are masked out
+ * return true if any hexacopter is still running
+ * system dynamic
+ * hover = kb * batt + b_h
+ * a(t) = kt * (thr(t)-hover) + kv * v(t) + b
+ * v(t+1) = v(t) + a(t) * dt
+ * p(t+1) = p(t) + v(t+1) * dt
+ * batt(t+1) = batt(t) - kb_t * dt
+ */
+bool HexacopterBatch::run(const double *thr) {
+    const double lo = Hexacopter::posERR[0], hi = Hexacopter::posERR[1];
+    const double d_batt = Hexacopter::kb_t * dt;
+    auto pa = acc.data(), pv = vel.data(), pp = pos.data();
+    auto ph = hover.data(), pb = batt.data();
+    auto pm = alive.data();
+    auto ps = steps.data();
+
+    eSpinn_size n_alive = 0;
+    for (eSpinn_size i = 0; i < num; ++i) {
+        const bool a = pm[i];
+        const double nh = Hexacopter::kb * pb[i] + Hexacopter::b_h;
+        const double na = Hexacopter::kt * (thr[i]-nh) + Hexacopter::kv * pv[i] + Hexacopter::b;
+        const double nv = pv[i] + na * dt;
+        const double np = pp[i] + nv * dt;
+        ph[i] = a ? nh : ph[i];
+        pa[i] = a ? na : pa[i];
+        pv[i] = a ? nv : pv[i];
+        pp[i] = a ? np : pp[i];
+        pb[i] = a ? pb[i] - d_batt : pb[i];
+        ps[i] += a;
+
+        pm[i] = a && np >= lo && np <= hi;
+        n_alive += pm[i];
+    }
+    num_alive = n_alive;
+    return num_alive;
+}
+
+
+/* @brief: reset status of all hexacopters */
+void HexacopterBatch::reset() {
+    for (eSpinn_size i = 0; i < num; ++i)
+        reset(i);
+}
+
+
+/* @brief: reset status of hexacopter i */
+void HexacopterBatch::reset(const eSpinn_size &i) {
+    acc[i] = .0;
+    vel[i] = .0;
+    pos[i] = .0;
+    batt[i] = init_batt[i];
+    hover[i] = Hexacopter::kb * init_batt[i] + Hexacopter::b_h;
+    steps[i] = 0;
+    if (!alive[i]) {
+        alive[i] = 1;
+        ++num_alive;
+    }
+}
+
+
+/* @brief: cap state variables of running hexacopters */
+void HexacopterBatch::rectify() {
+    const double lo = Hexacopter::velRANGE[0], hi = Hexacopter::velRANGE[1];
+    for (eSpinn_size i = 0; i < num; ++i) {
+        const double v = vel[i] < lo ? lo : (vel[i] > hi ? hi : vel[i]);
+        vel[i] = alive[i] ? v : vel[i];
+    }
+}
+
+
+/* @brief: check if state variables out of boundary
+ * mask[i] is set to 1 if hexacopter i is within boundary, 0 otherwise
+ * return num of hexacopters within boundary
+ */
+eSpinn_size HexacopterBatch::check(std::vector<char> &mask) const {
+    const double lo = Hexacopter::posERR[0], hi = Hexacopter::posERR[1];
+    mask.resize(num);
+    eSpinn_size n_in = 0;
+    for (eSpinn_size i = 0; i < num; ++i) {
+        mask[i] = pos[i] >= lo && pos[i] <= hi;
+        n_in += mask[i];
+    }
+    return n_in;
+}
@@ -0,0 +1,119 @@
+/* Copyright (C) 2021 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "eSpinn_def.h"
+#include "Hexacopter.h"
+#include <vector>
+
+/* @brief: HexacopterBatch
+ * a group of linearized hexacopter heave models stepped in lockstep
+ * states are kept as arrays of each variable, one entry a hexacopter,
+ * including its own battery voltage & hover thr,
+ * so hexacopters of different batteries can be evaluated side by side
+ * hexacopters out of boundary are masked out and hold their states,
+ * the others keep running
+ * each hexacopter follows the same dynamics as Hexacopter
+ */
+namespace eSpinn {
+    class HexacopterBatch {
+    private:
+        /* data */
+        eSpinn_size num;    // num of hexacopters
+        double dt;          // time interval in second
+        std::vector<double> acc, vel, pos;
+        std::vector<double> hover; // hover thr
+        std::vector<double> batt, init_batt;
+        std::vector<char> alive;        // 1 if hexacopter is still running
+        std::vector<eSpinn_size> steps; // num of runs taken
+        eSpinn_size num_alive;
+    public:
+        /* @brief: constructor
+         * all hexacopters start with battery voltage init_b
+         */
+        HexacopterBatch(const eSpinn_size &n, const double &del_t = 0.01,
+            const double &init_b = 11.5);
+
+        /* @brief: constructor
+         * hexacopter i starts with battery voltage init_b[i]
+         */
+        HexacopterBatch(const std::vector<double> &init_b, const double &del_t = 0.01);
+
+        /* @brief: destructor */
+        ~HexacopterBatch() = default;
+
+        /* @brief: get num of hexacopters */
+        inline const eSpinn_size size() const { return num; }
+
+        /* @brief: get current acceleration */
+        inline const double getAcc(const eSpinn_size &i) const { return acc[i]; }
+        inline const std::vector<double>& getAcc() const { return acc; }
+
+        /* @brief: get current velocity */
+        inline const double getVel(const eSpinn_size &i) const { return vel[i]; }
+        inline const std::vector<double>& getVel() const { return vel; }
+
+        /* @brief: get current position */
+        inline const double getPos(const eSpinn_size &i) const { return pos[i]; }
+        inline const std::vector<double>& getPos() const { return pos; }
+
+        /* @brief: get current hover value */
+        inline const double getHover(const eSpinn_size &i) const { return hover[i]; }
+
+        /* @brief: get approximated hover value of hexacopter i from current batt */
+        const double getApproxHover(const eSpinn_size &i, const double &thr) const;
+
+        /* @brief: get approximated hover values of all from current batt
+         * thr[i] is the previous thr of hexacopter i
+         */
+        void getApproxHover(const double *thr, double *hov) const;
+
+        /* @brief: get current battery voltage */
+        inline const double getBatt(const eSpinn_size &i) const { return batt[i]; }
+
+        /* @brief: set battery voltage */
+        void setBatt(const eSpinn_size &i, const double &b);
+
+        /* @brief: set initial battery voltage, restored when reset */
+        void setInitBatt(const eSpinn_size &i, const double &b);
+
+        /* @brief: run running hexacopters for ONE time slot
+         * thr[i] drives hexacopter i, ignored if it has failed
+         * hexacopters out of boundary afterwards are masked out
+         * return true if any hexacopter is still running
+         */
+        bool run(const double *thr);
+
+        /* @brief: reset status of all hexacopters */
+        void reset();
+
+        /* @brief: reset status of hexacopter i */
+        void reset(const eSpinn_size &i);
+
+        /* @brief: cap state variables of running hexacopters */
+        void rectify();
+
+        /* @brief: check if state variables out of boundary
+         * mask[i] is set to 1 if hexacopter i is within boundary, 0 otherwise
+         * return num of hexacopters within boundary
+         */
+        eSpinn_size check(std::vector<char> &mask) const;
+
+        /* @brief: check if hexacopter i is still running */
+        inline const bool running(const eSpinn_size &i) const { return alive[i]; }
+
+        /* @brief: get running mask, 1 if a hexacopter is still running */
+        inline const std::vector<char>& get_mask() const { return alive; }
+
+        /* @brief: get num of running hexacopters */
+        inline const eSpinn_size num_running() const { return num_alive; }
+
+        /* @brief: get num of runs hexacopter i has taken
+         * including the one that drives it out of boundary
+         */
+        inline const eSpinn_size get_steps(const eSpinn_size &i) const { return steps[i]; }
+    };
+}
@@ -9,6 +9,10 @@ using namespace eSpinn;
 
 
 // definition of static members
+constexpr double Plant::kt;
+constexpr double Plant::kv;
+constexpr double Plant::b;
+constexpr double Plant::g;
 constexpr double Plant::velRANGE[];
 constexpr double Plant::posRANGE[];
 
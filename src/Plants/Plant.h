@@ -11,9 +11,11 @@
  * linearized UAV heave model
  */
 namespace eSpinn {
+    class PlantBatch;
     class Plant {
+        friend class PlantBatch;
     private:
-        const double kt = -2.7653, kv = -0.7670, b = 9.8175, g = 9.81;
+        static constexpr double kt = -2.7653, kv = -0.7670, b = 9.8175, g = 9.81;
         double dt; // time interval in second
         double acc, vel, pos;
     public:
@@ -0,0 +1,98 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "PlantBatch.h"
+
+using namespace eSpinn;
+
+
+/* @brief: constructor */
+PlantBatch::PlantBatch(const eSpinn_size &n, const double &del_t) :
+    num(n), dt(del_t),
+    acc(n), vel(n), pos(n),
+    alive(n), steps(n), num_alive(0)
+{
+    reset();
+}
+
+
+/* @brief: run running plants for ONE time slot
+ * force[i] drives plant i, ignored if it has failed
+ * plants out of boundary afterwards are masked out
+ * return true if any plant is still running
+ * system dynamic
+ * a(t) = kt * f(t) + kv * v(t) + b
+ * v(t+1) = v(t) + a(t) * dt
+ * s(t+1) = s(t) + v(t+1) * dt
+ */
+bool PlantBatch::run(const double *force) {
+    const double lo = Plant::posRANGE[0], hi = Plant::posRANGE[1];
+    auto pa = acc.data(), pv = vel.data(), pp = pos.data();
+    auto pm = alive.data();
+    auto ps = steps.data();
+
+    eSpinn_size n_alive = 0;
+    for (eSpinn_size i = 0; i < num; ++i) {
+        const bool a = pm[i];
+        const double na = Plant::kt * force[i] + Plant::kv * pv[i] + Plant::b + Plant::g;
+        const double nv = pv[i] + na * dt;
+        const double np = pp[i] + nv * dt;
+        pa[i] = a ? na : pa[i];
+        pv[i] = a ? nv : pv[i];
+        pp[i] = a ? np : pp[i];
+        ps[i] += a;
+
+        pm[i] = a && np >= lo && np <= hi;
+        n_alive += pm[i];
+    }
+    num_alive = n_alive;
+    return num_alive;
+}
+
+
+/* @brief: reset status of all plants */
+void PlantBatch::reset() {
+    for (eSpinn_size i = 0; i < num; ++i)
+        reset(i);
+}
+
+
+/* @brief: reset status of plant i */
+void PlantBatch::reset(const eSpinn_size &i) {
+    acc[i] = .0;
+    vel[i] = .0;
+    pos[i] = .0;
+    steps[i] = 0;
+    if (!alive[i]) {
+        alive[i] = 1;
+        ++num_alive;
+    }
+}
+
+
+/* @brief: cap state variables of running plants */
+void PlantBatch::rectify() {
+    const double lo = Plant::velRANGE[0], hi = Plant::velRANGE[1];
+    for (eSpinn_size i = 0; i < num; ++i) {
+        const double v = vel[i] < lo ? lo : (vel[i] > hi ? hi : vel[i]);
+        vel[i] = alive[i] ? v : vel[i];
+    }
+}
+
+
+/* @brief: check if state variables out of boundary
+ * mask[i] is set to 1 if plant i is within boundary, 0 otherwise
+ * return num of plants within boundary
+ */
+eSpinn_size PlantBatch::check(std::vector<char> &mask) const {
+    const double lo = Plant::posRANGE[0], hi = Plant::posRANGE[1];
+    mask.resize(num);
+    eSpinn_size n_in = 0;
+    for (eSpinn_size i = 0; i < num; ++i) {
+        mask[i] = pos[i] >= lo && pos[i] <= hi;
+        n_in += mask[i];
+    }
+    return n_in;
+}
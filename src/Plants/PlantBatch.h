@@ -0,0 +1,88 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "eSpinn_def.h"
+#include "Plant.h"
+#include <vector>
+
+/* @brief: PlantBatch
+ * a group of linearized UAV heave models stepped in lockstep
+ * states are kept as arrays of each variable, one entry a plant,
+ * each plant is driven by its own controller output
+ * plants out of boundary are masked out and hold their states,
+ * the others keep running
+ * each plant follows the same dynamics as Plant
+ */
+namespace eSpinn {
+    class PlantBatch {
+    private:
+        /* data */
+        eSpinn_size num;    // num of plants
+        double dt;          // time interval in second
+        std::vector<double> acc, vel, pos;
+        std::vector<char> alive;        // 1 if plant is still running
+        std::vector<eSpinn_size> steps; // num of runs taken
+        eSpinn_size num_alive;
+    public:
+        /* @brief: constructor */
+        PlantBatch(const eSpinn_size &n, const double &del_t = 0.01);
+
+        /* @brief: destructor */
+        ~PlantBatch() = default;
+
+        /* @brief: get num of plants */
+        inline const eSpinn_size size() const { return num; }
+
+        /* @brief: get current acceleration */
+        inline const double getAcc(const eSpinn_size &i) const { return acc[i]; }
+        inline const std::vector<double>& getAcc() const { return acc; }
+
+        /* @brief: get current velocity */
+        inline const double getVel(const eSpinn_size &i) const { return vel[i]; }
+        inline const std::vector<double>& getVel() const { return vel; }
+
+        /* @brief: get current position */
+        inline const double getPos(const eSpinn_size &i) const { return pos[i]; }
+        inline const std::vector<double>& getPos() const { return pos; }
+
+        /* @brief: run running plants for ONE time slot
+         * force[i] drives plant i, ignored if it has failed
+         * plants out of boundary afterwards are masked out
+         * return true if any plant is still running
+         */
+        bool run(const double *force);
+
+        /* @brief: reset status of all plants */
+        void reset();
+
+        /* @brief: reset status of plant i */
+        void reset(const eSpinn_size &i);
+
+        /* @brief: cap state variables of running plants */
+        void rectify();
+
+        /* @brief: check if state variables out of boundary
+         * mask[i] is set to 1 if plant i is within boundary, 0 otherwise
+         * return num of plants within boundary
+         */
+        eSpinn_size check(std::vector<char> &mask) const;
+
+        /* @brief: check if plant i is still running */
+        inline const bool running(const eSpinn_size &i) const { return alive[i]; }
+
+        /* @brief: get running mask, 1 if a plant is still running */
+        inline const std::vector<char>& get_mask() const { return alive; }
+
+        /* @brief: get num of running plants */
+        inline const eSpinn_size num_running() const { return num_alive; }
+
+        /* @brief: get num of runs plant i has taken
+         * including the one that drives it out of boundary
+         */
+        inline const eSpinn_size get_steps(const eSpinn_size &i) const { return steps[i]; }
+    };
+}
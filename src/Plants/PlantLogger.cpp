@@ -9,33 +9,35 @@ using namespace eSpinn;
 
 /* @brief: constructor - allocate memory */
 PlantLogger::PlantLogger(const std::size_t &capacity)
-    : data_length(capacity), val_ref(), val_act(), err()
+    : ref(std::make_shared<RefSignal>(capacity)), val_act(), err(),
+    num_summed(0), sum_abs(.0), sum_sq(.0), sum_cb(.0)
 {
-    val_ref.assign(capacity, .0);
     val_act.assign(capacity, .0);
     err.assign(capacity, .0);
     #ifndef NDEBUG
-    std::cout << "Allocate memory for " << data_length << " data" << std::endl;
+    std::cout << "Allocate memory for " << capacity << " data" << std::endl;
     #endif
 }
 
 
+/* @brief: constructor - share the reference signal */
+PlantLogger::PlantLogger(const std::shared_ptr<const RefSignal> &r)
+    : ref(r), val_act(r->length(), .0), err(r->length(), .0),
+    num_summed(0), sum_abs(.0), sum_sq(.0), sum_cb(.0) { }
+
+
+/* @brief: constructor */
+PlantLogger::PlantLogger()
+    : ref(std::make_shared<RefSignal>()), val_act(), err(),
+    num_summed(0), sum_abs(.0), sum_sq(.0), sum_cb(.0) { }
+
+
 /* @brief: load reference signal from file
  * and assign to val_ref
  * use this method when memory has been allocated
  */
 void PlantLogger::assign_ref_signal(const std::string &inp_file) {
-    std::ifstream ifs(inp_file);
-    if (!ifs) {
-        std::cerr << BnR_ERROR << "can't open file " << inp_file << std::endl;
-        return;
-    }
-    double s;
-    std::size_t i = 0;
-    while (ifs >> s) {
-        val_ref[i++] = s;
-    }
-    ifs.close();
+    ref = std::make_shared<RefSignal>(inp_file, length());
 }
 
 
@@ -43,31 +45,22 @@ void PlantLogger::assign_ref_signal(const std::string &inp_file) {
  * and allocate memory
  */
 void PlantLogger::load_ref_signal(const std::string &inp_file) {
-    std::ifstream ifs(inp_file);
-    if (!ifs) {
-        std::cerr << BnR_ERROR << "can't open file " << inp_file << std::endl;
-        return;
-    }
-    double s;
-    while (ifs >> s) {
-        val_ref.push_back(s);
-    }
-    ifs.close();
+    ref = std::make_shared<RefSignal>(inp_file);
+    val_act.assign(length(), .0);
+    err.assign(length(), .0);
+    num_summed = 0;
+}
 
-    data_length = val_ref.size();
-    val_act.assign(data_length, .0);
-    err.assign(data_length, .0);
 
-    #ifndef NDEBUG
-    std::cout << "Loading data from " << inp_file
-        << ". Data length is " << data_length << std::endl;
-    #endif
+/* @brief: get the reference signal to share */
+std::shared_ptr<const RefSignal> PlantLogger::get_ref() const {
+    return ref;
 }
 
 
 /* @brief: return size of signal */
 std::vector<double>::size_type PlantLogger::length() const {
-    return data_length;
+    return ref->length();
 }
 
 
@@ -77,43 +70,69 @@ void PlantLogger::log_act(const eSpinn_size &ts, const double &o) {
 }
 
 
+/* @brief: get reference signal at the timestep */
+const double PlantLogger::ref_at(const eSpinn_size &ts) const {
+    return ref->at(ts);
+}
+
+
 /* @brief: get actual output at the timestep */
-const double PlantLogger::act_at(const eSpinn_size &ts) {
+const double PlantLogger::act_at(const eSpinn_size &ts) const {
     return val_act[ts];
 }
 
 
 /* @brief: get error at the timestep */
-const double PlantLogger::err_at(const eSpinn_size &ts) {
+const double PlantLogger::err_at(const eSpinn_size &ts) const {
     return err[ts];
 }
 
 
+/* @brief: update the sums with error e at the timestep
+ * an evaluation starts from timestep 0, which restarts the sums,
+ * the sums are dropped if an earlier error is changed
+ */
+void PlantLogger::sum_err(const eSpinn_size &ts, const double &e) {
+    if (!ts || ts < num_summed) {
+        num_summed = 0;
+        sum_abs = sum_sq = sum_cb = .0;
+    }
+    if (ts != num_summed)
+        return;
+    sum_abs += std::abs(e);
+    sum_sq += e * e;
+    sum_cb += e * e * std::abs(e);
+    ++num_summed;
+}
+
+
 /* @brief: log error at the timestep */
 void PlantLogger::log_err(const eSpinn_size &ts, const double &e) {
     err[ts] = e;
+    sum_err(ts, e);
 }
 
 
 /* @brief: calculate error at the timestep */
 const double PlantLogger::cal_err(const eSpinn_size &ts) {
-    err[ts] = val_act[ts] - val_ref[ts];
+    err[ts] = val_act[ts] - ref->at(ts);
+    sum_err(ts, err[ts]);
     return err[ts];
 }
 
 
 /* @brief: calculate mean standard error */
-const double PlantLogger::cal_stde() {
-    double std_err = .0;
-    for (const auto &e : err) {
-        std_err += std::abs(e);
-    }
-    return std_err/length();
+const double PlantLogger::cal_stde() const {
+    return cal_stde(length());
 }
 
 
-/* @brief: calculate mean standard error of the first N elements */
-const double PlantLogger::cal_stde(const eSpinn_size &num) {
+/* @brief: calculate mean standard error of the first N elements
+ * the sum is taken from the on-the-fly sums if they cover N elements
+ */
+const double PlantLogger::cal_stde(const eSpinn_size &num) const {
+    if (num == num_summed)
+        return sum_abs/num;
     double std_err = .0;
     for (auto i = 0; i < num; ++i) {
         std_err += std::abs(err[i]);
@@ -123,17 +142,15 @@ const double PlantLogger::cal_stde(const eSpinn_size &num) {
 
 
 /* @brief: calculate mean square error */
-const double PlantLogger::cal_mse() {
-    double sq_err = .0;
-    for (const auto &e : err) {
-        sq_err += e * e;
-    }
-    return sq_err/length();
+const double PlantLogger::cal_mse() const {
+    return cal_mse(length());
 }
 
 
 /* @brief: calculate mean square error of the first N elements */
-const double PlantLogger::cal_mse(const eSpinn_size &num) {
+const double PlantLogger::cal_mse(const eSpinn_size &num) const {
+    if (num == num_summed)
+        return sum_sq/num;
     double sq_err = .0;
     for (auto i = 0; i < num; ++i) {
         sq_err += err[i] * err[i];
@@ -143,7 +160,9 @@ const double PlantLogger::cal_mse(const eSpinn_size &num) {
 
 
 /* @brief: calculate mean cubic error */
-const double PlantLogger::cal_e3() {
+const double PlantLogger::cal_e3() const {
+    if (length() == num_summed)
+        return sum_cb/length();
     double cb_err = .0;
     for (const auto &e : err) {
         cb_err += e * e * std::abs(e);
@@ -155,7 +174,7 @@ const double PlantLogger::cal_e3() {
 /* @brief: calculate std error
  * call either of the above 3 methods to get std err
  */
-const double PlantLogger::cal_std_err() {
+const double PlantLogger::cal_std_err() const {
     return cal_stde();
     // auto err = cal_mse();
     // return fast_sqrt(err);
@@ -164,8 +183,14 @@ const double PlantLogger::cal_std_err() {
 }
 
 
+/* @brief: calculate std error of the first N elements */
+const double PlantLogger::cal_std_err(const eSpinn_size &num) const {
+    return cal_stde(num);
+}
+
+
 /* @brief: save actual output to file */
-bool PlantLogger::save_act(const std::string &ofile) {
+bool PlantLogger::save_act(const std::string &ofile) const {
     std::ofstream ofs(ofile);
     if (!ofs) {
         std::cerr << BnR_ERROR << "can't open file " << ofile << std::endl;
@@ -178,7 +203,7 @@ bool PlantLogger::save_act(const std::string &ofile) {
 
 
 /* @brief: save error to file */
-bool PlantLogger::save_err(const std::string &ofile) {
+bool PlantLogger::save_err(const std::string &ofile) const {
     std::ofstream ofs(ofile);
     if (!ofs) {
         std::cerr << BnR_ERROR << "can't open file " << ofile << std::endl;
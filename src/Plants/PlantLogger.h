@@ -6,6 +6,8 @@
 #pragma once
 
 #include "Utilities/Utilities.h"
+#include "RefSignal.h"
+#include <memory>
 #include <vector>
 #include <string>
 #include <fstream>
@@ -14,20 +16,34 @@
 /* @brief: PlantLogger
  * archive reference signal from file & actual system output
  * save output to file
+ * the reference signal is shared & read-only,
+ * actual outputs & errors are the scratch of one evaluation,
+ * so concurrent evaluations use loggers sharing one signal
+ * errors calculated in timestep order are summed up on the fly,
+ * so error metrics of them don't loop over the logged errors
  */
 namespace eSpinn {
     class PlantLogger
     {
     private:
         /* data */
-        eSpinn_size data_length;
-        std::vector<double> val_ref, val_act, err;
+        std::shared_ptr<const RefSignal> ref;
+        std::vector<double> val_act, err;
+        // sums of |err|, err^2 & |err|^3 of err[0 ... num_summed)
+        eSpinn_size num_summed;
+        double sum_abs, sum_sq, sum_cb;
+
+        /* @brief: update the sums with error e at the timestep */
+        void sum_err(const eSpinn_size &ts, const double &e);
     public:
         /* @brief: constructor - allocate memory */
         PlantLogger(const std::size_t &capacity);
 
+        /* @brief: constructor - share the reference signal */
+        PlantLogger(const std::shared_ptr<const RefSignal> &r);
+
         /* @brief: constructor */
-        PlantLogger() : val_ref(), val_act(), err() { }
+        PlantLogger();
 
         /* @brief: destructor */
         ~PlantLogger() = default;
@@ -43,17 +59,23 @@ namespace eSpinn {
          */
         void load_ref_signal(const std::string &inp_file);
 
+        /* @brief: get the reference signal to share */
+        std::shared_ptr<const RefSignal> get_ref() const;
+
         /* @brief: return size of signal */
         std::vector<double>::size_type length() const;
 
         /* @brief: log system's actual output */
         void log_act(const eSpinn_size &ts, const double &o);
 
+        /* @brief: get reference signal at the timestep */
+        const double ref_at(const eSpinn_size &ts) const;
+
         /* @brief: get actual output at the timestep */
-        const double act_at(const eSpinn_size &ts);
+        const double act_at(const eSpinn_size &ts) const;
 
         /* @brief: get error at the timestep */
-        const double err_at(const eSpinn_size &ts);
+        const double err_at(const eSpinn_size &ts) const;
 
         /* @brief: log error at the timestep */
         void log_err(const eSpinn_size &ts, const double &e);
@@ -62,29 +84,32 @@ namespace eSpinn {
         const double cal_err(const eSpinn_size &ts);
 
         /* @brief: calculate mean standard error */
-        const double cal_stde();
+        const double cal_stde() const;
 
         /* @brief: calculate mean standard error of the first N elements */
-        const double cal_stde(const eSpinn_size &num);
+        const double cal_stde(const eSpinn_size &num) const;
 
         /* @brief: calculate mean square error */
-        const double cal_mse();
+        const double cal_mse() const;
 
         /* @brief: calculate mean square error of the first N elements */
-        const double cal_mse(const eSpinn_size &num);
+        const double cal_mse(const eSpinn_size &num) const;
 
         /* @brief: calculate mean cubic error */
-        const double cal_e3();
+        const double cal_e3() const;
 
         /* @brief: calculate std error
          * call either of the above 3 methods to get std err
          */
-        const double cal_std_err();
+        const double cal_std_err() const;
+
+        /* @brief: calculate std error of the first N elements */
+        const double cal_std_err(const eSpinn_size &num) const;
 
         /* @brief: save actual output to file */
-        bool save_act(const std::string &ofile);
+        bool save_act(const std::string &ofile) const;
 
         /* @brief: save error to file */
-        bool save_err(const std::string &ofile);
+        bool save_err(const std::string &ofile) const;
     };
 }
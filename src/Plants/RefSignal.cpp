@@ -0,0 +1,53 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "RefSignal.h"
+#include <fstream>
+
+using namespace eSpinn;
+
+
+/* @brief: constructor - a signal of zeros */
+RefSignal::RefSignal(const std::size_t &length) : val(length, .0) { }
+
+
+/* @brief: constructor - load signal from file */
+RefSignal::RefSignal(const std::string &inp_file) : val() {
+    std::ifstream ifs(inp_file);
+    if (!ifs) {
+        std::cerr << BnR_ERROR << "can't open file " << inp_file << std::endl;
+        return;
+    }
+    double s;
+    while (ifs >> s) {
+        val.push_back(s);
+    }
+    ifs.close();
+
+    #ifndef NDEBUG
+    std::cout << "Loading data from " << inp_file
+        << ". Data length is " << val.size() << std::endl;
+    #endif
+}
+
+
+/* @brief: constructor - load at most length values from file
+ * the rest are zeros
+ */
+RefSignal::RefSignal(const std::string &inp_file, const std::size_t &length) :
+    val(length, .0)
+{
+    std::ifstream ifs(inp_file);
+    if (!ifs) {
+        std::cerr << BnR_ERROR << "can't open file " << inp_file << std::endl;
+        return;
+    }
+    double s;
+    std::size_t i = 0;
+    while (i < length && ifs >> s) {
+        val[i++] = s;
+    }
+    ifs.close();
+}
@@ -0,0 +1,47 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "Utilities/Utilities.h"
+#include <vector>
+#include <string>
+
+/* @brief: RefSignal
+ * reference signal loaded from file
+ * it is not changed once loaded,
+ * so one signal can be shared by loggers of concurrent evaluations
+ */
+namespace eSpinn {
+    class RefSignal
+    {
+    private:
+        /* data */
+        std::vector<double> val;
+    public:
+        /* @brief: constructor - a signal of zeros */
+        RefSignal(const std::size_t &length = 0);
+
+        /* @brief: constructor - load signal from file */
+        RefSignal(const std::string &inp_file);
+
+        /* @brief: constructor - load at most length values from file
+         * the rest are zeros
+         */
+        RefSignal(const std::string &inp_file, const std::size_t &length);
+
+        /* @brief: destructor */
+        ~RefSignal() = default;
+
+        /* @brief: return size of signal */
+        inline std::vector<double>::size_type length() const { return val.size(); }
+
+        /* @brief: get reference signal at the timestep */
+        inline const double at(const eSpinn_size &ts) const { return val[ts]; }
+
+        /* @brief: get the signal */
+        inline const double* data() const { return val.data(); }
+    };
+}
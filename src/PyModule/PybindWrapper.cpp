@@ -199,6 +199,7 @@ PYBIND11_MODULE(PyeSpinn, m) {
         )
         .def_property("fit", &OrganismBase::getFit, &OrganismBase::setFit)
         .def("save", &OrganismBase::save)
+        .def("archive_binary", &OrganismBase::archive_binary)
     ;
 
     /* @brief: class Organism binding */
@@ -238,12 +239,17 @@ PYBIND11_MODULE(PyeSpinn, m) {
         .def("init", &Population::init)
         .def("load", &Population::load)
         .def("archive", &Population::archive)
+        .def("archive_binary",
+            (void (Population::*)(const std::string &) const) &Population::archive_binary)
 
         .def("gen", &Population::getGen)
         .def("size", &Population::size)
         .def("issolved", &Population::issolved)
         .def("set_solved", &Population::set_solved)
         .def("epoch", &Population::epoch)
+        .def("set_seed", &Population::set_seed)
+        .def("get_seed", &Population::get_seed)
+        .def("set_threads", &Population::set_threads)
 
         .def("get_champ_fit", &Population::get_champ_fit)
         .def("get_champ_org", &Population::get_champ_org,
@@ -252,6 +258,26 @@ PYBIND11_MODULE(PyeSpinn, m) {
         .def_readwrite("species", &Population::species)
     ;
 
+    /* @brief: class ChampionStore binding */
+    pybind11::class_<ChampionStore>(m, "ChampionStore")
+        .def(pybind11::init<const std::string &, const bool>(),
+            pybind11::arg("file"), pybind11::arg("append")=true)
+        .def("add",
+            (bool (ChampionStore::*)(const OrganismBase &, const eSpinn_size &, const bool))
+            &ChampionStore::add,
+            pybind11::arg("o"), pybind11::arg("gen"), pybind11::arg("champ")=false)
+        .def("add_pop",
+            (bool (ChampionStore::*)(const Population &, const eSpinn_size &))
+            &ChampionStore::add)
+        .def("size", &ChampionStore::size)
+        .def("load",
+            (OrganismBase* (ChampionStore::*)(const eSpinn_size &, const netID &))
+            &ChampionStore::load)
+        .def("load_champ", &ChampionStore::load_champ)
+        .def("load_latest_champ", &ChampionStore::load_latest_champ)
+        .def("load_best", &ChampionStore::load_best)
+    ;
+
     /* @brief: class Injector binding */
     pybind11::class_<Injector>(m, "Injector")
         .def(pybind11::init<const eSpinn_size &>())
@@ -285,6 +311,87 @@ PYBIND11_MODULE(PyeSpinn, m) {
 
     m.def("createInjector", &createInjector, "Create injector from file");
 
+    /* @brief: class Environment binding */
+    pybind11::class_<Environment>(m, "Environment")
+        .def("reset", &Environment::reset)
+        .def("done", &Environment::done)
+        .def("score", &Environment::score)
+    ;
+
+    /* @brief: class SampleHold binding
+     * controller outputs held between samples
+     */
+    pybind11::class_<SampleHold> hold(m, "SampleHold");
+    // register Mode before it is used as a default arg
+    pybind11::enum_<SampleHold::Mode>(hold, "Mode")
+        .value("ZOH", SampleHold::ZOH)
+        .value("RAMP", SampleHold::RAMP)
+        .value("EXTRAPOLATE", SampleHold::EXTRAPOLATE)
+        .export_values()
+    ;
+    hold
+        .def(pybind11::init<const eSpinn_size &, const SampleHold::Mode &>(),
+            pybind11::arg("period")=1, pybind11::arg("mode")=SampleHold::ZOH)
+        .def("set_period", &SampleHold::set_period)
+        .def("get_period", &SampleHold::get_period)
+        .def("set_mode", &SampleHold::set_mode)
+        .def("get_mode", &SampleHold::get_mode)
+    ;
+
+    /* @brief: class FlappyBird binding
+     * headless game of a flock of birds
+     */
+    pybind11::class_<FlappyBird>(m, "FlappyBird")
+        .def(pybind11::init<const eSpinn_size &, const std::uint64_t &>(),
+            pybind11::arg("num"), pybind11::arg("seed")=0)
+        .def("__repr__",
+            [](const FlappyBird &g) {
+                return "<eSpinn.FlappyBird (size = " + std::to_string(g.size())
+                    + ", frames = " + std::to_string(g.get_frames()) + ")>";
+            }
+        )
+        .def("size", &FlappyBird::size)
+        .def("set_seed", &FlappyBird::set_seed)
+        .def("reset", &FlappyBird::reset)
+        .def("get_states",
+            [](const FlappyBird &g) {
+                std::vector<double> states(2 * g.size());
+                g.get_states(states.data(), 2);
+                return states;
+            },
+            "get err_x & err_y of all birds"
+        )
+        .def("update",
+            [](FlappyBird &g, const std::vector<bool> &flap) {
+                std::vector<char> f(flap.begin(), flap.end());
+                f.resize(g.size());
+                return g.update(f.data());
+            },
+            "update the game for ONE frame"
+        )
+        .def("frames", &FlappyBird::get_frames)
+        .def("y", &FlappyBird::getY)
+        .def("running", &FlappyBird::running)
+        .def("num_running", &FlappyBird::num_running)
+        .def("dist", &FlappyBird::get_dist)
+    ;
+
+    /* @brief: class FlappyEnv binding */
+    pybind11::class_<FlappyEnv, Environment>(m, "FlappyEnv")
+        .def(pybind11::init<const std::uint64_t &>(),
+            pybind11::arg("seed")=0)
+        .def("set_seed", &FlappyEnv::set_seed)
+        .def_readonly_static("MAX_DIST", &FlappyEnv::MAX_DIST)
+    ;
+
+    /* @brief: class ClosedLoopEvaluator binding */
+    decl_evaluator<SigmNetwork>(m, "Sigm");
+    decl_evaluator<LinrNetwork>(m, "Linr");
+    decl_evaluator<IzhiNetwork>(m, "Izhi");
+    decl_evaluator<LifNetwork>(m, "Lif");
+    decl_evaluator<HybridNetwork>(m, "Hybrid");
+    decl_evaluator<HybLinNetwork>(m, "HybLin");
+
     /* @brief: class Injector binding */
     pybind11::class_<Logger>(m, "Logger")
         .def(pybind11::init<const std::size_t &>(),
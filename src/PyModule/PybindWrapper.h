@@ -167,5 +167,51 @@ namespace eSpinn {
             .def("save", &Organism<T>::save)
         ;
     }
+
+
+    /* @brief: Declare Pybind module for template class ClosedLoopEvaluator<T> */
+    template <typename T>
+    void decl_evaluator(pybind11::module &m, const std::string &typestr) {
+        typedef ClosedLoopEvaluator<T> E;
+        std::string pyclass = typestr + "Evaluator";
+        pybind11::class_<E> evaluator(m, pyclass.c_str());
+        pybind11::enum_<typename E::Mode>(evaluator, "Mode")
+            .value("SERIAL", E::SERIAL)
+            .value("PARALLEL", E::PARALLEL)
+            .value("BATCHED", E::BATCHED)
+            .export_values()
+        ;
+        pybind11::enum_<typename E::Aggregate>(evaluator, "Aggregate")
+            .value("MEAN", E::MEAN)
+            .value("MIN", E::MIN)
+            .value("QUANTILE", E::QUANTILE)
+            .export_values()
+        ;
+        evaluator
+            .def(pybind11::init<const Environment &, const typename E::Mode &,
+                const eSpinn_size &>(),
+                pybind11::arg("env"), pybind11::arg("mode")=E::SERIAL,
+                pybind11::arg("threads")=0)
+            .def("__repr__",
+                [pyclass](const E &e) {
+                    return "<eSpinn." + pyclass + ">";
+                }
+            )
+            .def("set_mode", &E::set_mode)
+            .def("set_threads", &E::set_threads)
+            .def("set_control", &E::set_control,
+                pybind11::arg("period"), pybind11::arg("mode")=SampleHold::ZOH)
+            .def("set_episodes", &E::set_episodes,
+                pybind11::arg("k"), pybind11::arg("agg")=E::MEAN,
+                pybind11::arg("q")=.5)
+            .def("set_env", &E::set_env)
+            .def("evaluate",
+                (const double (E::*)(Organism<T> *)) &E::evaluate,
+                "evaluate organism in an episode")
+            .def("evaluate",
+                (bool (E::*)(Population *, const double &)) &E::evaluate,
+                "evaluate population, return true if solved")
+        ;
+    }
 }
 
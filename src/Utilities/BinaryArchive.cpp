@@ -0,0 +1,167 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "BinaryArchive.h"
+#include "Utilities.h"
+#include <fstream>
+#include <iostream>
+using namespace eSpinn;
+
+
+/* @brief: check if file is a binary archive
+ * i.e. it starts with the magic number
+ */
+bool eSpinn::is_binary_archive(const std::string &ifile) {
+    std::ifstream ifs(ifile, std::ios::binary);
+    char m[sizeof(binarch::magic)] = {};
+    if (!ifs.read(m, sizeof(m)))
+        return false;
+    return !std::memcmp(m, binarch::magic, sizeof(m));
+}
+
+
+/* @brief: constructor - write the header */
+BinaryWriter::BinaryWriter(const binarch::contentType &c) : buf() {
+    append(binarch::magic, sizeof(binarch::magic));
+    write(binarch::version);
+    write(c);
+}
+
+
+/* @brief: write a string, prefixed with its size */
+void BinaryWriter::write(const std::string &s) {
+    write(static_cast<std::uint64_t>(s.size()));
+    append(s.data(), s.size());
+}
+
+
+/* @brief: begin a length-prefixed record
+ * return the position of the length, used to end the record
+ */
+std::size_t BinaryWriter::begin_record() {
+    const auto p = buf.size();
+    write(std::uint32_t(0));
+    return p;
+}
+
+
+/* @brief: end a record, i.e. write its length */
+void BinaryWriter::end_record(const std::size_t &p) {
+    const auto len = static_cast<std::uint32_t>(buf.size() - p - sizeof(std::uint32_t));
+    std::memcpy(buf.data() + p, &len, sizeof(len));
+}
+
+
+/* @brief: save the buffer to file
+ * return false if file can't be written
+ */
+bool BinaryWriter::save(const std::string &ofile) const {
+    std::ofstream ofs(ofile, std::ios::binary);
+    if (!ofs) {
+        std::cerr << BnR_ERROR << "Can't open file " << ofile << std::endl;
+        return false;
+    }
+    ofs.write(buf.data(), buf.size());
+    return static_cast<bool>(ofs);
+}
+
+
+/* @brief: move the buffer out, e.g. to read it with a BinaryReader
+ * the writer is empty afterwards
+ */
+std::vector<char> BinaryWriter::release() {
+    std::vector<char> b;
+    b.swap(buf);
+    return b;
+}
+
+
+/* @brief: constructor - load the file and read the header
+ * the reader fails if the file is not a binary archive
+ */
+BinaryReader::BinaryReader(const std::string &ifile) :
+    buf(), pos(0), ver(0), content(), good(true)
+{
+    std::ifstream ifs(ifile, std::ios::binary | std::ios::ate);
+    if (!ifs) {
+        std::cerr << BnR_ERROR << "Can't open file " << ifile << std::endl;
+        good = false;
+        return;
+    }
+    buf.resize(static_cast<std::size_t>(ifs.tellg()));
+    ifs.seekg(0);
+    ifs.read(buf.data(), buf.size());
+    if (!read_header())
+        std::cerr << BnR_ERROR << ifile << " is not a binary archive" << std::endl;
+}
+
+
+/* @brief: constructor - read from a buffer written by a BinaryWriter
+ * the reader fails if the buffer is not a binary archive
+ */
+BinaryReader::BinaryReader(std::vector<char> &&b) :
+    buf(std::move(b)), pos(0), ver(0), content(), good(true)
+{
+    if (!read_header())
+        std::cerr << BnR_ERROR << "Buffer is not a binary archive" << std::endl;
+}
+
+
+/* @brief: read the header
+ * return false if the buffer is not a binary archive
+ */
+bool BinaryReader::read_header() {
+    char m[sizeof(binarch::magic)];
+    take(m, sizeof(m));
+    if (!good || std::memcmp(m, binarch::magic, sizeof(m))) {
+        good = false;
+        return false;
+    }
+    read(ver);
+    read(content);
+    return good;
+}
+
+
+/* @brief: read a string prefixed with its size */
+void BinaryReader::read(std::string &s) {
+    std::uint64_t n = 0;
+    read(n);
+    if (!good || n > buf.size() - pos) {
+        good = false;
+        s.clear();
+        return;
+    }
+    s.assign(buf.data() + pos, n);
+    pos += n;
+}
+
+
+/* @brief: begin a length-prefixed record
+ * return the position where the record ends
+ */
+std::size_t BinaryReader::begin_record() {
+    std::uint32_t len = 0;
+    read(len);
+    if (!good || len > buf.size() - pos) {
+        good = false;
+        return pos;
+    }
+    return pos + len;
+}
+
+
+/* @brief: end a record
+ * skip the fields that are not read, i.e. written by a newer version
+ */
+void BinaryReader::end_record(const std::size_t &end) {
+    if (!good)
+        return;
+    // read past the record, the archive is corrupted
+    if (pos > end)
+        good = false;
+    else
+        pos = end;
+}
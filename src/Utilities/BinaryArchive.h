@@ -0,0 +1,200 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "eSpinn_def.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/* @brief: binary archives
+ * versioned, length-prefixed binary format used to archive
+ * populations & organisms much faster than boost text archives
+ * there is no pointer tracking, links are rebuilt from ids when loading
+ * layout: header (magic, version, content), then records
+ * each record is prefixed with its length in bytes,
+ * new versions only append fields to records,
+ * so that readers of an older version skip the fields they don't know
+ * values are written in the native byte order (little-endian on x86 & arm)
+ */
+namespace eSpinn {
+    namespace binarch {
+        constexpr char magic[4] = {'E', 'S', 'P', 'B'};
+        constexpr std::uint32_t version = 1;
+
+        /* @brief: content of an archive */
+        enum contentType : std::uint32_t {
+            POPULATION = 1,
+            ORGANISM = 2,
+            CHECKPOINT_DELTA = 3,
+            CHAMPION_STORE = 4,
+            CHAMPION_INDEX = 5
+        };
+    }
+
+    /* @brief: check if file is a binary archive
+     * i.e. it starts with the magic number
+     */
+    bool is_binary_archive(const std::string &ifile);
+
+
+    /* @brief: BinaryWriter
+     * write values to a memory buffer, then save the buffer to file at once
+     * initialization list: content type
+     */
+    class BinaryWriter
+    {
+    private:
+        /* data */
+        std::vector<char> buf;
+
+        /* @brief: append raw bytes */
+        inline void append(const void *p, const std::size_t &len) {
+            const auto *c = static_cast<const char*>(p);
+            buf.insert(buf.end(), c, c + len);
+        }
+    public:
+        /* @brief: constructor - write the header */
+        BinaryWriter(const binarch::contentType &c);
+
+        /* @brief: write a trivially copyable value */
+        template <typename T>
+        void write(const T &v) {
+            static_assert(std::is_trivially_copyable<T>::value,
+                "BinaryWriter only writes trivially copyable values");
+            append(&v, sizeof(T));
+        }
+
+        /* @brief: write a vector, prefixed with its size */
+        template <typename T>
+        void write(const std::vector<T> &v) {
+            static_assert(std::is_trivially_copyable<T>::value,
+                "BinaryWriter only writes trivially copyable values");
+            write(static_cast<std::uint64_t>(v.size()));
+            if (!v.empty())
+                append(v.data(), v.size() * sizeof(T));
+        }
+
+        /* @brief: write a string, prefixed with its size */
+        void write(const std::string &s);
+
+        /* @brief: begin a length-prefixed record
+         * return the position of the length, used to end the record
+         */
+        std::size_t begin_record();
+
+        /* @brief: end a record, i.e. write its length */
+        void end_record(const std::size_t &pos);
+
+        /* @brief: get the num of bytes written */
+        inline const std::size_t size() const { return buf.size(); }
+
+        /* @brief: save the buffer to file
+         * return false if file can't be written
+         */
+        bool save(const std::string &ofile) const;
+
+        /* @brief: move the buffer out, e.g. to read it with a BinaryReader
+         * the writer is empty afterwards
+         */
+        std::vector<char> release();
+    };
+
+
+    /* @brief: BinaryReader
+     * read the whole file into memory and read values from it
+     * reading past the end, or a mismatched record, marks the reader as failed
+     * and values read afterwards are zero
+     */
+    class BinaryReader
+    {
+    private:
+        /* data */
+        std::vector<char> buf;
+        std::size_t pos;
+        std::uint32_t ver;
+        binarch::contentType content;
+        bool good;
+
+        /* @brief: read the header
+         * return false if the buffer is not a binary archive
+         */
+        bool read_header();
+
+        /* @brief: copy raw bytes
+         * return false if there are not enough bytes
+         */
+        inline bool take(void *p, const std::size_t &len) {
+            if (!good || len > buf.size() - pos) {
+                good = false;
+                std::memset(p, 0, len);
+                return false;
+            }
+            std::memcpy(p, buf.data() + pos, len);
+            pos += len;
+            return true;
+        }
+    public:
+        /* @brief: constructor - load the file and read the header
+         * the reader fails if the file is not a binary archive
+         */
+        BinaryReader(const std::string &ifile);
+
+        /* @brief: constructor - read from a buffer written by a BinaryWriter
+         * the reader fails if the buffer is not a binary archive
+         */
+        BinaryReader(std::vector<char> &&b);
+
+        /* @brief: check if everything has been read successfully */
+        inline const bool ok() const { return good; }
+
+        /* @brief: get the version of the archive */
+        inline const std::uint32_t version() const { return ver; }
+
+        /* @brief: get the content type of the archive */
+        inline const binarch::contentType getContent() const { return content; }
+
+        /* @brief: read a trivially copyable value */
+        template <typename T>
+        void read(T &v) {
+            static_assert(std::is_trivially_copyable<T>::value,
+                "BinaryReader only reads trivially copyable values");
+            take(&v, sizeof(T));
+        }
+
+        /* @brief: read a vector prefixed with its size */
+        template <typename T>
+        void read(std::vector<T> &v) {
+            static_assert(std::is_trivially_copyable<T>::value,
+                "BinaryReader only reads trivially copyable values");
+            std::uint64_t n = 0;
+            read(n);
+            if (!good || n > (buf.size() - pos) / sizeof(T)) {
+                good = false;
+                v.clear();
+                return;
+            }
+            v.resize(n);
+            if (n)
+                take(v.data(), n * sizeof(T));
+        }
+
+        /* @brief: read a string prefixed with its size */
+        void read(std::string &s);
+
+        /* @brief: begin a length-prefixed record
+         * return the position where the record ends
+         */
+        std::size_t begin_record();
+
+        /* @brief: end a record
+         * skip the fields that are not read, i.e. written by a newer version
+         */
+        void end_record(const std::size_t &end);
+    };
+}
@@ -0,0 +1,44 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace eSpinn;
+
+
+/* @brief: map file
+ * return false if file can't be mapped, e.g. missing or empty
+ */
+bool MappedFile::map(const std::string &file) {
+    unmap();
+    const int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping stays valid after the file is closed
+    close(fd);
+    if (p == MAP_FAILED)
+        return false;
+    ptr = static_cast<const char*>(p);
+    len = st.st_size;
+    return true;
+}
+
+
+/* @brief: unmap file */
+void MappedFile::unmap() {
+    if (ptr)
+        munmap(const_cast<char*>(ptr), len);
+    ptr = nullptr;
+    len = 0;
+}
@@ -0,0 +1,52 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <string>
+
+/* @brief: MappedFile
+ * map a file read-only into memory
+ * pages are loaded by the OS when they are accessed,
+ * so reading a small part of a large file is fast
+ * the file is unmapped when the object is destroyed
+ */
+namespace eSpinn {
+    class MappedFile
+    {
+    private:
+        /* data */
+        const char *ptr;
+        std::size_t len;
+    public:
+        /* @brief: constructor */
+        MappedFile() : ptr(nullptr), len(0) { }
+
+        /* @brief: deleted copy constructor */
+        MappedFile(const MappedFile &) = delete;
+
+        /* @brief: destructor */
+        ~MappedFile() { unmap(); }
+
+        /* @brief: map file
+         * return false if file can't be mapped, e.g. missing or empty
+         */
+        bool map(const std::string &file);
+
+        /* @brief: unmap file */
+        void unmap();
+
+        /* @brief: check if a file is mapped */
+        inline const bool ok() const { return ptr != nullptr; }
+
+        /* @brief: get the mapped bytes */
+        inline const char* data() const { return ptr; }
+
+        /* @brief: get the num of mapped bytes */
+        inline const std::size_t size() const { return len; }
+    };
+}
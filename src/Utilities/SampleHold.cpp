@@ -0,0 +1,82 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "SampleHold.h"
+using namespace eSpinn;
+
+
+/* @brief: constructor
+ * a period of 0 is taken as 1
+ */
+SampleHold::SampleHold(const eSpinn_size &p, const Mode &m) :
+    period(p ? p : 1), mode(m), phase(0), sampled(false),
+    prev(), cur(), outp() { }
+
+
+/* @brief: set num of time slots per sample
+ * 0 is taken as 1
+ */
+void SampleHold::set_period(const eSpinn_size &p) {
+    period = p ? p : 1;
+    reset();
+}
+
+
+/* @brief: set outputs of the time slots between samples */
+void SampleHold::set_mode(const Mode &m) {
+    mode = m;
+    reset();
+}
+
+
+/* @brief: start a new episode, the next time slot is sampled */
+void SampleHold::reset() {
+    phase = 0;
+    sampled = false;
+}
+
+
+/* @brief: write outputs of the current phase to outp
+ * RAMP reaches the latest sample at the end of the period,
+ * EXTRAPOLATE starts from it
+ */
+void SampleHold::interpolate() {
+    const double frac = mode == RAMP ?
+        static_cast<double>(phase + 1) / period : static_cast<double>(phase) / period;
+    const auto &base = mode == RAMP ? prev : cur;
+    for (eSpinn_size i = 0; i < cur.size(); ++i)
+        outp[i] = base[i] + (cur[i] - prev[i]) * frac;
+}
+
+
+/* @brief: take controller outputs u[0 ... n) of this time slot
+ * return outputs of this time slot
+ * u is passed through if sampled every time slot,
+ * the first sample of an episode is also its previous one
+ */
+const double *SampleHold::sample(const double *u, const eSpinn_size &n) {
+    if (period == 1)
+        return u;
+    if (sampled)
+        prev.swap(cur);
+    cur.assign(u, u + n);
+    if (!sampled)
+        prev = cur;
+    sampled = true;
+    return hold();
+}
+
+
+/* @brief: return outputs of a time slot between samples */
+const double *SampleHold::hold() {
+    const double *u = cur.data();
+    if (mode != ZOH) {
+        outp.resize(cur.size());
+        interpolate();
+        u = outp.data();
+    }
+    phase = (phase + 1) % period;
+    return u;
+}
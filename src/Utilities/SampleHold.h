@@ -0,0 +1,77 @@
+/* Copyright (C) 2017-2020 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "eSpinn_def.h"
+#include <vector>
+
+/* @brief: SampleHold
+ * run the controller at a lower rate than the plant is integrated
+ * the controller is sampled every period time slots of the plant,
+ * outputs of the time slots in between are
+ *   - ZOH: the latest sample, i.e. zero-order hold
+ *   - RAMP: interpolated from the previous sample to the latest one,
+ *     continuous but delayed by a period
+ *   - EXTRAPOLATE: extrapolated from the previous & the latest samples
+ * a period of 1 samples every time slot, i.e. outputs are passed through
+ * usage at every time slot:
+ *   u = hold.due() ? hold.sample(controller outputs, n) : hold.hold();
+ * initialization list: period, mode
+ */
+namespace eSpinn {
+    class SampleHold {
+    public:
+        /* @brief: outputs of the time slots between samples */
+        enum Mode {
+            ZOH = 0,
+            RAMP,
+            EXTRAPOLATE
+        };
+    private:
+        /* data */
+        eSpinn_size period;
+        Mode mode;
+        eSpinn_size phase; // time slots since the latest sample
+        bool sampled;
+        std::vector<double> prev, cur, outp;
+
+        /* @brief: write outputs of the current phase to outp */
+        void interpolate();
+    public:
+        /* @brief: constructor
+         * a period of 0 is taken as 1
+         */
+        SampleHold(const eSpinn_size &p = 1, const Mode &m = ZOH);
+
+        /* @brief: set num of time slots per sample
+         * 0 is taken as 1
+         */
+        void set_period(const eSpinn_size &p);
+
+        /* @brief: get num of time slots per sample */
+        inline const eSpinn_size get_period() const { return period; }
+
+        /* @brief: set outputs of the time slots between samples */
+        void set_mode(const Mode &m);
+
+        /* @brief: get outputs of the time slots between samples */
+        inline const Mode get_mode() const { return mode; }
+
+        /* @brief: start a new episode, the next time slot is sampled */
+        void reset();
+
+        /* @brief: check if the controller is sampled at this time slot */
+        inline bool due() const { return !phase; }
+
+        /* @brief: take controller outputs u[0 ... n) of this time slot
+         * return outputs of this time slot
+         */
+        const double *sample(const double *u, const eSpinn_size &n);
+
+        /* @brief: return outputs of a time slot between samples */
+        const double *hold();
+    };
+}
@@ -41,11 +41,10 @@ const float eSpinn::fast_sqrt(const float &x) {
  * using normal distribution
  */
 std::shared_ptr<std::vector<double>> eSpinn::rand_normal(const double &mean, const double &dev, const eSpinn_size &s) {
-    static std::mt19937 e;
     std::normal_distribution<double> u(mean, dev);
     auto vals = std::make_shared<std::vector<double>>();
     for (eSpinn_size i = 0; i < s; ++i) {
-        vals->push_back(u(e));
+        vals->push_back(u(rand_engine()));
     }
     return vals;
 }
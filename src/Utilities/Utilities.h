@@ -7,6 +7,7 @@
 
 
 #include "eSpinn_def.h"
+#include <cstdint>
 #include <random>
 #include <memory>
 #include <string>
@@ -43,44 +44,70 @@ namespace eSpinn {
     const float fast_sqrt(const float &x);
 
 
+    /* return a seed drawn from std::random_device */
+    inline const std::uint64_t random_seed() {
+        std::random_device rd{};
+        return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+    }
+
+    /* return the random engine of the calling thread
+     * all random functions draw from it, and threads do not share streams
+     * it's seeded from std::random_device, so runs differ
+     * unless the engine is seeded with seed_rand()
+     */
+    inline std::mt19937& rand_engine() {
+        static thread_local std::mt19937 e = [] {
+            const auto s = random_seed();
+            std::seed_seq seq{static_cast<std::uint32_t>(s),
+                static_cast<std::uint32_t>(s >> 32)};
+            return std::mt19937(seq);
+        }();
+        return e;
+    }
+
+    /* seed the random engine of the calling thread */
+    inline void seed_rand(const std::uint64_t &s) {
+        std::seed_seq seq{static_cast<std::uint32_t>(s),
+            static_cast<std::uint32_t>(s >> 32)};
+        rand_engine().seed(seq);
+    }
+
+    /* return a seed drawn from the random engine of the calling thread */
+    inline const std::uint64_t draw_seed() {
+        const std::uint64_t hi = rand_engine()();
+        return (hi << 32) | rand_engine()();
+    }
+
     /* return a random real value between [0, 1]
      * using uniform distribution
      */
     inline const double rand() {
-        static std::mt19937 e;
-        static std::uniform_real_distribution<double> u(.0, 1.0);
-        return u(e);
+        std::uniform_real_distribution<double> u(.0, 1.0);
+        return u(rand_engine());
     }
 
     /* return a random integer between [min, max]
      * using uniform distribution
      */
     inline const int rand(const int &min, const int &max) {
-        std::random_device rd{};
-        std::mt19937 e{rd()};
-        // static std::mt19937 e;
-        // static std::default_random_engine e;
         std::uniform_int_distribution<int> u(min, max);
-        return u(e);
+        return u(rand_engine());
     }
 
     /* return a random real value between [min, max]
      * using uniform distribution
      */
     inline const double rand(const double &min, const double &max) {
-        std::random_device rd{};
-        std::mt19937 e{rd()};
         std::uniform_real_distribution<double> u(min, max);
-        return u(e);
+        return u(rand_engine());
     }
 
     /* return a random real value with mean and deviation
      * using normal distribution
      */
     inline const double rand_normal(const double &mean, const double &dev) {
-        static std::mt19937 e;
         std::normal_distribution<double> u(mean, dev);
-        return u(e);
+        return u(rand_engine());
     }
 
     /* return a smart pointer to a vector
@@ -92,16 +119,14 @@ namespace eSpinn {
 
     /* return a random weight value between [-1.0, 1.0] */
     inline const double randWeight() {
-        static std::mt19937 e;
-        static std::uniform_real_distribution<double> u(-1.0, 1.0);
-        return u(e);
+        std::uniform_real_distribution<double> u(-1.0, 1.0);
+        return u(rand_engine());
     }
 
     /* return a random lambda value between [MIN_LAMBDA, MAX_LAMBDA] */
     inline const double randLambda() {
-        static std::mt19937 e;
-        static std::uniform_real_distribution<double> u(params::MIN_LAMBDA, params::MAX_LAMBDA);
-        return u(e);
+        std::uniform_real_distribution<double> u(params::MIN_LAMBDA, params::MAX_LAMBDA);
+        return u(rand_engine());
     }
 
     /* return a random int value between [0, MAX_DELAY] */
@@ -115,9 +140,41 @@ namespace eSpinn {
 
     /* return a random value for plastic Connection */
     inline const double rand_plastic_term() {
-        static std::mt19937 e;
-        static std::uniform_real_distribution<double> u(-1.0, 1.0);
-        return u(e);
+        std::uniform_real_distribution<double> u(-1.0, 1.0);
+        return u(rand_engine());
+    }
+
+
+    /* return the 64-bit FNV-1a hash of a block of memory
+     * pass the previous hash as h to chain blocks
+     * https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+     */
+    inline const std::uint64_t fnv1a(const void *data, const std::size_t &len,
+        std::uint64_t h = 14695981039346656037ULL)
+    {
+        auto p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < len; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    /* return the FNV-1a hash of vector elements chained to h */
+    template <typename T>
+    inline const std::uint64_t fnv1a(const std::vector<T> &v, const std::uint64_t &h) {
+        return fnv1a(v.data(), v.size()*sizeof(T), h);
+    }
+
+    /* return the i-th value of the SplitMix64 random stream of seed s
+     * values do not depend on each other, so a block of them is made in bulk
+     * http://prng.di.unimi.it/splitmix64.c
+     */
+    inline const std::uint64_t splitmix64(const std::uint64_t &s, const std::uint64_t &i) {
+        std::uint64_t z = s + (i + 1) * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
     }
 
 
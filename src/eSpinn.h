@@ -19,20 +19,44 @@
 #include "Models/NetworkBase.h"
 #include "Models/Network.h"
 #include "Models/WeightWatcher.h"
+#include "Models/NetworkBatch.h"
+#include "Learning/Genome.h"
+#include "Learning/MutationEngine.h"
+#include "Learning/FitnessCache.h"
 #include "Learning/Organism.h"
 #include "Learning/OrganismBase.h"
+#include "Learning/OrganismPool.h"
 #include "Learning/Innovation.h"
 #include "Learning/Species.h"
 #include "Learning/Population.h"
+#include "Learning/Island.h"
+#include "Learning/SteadyStateScheduler.h"
+#include "Learning/CheckpointStore.h"
+#include "Learning/AsyncArchiver.h"
+#include "Learning/ChampionStore.h"
+#include "Learning/SurvivalCutoff.h"
+#include "Learning/FidelitySchedule.h"
+#include "Learning/TraceRecorder.h"
+#include "Learning/ClosedLoopEvaluator.h"
 #include "Utilities/Gate.h"
 #include "Utilities/Injector.h"
 #include "Utilities/Ejector.h"
 #include "Utilities/Utilities.h"
+#include "Utilities/BinaryArchive.h"
+#include "Utilities/MappedFile.h"
 #include "Utilities/Logger.h"
 #include "Utilities/OutputBuffer.h"
+#include "Utilities/SampleHold.h"
+#include "Plants/Environment.h"
+#include "Plants/RefSignal.h"
 #include "Plants/PlantLogger.h"
 #include "Plants/Plant.h"
+#include "Plants/PlantBatch.h"
 #include "Plants/CartPole.h"
 #include "Plants/CartPoleLogger.h"
+#include "Plants/CartPoleBatch.h"
 #include "Plants/Hexacopter.h"
+#include "Plants/HexacopterBatch.h"
+#include "Plants/FlappyBird.h"
+#include "Plants/FlappyEnv.h"
 #include "files_def.h"
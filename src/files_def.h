@@ -14,6 +14,7 @@ namespace eSpinn {
     const std::string DIR_ASSET("./asset/");
     const std::string DIR_DATA("./asset/data/");
     const std::string DIR_ARCHIVE("./asset/archive/");
+    const std::string DIR_ISLAND("./asset/island/");
 
     const std::string FILE_IN   (DIR_DATA + "in");
     const std::string FILE_OUT  (DIR_DATA + "out");
@@ -36,5 +37,6 @@ namespace eSpinn {
 
     const std::string FILE_POP      (DIR_ARCHIVE + "pop");
     const std::string FILE_CHAMP    (DIR_ARCHIVE + "champ_net");
+    const std::string FILE_CHAMPS   (DIR_ARCHIVE + "champs");
     const std::string FILE_EXT      (".arch");
 }
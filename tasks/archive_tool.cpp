@@ -0,0 +1,127 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "archive_tool.h"
+#include <cstdlib>
+#include <fstream>
+
+using namespace eSpinn;
+
+
+/* @brief: usage
+ * eSpinn.sim convert <input> <output>
+ * eSpinn.sim bench [pop size] [generations] [repetitions]
+ */
+int main(int argc, char *argv[]) {
+    const std::string mode(argc > 1 ? argv[1] : "");
+    if (mode == "convert" && argc == 4)
+        return convert_archive(argv[2], argv[3]);
+    if (mode == "bench")
+        return benchmark_archive(argc > 2 ? std::atoi(argv[2]) : params::pop_size,
+            argc > 3 ? std::atoi(argv[3]) : 20, argc > 4 ? std::atoi(argv[4]) : 10);
+    std::cerr << "Usage: " << argv[0] << " convert <input> <output>" << std::endl
+        << "       " << argv[0] << " bench [pop size] [generations] [repetitions]"
+        << std::endl;
+    return 1;
+}
+
+
+/* @brief: convert a population archive
+ * the input format is detected from the file
+ * binary archives are written as text archives and vice versa
+ */
+int eSpinn::convert_archive(const std::string &ifile, const std::string &ofile) {
+    const bool binary = is_binary_archive(ifile);
+    Population pop;
+    pop.load(ifile);
+    if (binary)
+        pop.archive(ofile);
+    else
+        pop.archive_binary(ofile);
+    std::cout << "Converted " << (binary ? "binary" : "text") << " archive "
+        << ifile << " to " << (binary ? "text" : "binary") << " archive "
+        << ofile << std::endl;
+    return 0;
+}
+
+
+/* @brief: get file size in bytes */
+static std::streamoff file_size(const std::string &f) {
+    std::ifstream ifs(f, std::ios::binary | std::ios::ate);
+    return ifs ? static_cast<std::streamoff>(ifs.tellg()) : 0;
+}
+
+
+/* @brief: hash all genomes of a population */
+static std::uint64_t pop_hash(const Population &pop) {
+    std::uint64_t h = fnv1a(nullptr, 0);
+    for (auto &o : pop.orgs) {
+        const auto g = o->get_genome().hash();
+        h = fnv1a(&g, sizeof(g), h);
+    }
+    return h;
+}
+
+
+/* @brief: benchmark text & binary archives
+ * evolve a population for a few generations to grow topologies
+ * then time archiving & loading it in both formats
+ * and check that both formats load the same genomes
+ */
+int eSpinn::benchmark_archive(const eSpinn_size &pop_size, const eSpinn_size &gens,
+    const eSpinn_size &reps)
+{
+    typedef Organism<HybLinNetwork> OrgType;
+    auto org = new OrgType(netID(1), 3, 0, 1, 1);
+    auto pop = new Population(org, pop_size);
+    pop->init();
+    // fake fitness, only the topologies matter
+    for (eSpinn_size gen = 1; gen <= gens; ++gen) {
+        for (auto &o : pop->orgs)
+            o->setFit(rand());
+        pop->epoch(gen);
+    }
+
+    const std::string text_file(DIR_ARCHIVE + "bench_text" + FILE_EXT);
+    const std::string bin_file(DIR_ARCHIVE + "bench_binary" + FILE_EXT);
+    typedef std::chrono::duration<double, std::milli> ms;
+    ms text_save(0), text_load(0), bin_save(0), bin_load(0);
+    bool same = true;
+    const auto hash = pop_hash(*pop);
+    for (eSpinn_size r = 0; r < reps; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        pop->archive(text_file);
+        auto t1 = std::chrono::steady_clock::now();
+        pop->archive_binary(bin_file);
+        auto t2 = std::chrono::steady_clock::now();
+        text_save += t1 - t0;
+        bin_save += t2 - t1;
+
+        Population text_pop, bin_pop;
+        t0 = std::chrono::steady_clock::now();
+        text_pop.load(text_file);
+        t1 = std::chrono::steady_clock::now();
+        bin_pop.load(bin_file);
+        t2 = std::chrono::steady_clock::now();
+        text_load += t1 - t0;
+        bin_load += t2 - t1;
+        same = same && pop_hash(text_pop) == hash && pop_hash(bin_pop) == hash;
+    }
+
+    std::cout << "Population of " << pop->size() << " organisms, "
+        << pop->species.size() << " species, " << pop->innovation.size()
+        << " innovations, " << reps << " repetitions" << std::endl;
+    std::cout << "text:   save " << text_save.count() / reps << " ms, load "
+        << text_load.count() / reps << " ms, size " << file_size(text_file)
+        << " bytes" << std::endl;
+    std::cout << "binary: save " << bin_save.count() / reps << " ms, load "
+        << bin_load.count() / reps << " ms, size " << file_size(bin_file)
+        << " bytes" << std::endl;
+    std::cout << "Loaded genomes are " << (same ? "identical" : "DIFFERENT") << std::endl;
+
+    delete org;
+    delete pop;
+    return same ? 0 : 1;
+}
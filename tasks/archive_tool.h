@@ -0,0 +1,32 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "eSpinn.h"
+#include <iostream>
+#include <chrono>
+
+/* @brief: archive tool
+ * convert population archives between text & binary formats
+ * and compare the speed & size of the two formats
+ */
+
+namespace eSpinn {
+
+    /* @brief: convert a population archive
+     * the input format is detected from the file
+     * binary archives are written as text archives and vice versa
+     */
+    int convert_archive(const std::string &ifile, const std::string &ofile);
+
+    /* @brief: benchmark text & binary archives
+     * evolve a population for a few generations to grow topologies
+     * then time archiving & loading it in both formats
+     * and check that both formats load the same genomes
+     */
+    int benchmark_archive(const eSpinn_size &pop_size, const eSpinn_size &gens,
+        const eSpinn_size &reps);
+}
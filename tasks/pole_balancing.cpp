@@ -4,12 +4,22 @@
 
 
 #include "pole_balancing.h"
+#include <cstdlib>
 
 using namespace eSpinn;
 
 
+/* @brief: usage
+ * eSpinn.sim markov|nonmarkov [random seed]
+ * eSpinn.sim bench markov|nonmarkov [pop size] [generations] [repetitions]
+ */
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
+    if (argc > 2 && std::string(argv[1]) == "bench") {
+        return benchmark_evaluator(std::string(argv[2]) == "markov",
+            argc > 3 ? std::atoi(argv[3]) : params::pop_size,
+            argc > 4 ? std::atoi(argv[4]) : 20, argc > 5 ? std::atoi(argv[5]) : 10);
+    }
+    if (argc != 2 && argc != 3) {
         std::cerr << BnR_ERROR << "Prgram requires one param: markov?\n";
         return -1;
     }
@@ -25,6 +35,10 @@ int main(int argc, char *argv[]) {
         return -1;
     }
 
+    // runs differ unless a seed is given
+    const std::uint64_t seed = argc > 2 ? std::stoull(argv[2]) : random_seed();
+    seed_rand(seed);
+    std::cout << "Random seed: " << seed << std::endl;
     return pole_balancing(markov);
 }
 
@@ -52,7 +66,13 @@ int eSpinn::pole_balancing(const bool &markov) {
     auto org = new Organism<HybridNetwork>(netID(1), inp_num, 0, 1, gen);
     auto pop = new Population(org, params::pop_size);
     pop->init();
-    pop->archive(Pole::CARTPOLE + std::to_string(gen) + Pole::POP_EXT);
+    // checkpoints: full snapshots every few generations, deltas in between
+    CheckpointStore ckpt(Pole::CARTPOLE, Pole::POP_EXT);
+    ckpt.save(*pop, gen);
+    // champions of all generations, indexed for fast loading
+    ChampionStore champs(Pole::CHAMPS, false);
+    // archive in the background, pending jobs are done before returning
+    AsyncArchiver archiver;
     // auto pop = new eSpinn::Population;
     // pop->load(Pole::CARTPOLE + std::to_string(gen) + Pole::POP_EXT);
 
@@ -65,6 +85,12 @@ int eSpinn::pole_balancing(const bool &markov) {
         inj.setNormFactors(mdl.thetadotRANGE[0], mdl.thetadotRANGE[1], 3);
     }
 
+    // organisms of the same topology balance their carts in lockstep
+    ClosedLoopEvaluator<HybridNetwork> evaluator(CartPoleEnv(dt, markov),
+        ClosedLoopEvaluator<HybridNetwork>::BATCHED);
+    // keep the last steps of the champion's episode while evaluating
+    evaluator.set_tracing(Pole::TRACE_STEP);
+
     // log fit & forces
     Logger fit_log(1);
     Logger force_log;
@@ -72,27 +98,40 @@ int eSpinn::pole_balancing(const bool &markov) {
 
     for (gen = 1; gen <= params::episode; ++gen) {
         // evaluate pop, check if solved
-        if (evaluate<decltype(org)>(pop, &inj, &mdl, markov)
+        if (evaluator.evaluate(pop, Pole::MAX_STEP)
             || !(gen % params::print_every))
         {
             auto champ = dynamic_cast<decltype(org)>(pop->get_champ_org());
             std::cout << "Champion is " << *champ << std::endl;
-            mdl_log.clear();
-            force_log.clear();
-            evaluate(champ, &inj, &mdl, markov, &mdl_log, &force_log);
-            // if (!evaluate(champ, &inj, &mdl, markov, &mdl_log, &force_log)) {
-            //     pop->reset_solved();
-            // }
-
-            // save to files
-            force_log.save(Pole::FILE_FORCE);
-            mdl_log.archive(Pole::FILE_MDL_STATES);
-            pop->archive(Pole::CARTPOLE + std::to_string(gen) + Pole::POP_EXT);
-            champ->archive(Pole::CHAMP_ORG);
-            champ->save(Pole::CHAMP);
+            // save to files in the background while the next generation evaluates
+            // the champion's trace is the episode that produced its fitness,
+            // re-run it if not traced
+            if (evaluator.get_tracer().has(champ)) {
+                auto trace = evaluator.get_tracer().get_trace();
+                archiver.submit([trace]() {
+                    trace.save(Pole::FILE_FORCE, 4, 1);
+                    trace.save(Pole::FILE_MDL_STATES, 0, 4);
+                });
+            } else {
+                mdl_log.clear();
+                force_log.clear();
+                evaluate(champ, &inj, &mdl, markov, &mdl_log, &force_log);
+                archiver.submit([force_log, mdl_log]() mutable {
+                    force_log.save(Pole::FILE_FORCE);
+                    mdl_log.archive(Pole::FILE_MDL_STATES);
+                });
+            }
+            archiver.submit(*pop, [&ckpt, gen](Population &p) { ckpt.save(p, gen); });
+            archiver.submit(*champ, [&champs, gen](OrganismBase &o) {
+                o.archive_binary(Pole::CHAMP_ORG);
+                o.save(Pole::CHAMP);
+                champs.add(o, gen, true);
+            });
             if (pop->issolved()) {
-                pop->archive(Pole::CARTPOLE + std::to_string(params::episode)
-                             + Pole::POP_EXT);
+                archiver.submit(*pop, [](Population &p) {
+                    p.archive(Pole::CARTPOLE + std::to_string(params::episode)
+                              + Pole::POP_EXT);
+                });
                 fit_log.append_to_file(champ->getFit(), FILE_FIT);
                 break;
             }
@@ -105,9 +144,11 @@ int eSpinn::pole_balancing(const bool &markov) {
         if (done)
             break;
     }
-    // evaluate<decltype(org)>(pop, &inj, &mdl, markov);
-    pop->archive(Pole::CARTPOLE + std::to_string(params::episode)
-                 + Pole::POP_EXT);
+    // evaluator.evaluate(pop, Pole::MAX_STEP);
+    archiver.submit(*pop, [](Population &p) {
+        p.archive(Pole::CARTPOLE + std::to_string(params::episode)
+                  + Pole::POP_EXT);
+    });
     gen_rec.append_to_file(gen, FILE_GEN_REC);
 
     delete org;
@@ -116,23 +157,255 @@ int eSpinn::pole_balancing(const bool &markov) {
 }
 
 
-/* @brief: evaluate population 
- * return true if problem solved
- * evaluate each organism one by one
- * and check if problem is solved
+/* @brief: benchmark the closed-loop evaluator on pole balancing
+ * evolve a population for a few generations to grow its networks,
+ * then time evaluating it serially & by threads interleaving episodes
+ * of different depths, and check that all depths give the same fitness
  */
-template <typename T>
-bool eSpinn::evaluate(Population *pop, Injector *inj, CartPole *mdl,
-    const bool &markov)
+int eSpinn::benchmark_evaluator(const bool &markov, const eSpinn_size &pop_size,
+    const eSpinn_size &gens, const eSpinn_size &reps)
 {
-    for (auto &org : pop->orgs) {
-        auto org_cast = dynamic_cast<T>(org);
-        if ( evaluate(org_cast, inj, mdl, markov) ) {
-            pop->set_solved();
+    typedef ClosedLoopEvaluator<HybridNetwork> EvalType;
+    const eSpinn_size inp_num = markov ? 5 : 3;
+    auto org = new Organism<HybridNetwork>(netID(1), inp_num, 0, 1, 1);
+    auto pop = new Population(org, pop_size);
+    pop->init();
+    EvalType evaluator(CartPoleEnv(0.01, markov), EvalType::BATCHED);
+    for (eSpinn_size gen = 1; gen <= gens; ++gen) {
+        evaluator.evaluate(pop->orgs);
+        pop->epoch(gen);
+    }
+
+    typedef std::chrono::duration<double, std::milli> ms;
+    // evaluate pop from the same random state, return the mean time & fitness
+    auto time = [&evaluator, pop, reps](std::vector<double> &fits) {
+        ms t(0);
+        for (eSpinn_size r = 0; r < reps; ++r) {
+            seed_rand(0);
+            auto t0 = std::chrono::steady_clock::now();
+            evaluator.evaluate(pop->orgs);
+            t += std::chrono::steady_clock::now() - t0;
+        }
+        fits.clear();
+        for (auto &o : pop->orgs)
+            fits.push_back(o->getFit());
+        return t.count() / reps;
+    };
+    auto steps = [](const std::vector<double> &fits) {
+        double s = .0;
+        for (auto &f : fits)
+            s += f;
+        return s;
+    };
+
+    std::cout << "Population of " << pop->size() << " organisms after "
+        << gens << " generations, " << reps << " repetitions" << std::endl;
+    std::vector<double> fits, ref;
+    evaluator.set_mode(EvalType::SERIAL);
+    auto t = time(fits);
+    std::cout << "serial:               " << t << " ms, "
+        << steps(fits) / t << " steps/ms" << std::endl;
+
+    bool same = true;
+    evaluator.set_mode(EvalType::PARALLEL);
+    for (eSpinn_size threads : {1u, 0u}) {
+        evaluator.set_threads(threads);
+        for (eSpinn_size depth : {1u, 2u, 4u, 8u, 16u}) {
+            evaluator.set_depth(depth);
+            t = time(fits);
+            if (ref.empty())
+                ref = fits;
+            same = same && fits == ref;
+            std::cout << (threads ? "1 thread,  " : "all threads,")
+                << " depth " << depth << (depth < 10 ? ":  " : ": ")
+                << t << " ms, " << steps(fits) / t << " steps/ms" << std::endl;
         }
     }
+    std::cout << "Fitness of all depths is " << (same ? "identical" : "DIFFERENT")
+        << std::endl;
+
+    delete org;
+    delete pop;
+    return same ? 0 : 1;
+}
+
+
+/* @brief: normalize v within range, the same as Injector */
+static inline double normalize(const double &v, const double *range) {
+    return 1.0/(range[1] - range[0]) * (v + -range[0]);
+}
+
+
+/* @brief: constructor */
+CartPoleEnv::CartPoleEnv(const double &dt, const bool &m) :
+    mdl(dt), markov(m), steps(0), failed(false) { }
+
+
+/* @brief: make a copy of this environment */
+std::unique_ptr<Environment> CartPoleEnv::clone() const {
+    return std::unique_ptr<Environment>(new CartPoleEnv(*this));
+}
+
+
+/* @brief: get num of observations */
+const eSpinn_size CartPoleEnv::obs_size() const {
+    return markov ? 4 : 2;
+}
+
+
+/* @brief: get num of actions */
+const eSpinn_size CartPoleEnv::act_size() const {
+    return 1;
+}
+
+
+/* @brief: start a new episode */
+void CartPoleEnv::reset() {
+    mdl.reset();
+    steps = 0;
+    failed = false;
+}
+
+
+/* @brief: write normalized observations to obs[0 ... obs_size) */
+void CartPoleEnv::observe(double *obs) {
+    const double *ranges[4] = {mdl.xRANGE, mdl.thetaRANGE, mdl.xdotRANGE, mdl.thetadotRANGE};
+    double states[4];
+    mdl.get_states(states);
+    for (eSpinn_size i = 0; i < obs_size(); ++i)
+        obs[i] = normalize(states[i], ranges[i]);
+}
+
+
+/* @brief: act on the cart for ONE time slot */
+void CartPoleEnv::step(const double *act) {
+    ++steps;
+    failed = !mdl.update(process(act[0], markov));
+}
+
+
+/* @brief: check if the episode is over */
+bool CartPoleEnv::done() const {
+    return failed || steps >= Pole::MAX_STEP;
+}
+
+
+/* @brief: get fitness of the episode
+ * as evaluating it by evaluate(org, ...), a successful cart gets one more
+ */
+const double CartPoleEnv::score() const {
+    return steps + !failed;
+}
 
-    return pop->issolved();
+
+/* @brief: write states in the order of CartPoleLogger & force to row */
+static inline void trace_row(const double *states, const double &force, double *row) {
+    row[0] = states[0];
+    row[1] = states[2];
+    row[2] = states[1];
+    row[3] = states[3];
+    row[4] = force;
+}
+
+
+/* @brief: get num of values traced every time slot */
+const eSpinn_size CartPoleEnv::trace_size() const {
+    return 5;
+}
+
+
+/* @brief: write states & force of the time slot to row[0 ... 5)
+ * i.e. x, x_dot, theta, theta_dot & force, as logged by evaluate(org, ...)
+ */
+void CartPoleEnv::trace(const double *act, double *row) const {
+    double states[4];
+    mdl.get_states(states);
+    trace_row(states, process(act[0], markov), row);
+}
+
+
+/* @brief: make n environments of carts stepped in lockstep */
+std::unique_ptr<EnvironmentBatch> CartPoleEnv::make_batch(const eSpinn_size &n) const {
+    return std::unique_ptr<EnvironmentBatch>(new CartPoleEnvBatch(n, mdl.get_tau(), markov));
+}
+
+
+/* @brief: constructor */
+CartPoleEnvBatch::CartPoleEnvBatch(const eSpinn_size &n, const double &dt,
+    const bool &m) :
+    carts(n, dt), markov(m), steps(0), force(n) { }
+
+
+/* @brief: get num of environments */
+const eSpinn_size CartPoleEnvBatch::size() const {
+    return carts.size();
+}
+
+
+/* @brief: start a new episode of all carts */
+void CartPoleEnvBatch::reset() {
+    carts.reset();
+    steps = 0;
+}
+
+
+/* @brief: write normalized observations of cart i to obs[i*stride ...]
+ * states are written to the matrix and normalized in place
+ */
+void CartPoleEnvBatch::observe(double *obs, const eSpinn_size &stride) {
+    const double *ranges[4] = {CartPole::xRANGE, CartPole::thetaRANGE,
+        CartPole::xdotRANGE, CartPole::thetadotRANGE};
+    const eSpinn_size width = markov ? 4 : 2;
+    carts.get_states(obs, stride, width);
+    for (eSpinn_size i = 0; i < carts.size(); ++i) {
+        for (eSpinn_size v = 0; v < width; ++v)
+            obs[i*stride + v] = normalize(obs[i*stride + v], ranges[v]);
+    }
+}
+
+
+/* @brief: act on running carts for ONE time slot */
+void CartPoleEnvBatch::step(const double *act, const eSpinn_size &stride) {
+    for (eSpinn_size i = 0; i < carts.size(); ++i)
+        force[i] = process(act[i*stride], markov);
+    carts.update(force.data());
+    ++steps;
+}
+
+
+/* @brief: check if the episode of cart i is over */
+bool CartPoleEnvBatch::done(const eSpinn_size &i) const {
+    return !carts.running(i) || steps >= Pole::MAX_STEP;
+}
+
+
+/* @brief: check if episodes of all carts are over */
+bool CartPoleEnvBatch::done() const {
+    return !carts.num_running() || steps >= Pole::MAX_STEP;
+}
+
+
+/* @brief: get fitness of the episode of cart i */
+const double CartPoleEnvBatch::score(const eSpinn_size &i) const {
+    return carts.get_steps(i) + carts.running(i);
+}
+
+
+/* @brief: get num of values traced every time slot */
+const eSpinn_size CartPoleEnvBatch::trace_size() const {
+    return 5;
+}
+
+
+/* @brief: write states & force of the time slot of cart i
+ * to row[0 ... 5), the same as CartPoleEnv::trace()
+ */
+void CartPoleEnvBatch::trace(const eSpinn_size &i, const double *act,
+    const eSpinn_size &stride, double *row) const
+{
+    double states[4];
+    carts.get_states(i, states);
+    trace_row(states, process(act[i*stride], markov), row);
 }
 
 
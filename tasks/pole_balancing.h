@@ -6,6 +6,8 @@
 #pragma once
 
 #include "eSpinn.h"
+#include <chrono>
+#include <memory>
 
 namespace eSpinn {
 
@@ -14,9 +16,11 @@ namespace eSpinn {
     const std::string POP_EXT       (".pop");
     const std::string CHAMP_ORG     (DIR_ARCHIVE + "champ.org");
     const std::string CHAMP         (DIR_ARCHIVE + "champ");
+    const std::string CHAMPS        (DIR_ARCHIVE + "cartpole.champs");
     const std::string FILE_FORCE        (DIR_DATA + "force");
     const std::string FILE_MDL_STATES   (DIR_DATA + "states");
     constexpr int MAX_STEP = 50000;
+    constexpr int TRACE_STEP = 2000; // num of last steps traced
     constexpr double FORCE_MAG = 10.0;
   }
 
@@ -26,14 +30,112 @@ namespace eSpinn {
      */
     int pole_balancing(const bool &markov);
 
-    /* @brief: evaluate population 
-     * return true if problem solved
-     * evaluate each organism one by one
-     * and check if problem is solved
+    /* @brief: benchmark the closed-loop evaluator on pole balancing
+     * evolve a population for a few generations to grow its networks,
+     * then time evaluating it serially & by threads interleaving episodes
+     * of different depths, and check that all depths give the same fitness
      */
-    template <typename T>
-    bool evaluate(Population *pop, Injector *inj, CartPole *mdl,
-        const bool &markov);
+    int benchmark_evaluator(const bool &markov, const eSpinn_size &pop_size,
+        const eSpinn_size &gens, const eSpinn_size &reps);
+
+    /* @brief: CartPoleEnv
+     * pole balancing as an environment
+     * observations are normalized cart position & pole angle,
+     * and their velocities if markov
+     * the episode is over when the cart fails or after MAX_STEP steps,
+     * the score is the num of steps, plus one if the cart survives
+     * a time slot is traced as x, x_dot, theta, theta_dot & force
+     */
+    class CartPoleEnv : public Environment {
+    private:
+        /* data */
+        CartPole mdl;
+        bool markov;
+        eSpinn_size steps;
+        bool failed;
+    public:
+        /* @brief: constructor */
+        CartPoleEnv(const double &dt, const bool &m);
+
+        /* @brief: make a copy of this environment */
+        std::unique_ptr<Environment> clone() const override;
+
+        /* @brief: get num of observations */
+        const eSpinn_size obs_size() const override;
+
+        /* @brief: get num of actions */
+        const eSpinn_size act_size() const override;
+
+        /* @brief: start a new episode */
+        void reset() override;
+
+        /* @brief: write normalized observations to obs[0 ... obs_size) */
+        void observe(double *obs) override;
+
+        /* @brief: act on the cart for ONE time slot */
+        void step(const double *act) override;
+
+        /* @brief: check if the episode is over */
+        bool done() const override;
+
+        /* @brief: get fitness of the episode */
+        const double score() const override;
+
+        /* @brief: get num of values traced every time slot */
+        const eSpinn_size trace_size() const override;
+
+        /* @brief: write states & force of the time slot to row[0 ... 5) */
+        void trace(const double *act, double *row) const override;
+
+        /* @brief: make n environments of carts stepped in lockstep */
+        std::unique_ptr<EnvironmentBatch> make_batch(const eSpinn_size &n) const override;
+    };
+
+
+    /* @brief: CartPoleEnvBatch
+     * pole balancing of a batch of carts stepped in lockstep
+     */
+    class CartPoleEnvBatch : public EnvironmentBatch {
+    private:
+        /* data */
+        CartPoleBatch carts;
+        bool markov;
+        eSpinn_size steps;
+        std::vector<double> force;
+    public:
+        /* @brief: constructor */
+        CartPoleEnvBatch(const eSpinn_size &n, const double &dt, const bool &m);
+
+        /* @brief: get num of environments */
+        const eSpinn_size size() const override;
+
+        /* @brief: start a new episode of all carts */
+        void reset() override;
+
+        /* @brief: write normalized observations of cart i to obs[i*stride ...] */
+        void observe(double *obs, const eSpinn_size &stride) override;
+
+        /* @brief: act on running carts for ONE time slot */
+        void step(const double *act, const eSpinn_size &stride) override;
+
+        /* @brief: check if the episode of cart i is over */
+        bool done(const eSpinn_size &i) const override;
+
+        /* @brief: check if episodes of all carts are over */
+        bool done() const override;
+
+        /* @brief: get fitness of the episode of cart i */
+        const double score(const eSpinn_size &i) const override;
+
+        /* @brief: get num of values traced every time slot */
+        const eSpinn_size trace_size() const override;
+
+        /* @brief: write states & force of the time slot of cart i
+         * to row[0 ... 5)
+         */
+        void trace(const eSpinn_size &i, const double *act,
+            const eSpinn_size &stride, double *row) const override;
+    };
 
     /* @brief: evaluate organism
      * return true if org is successful
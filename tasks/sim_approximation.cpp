@@ -8,7 +8,14 @@
 using namespace eSpinn;
 
 
+/* @brief: usage
+ * eSpinn.sim [random seed]
+ */
 int main(int argc, char *argv[]) {
+    // runs differ unless a seed is given
+    const std::uint64_t seed = argc > 1 ? std::stoull(argv[1]) : random_seed();
+    seed_rand(seed);
+    std::cout << "Random seed: " << seed << std::endl;
     return sim_approximation();
 }
 
@@ -29,6 +36,19 @@ int eSpinn::sim_approximation() {
     gate->set_normalizing_factors(FILE_DATA_RANGE);
     gate->init();
 
+    // the task is deterministic, reuse fitness of evaluated genomes
+    // the configuration is the normalized training data
+    FitnessCache fit_cache;
+    fit_cache.add_config("sim_approximation");
+    for (auto i = 0; i < gate->getLength(); ++i) {
+        auto inps = gate->get_injector_data_set(i);
+        for (auto j = 0; j < gate->getIwidth(); ++j)
+            fit_cache.add_config(inps[j]);
+        auto outps = gate->get_ejector_data_set(i);
+        for (auto j = 0; j < gate->getOwidth(); ++j)
+            fit_cache.add_config(outps[j]);
+    }
+
     auto net = new LinrNetwork(netID(1), inp_files.size()+1, 0, outp_files.size());
     auto org = new Organism<LinrNetwork>(net, 1);
     auto pop = new Population(org, 50);
@@ -37,7 +57,7 @@ int eSpinn::sim_approximation() {
     std::vector<double> champ_fits;
 
     for (eSpinn_size gen = 1; gen <= 20; ++gen) {
-        if (evaluate<decltype(org)>(pop, gate) || !(gen%params::print_every)) {
+        if (evaluate<decltype(org)>(pop, gate, &fit_cache) || !(gen%params::print_every)) {
             auto champ = dynamic_cast<decltype(org)>(pop->get_champ_org());
             std::cout << "Champion is " << *champ << std::endl;
             evaluate(champ, gate);
@@ -67,11 +87,67 @@ int eSpinn::sim_approximation() {
  * calculate mean square errors 
  * and assign fitness values to organisms
  * finally, check if problem is solved
+ * organisms found in fit_cache are not simulated again
+ * organisms of the same topology are run in a batch,
+ * the others are run one by one
  */
 template <typename T>
-bool eSpinn::evaluate(Population *pop, Gate *gate) {
+bool eSpinn::evaluate(Population *pop, Gate *gate, FitnessCache *fit_cache) {
+    typedef typename std::remove_pointer<T>::type::net_type N;
+    auto assign = [pop, fit_cache](OrganismBase *org, const double &mse) {
+        std::cout << "Mean square error is " << mse << std::endl;
+        org->calFit(mse);
+        if (fit_cache)
+            fit_cache->store(org->get_genome(), org->getFit());
+        if (org->setWinner(params::std_fit)) {
+            pop->set_solved();
+        }
+    };
+
+    std::vector<OrganismBase*> orgs;
+    std::vector<const Genome*> genomes;
     for (auto &org : pop->orgs) {
-        auto org_cast = dynamic_cast<T>(org);
+        double fit;
+        if (fit_cache && fit_cache->lookup(org->get_genome(), fit)) {
+            org->setFit(fit);
+            if (org->setWinner(params::std_fit)) {
+                pop->set_solved();
+            }
+            continue;
+        }
+        orgs.push_back(org);
+        genomes.push_back(&org->get_genome());
+    }
+
+    std::vector<eSpinn_size> rest;
+    auto groups = NetworkBatch<N>::group(genomes, rest);
+    for (auto &group : groups) {
+        std::vector<const Genome*> members;
+        for (auto &i : group)
+            members.push_back(genomes[i]);
+        NetworkBatch<N> batch(members);
+        auto inp_size = batch.get_inp_size(), outp_size = batch.get_outp_size();
+        std::vector<double> inps(batch.size() * inp_size);
+        std::vector<double> outps(gate->getLength() * batch.size() * outp_size);
+        for (auto i = 0; i < gate->getLength(); ++i) {
+            auto data = gate->get_injector_data_set(i);
+            for (eSpinn_size b = 0; b < batch.size(); ++b)
+                std::copy(data, data + inp_size, &inps[b*inp_size]);
+            batch.run(inps.data(), &outps[i * batch.size() * outp_size]);
+        }
+        std::vector<double> outp(outp_size);
+        for (eSpinn_size b = 0; b < batch.size(); ++b) {
+            for (auto i = 0; i < gate->getLength(); ++i) {
+                auto o = &outps[(i * batch.size() + b) * outp_size];
+                outp.assign(o, o + outp_size);
+                gate->eject_net_outp(outp, i);
+            }
+            assign(orgs[group[b]], gate->cal_mse());
+        }
+    }
+
+    for (auto &r : rest) {
+        auto org_cast = dynamic_cast<T>(orgs[r]);
         auto net = org_cast->getNet();
         auto inp_size = net->get_inp_size();
         for (auto i = 0; i < gate->getLength(); ++i) {
@@ -81,12 +157,11 @@ bool eSpinn::evaluate(Population *pop, Gate *gate) {
             gate->eject_net_outp(outp, i);
             std::cout << "Network output is " << outp << std::endl;
         }
-        auto mse = gate->cal_mse();
-        std::cout << "Mean square error is " << mse << std::endl;
-        org->calFit(mse);
-        if (org->setWinner(params::std_fit)) {
-            pop->set_solved();
-        }
+        assign(orgs[r], gate->cal_mse());
+    }
+    if (fit_cache) {
+        std::cout << *fit_cache << std::endl;
+        fit_cache->reset_stats();
     }
 
     return pop->issolved();
@@ -7,6 +7,8 @@
 
 #include "eSpinn.h"
 #include <iostream>
+#include <algorithm>
+#include <type_traits>
 
 namespace eSpinn {
     /* @brief: approximation task - supervised learning
@@ -21,9 +23,11 @@ namespace eSpinn {
      * calculate mean square errors 
      * and assign fitness values to organisms
      * finally, check if problem is solved
+     * organisms found in fit_cache are not simulated again
+     * organisms of the same topology are run in a batch
      */
     template <typename T>
-    bool evaluate(Population *pop, Gate *gate);
+    bool evaluate(Population *pop, Gate *gate, FitnessCache *fit_cache = nullptr);
 
     /* @brief: re-evaluate organism
      * push network outputs to gate
@@ -5,12 +5,23 @@
 
 #include "sim_ctrl.h"
 #include "eta.h"
+#include <algorithm>
+#include <memory>
+#include <thread>
 
 using namespace eSpinn;
 
 
+/* @brief: usage
+ * eSpinn.sim [random seed]
+ */
 int main(int argc, char *argv[]) {
+    // runs differ unless a seed is given
+    const std::uint64_t seed = argc > 1 ? std::stoull(argv[1]) : random_seed();
+    seed_rand(seed);
+    std::cout << "Random seed: " << seed << std::endl;
     sim_ctrl();
+    // sim_ctrl_steady();
     return sim_plasticity();
     // return verify();
     // return plasticify();
@@ -27,41 +38,59 @@ int main(int argc, char *argv[]) {
 int eSpinn::sim_ctrl() {
     std::cout << "Starting controller task..." << std::endl;
 
-    // create logger and load reference signal
-    auto log_pos = new PlantLogger();
-    log_pos->load_ref_signal(FILE_REF_DATA);
-
-    // construct plant model
+    // construct plant model & logger of the reference signal
     const double dt = 0.02;
-    auto plant = new Plant(dt);
+    EvalContext ctx(dt, std::make_shared<const RefSignal>(FILE_REF_DATA));
+
+    // trace the champion while evaluating instead of re-running it
+    ctx.tracer.set_capacity(ctx.log_pos.length());
+
+    // the task is deterministic, reuse fitness of evaluated genomes
+    FitnessCache fit_cache;
+    init_fit_cache(fit_cache, dt, &ctx.log_pos);
+    // screen organisms on the first half of the signal in early generations
+    // and evaluate all of them in full later on, if screening
+    FidelitySchedule fidelity;
+    if (screening) {
+        fidelity.set(1, Fidelity(.5, .3));
+        fidelity.set(params::episode/2, Fidelity());
+    }
 
     // initialize population
     eSpinn_size gen = 1;
     auto org = new Organism<HybLinNetwork>(netID(1), 3, 0, 1, gen);
     auto pop = new Population(org, params::pop_size);
     pop->init();
-    pop->archive(FILE_POP + std::to_string(gen) + FILE_EXT);
+    // checkpoints: full snapshots every few generations, deltas in between
+    CheckpointStore ckpt(FILE_POP, FILE_EXT);
+    ckpt.save(*pop, gen);
     // auto pop = new eSpinn::Population;
     // pop->load(FILE_POP + std::to_string(gen) + FILE_EXT);
+    // champions of all generations, indexed for fast loading
+    ChampionStore champs(FILE_CHAMPS + FILE_EXT, false);
+    // archive in the background, pending jobs are done before returning
+    AsyncArchiver archiver;
 
     Logger fit_logger(1);
-    Logger net_outp(log_pos->length());
 
     for (gen = 1; gen <= params::episode; ++gen) {
         // evaluate pop, check if solved
-        if (evaluate<decltype(org)>(pop, plant, log_pos) || !(gen%params::print_every)) {
+        if (evaluate<decltype(org)>(pop, ctx, &fit_cache, fidelity.at(gen))
+            || !(gen%params::print_every))
+        {
             auto champ = dynamic_cast<decltype(org)>(pop->get_champ_org());
             std::cout << "Champion is " << *champ << std::endl;
-            net_outp.clear();
-            WeightWatcher w_watch(champ->getNet(), gen);
-            evaluate(champ, plant, log_pos, &net_outp, &w_watch);
-            net_outp.save(FILE_CTRL_OUT);
-            w_watch.save(FILE_WEIGHT);
-            log_pos->save_act(FILE_ACT_OUT);
-            pop->archive(FILE_POP + std::to_string(gen) + FILE_EXT);
-            champ->getNet()->save(FILE_CHAMP + FILE_EXT);
+            // save results in the background while the next generation evaluates
+            save_champ_logs(champ, ctx, archiver, gen);
+            archiver.submit(*pop, [&ckpt, gen](Population &p) { ckpt.save(p, gen); });
+            archiver.submit(*champ, [&champs, gen](OrganismBase &o) {
+                dynamic_cast<Organism<HybLinNetwork>&>(o).getNet()->save(FILE_CHAMP + FILE_EXT);
+                champs.add(o, gen, true);
+            });
             if (pop->issolved()) {
-                pop->archive(FILE_POP + std::to_string(params::episode) + FILE_EXT);
+                archiver.submit(*pop, [](Population &p) {
+                    p.archive(FILE_POP + std::to_string(params::episode) + FILE_EXT);
+                });
                 fit_logger.append_to_file(champ->getFit(), FILE_FIT);
                 break;
             }
@@ -74,47 +103,212 @@ int eSpinn::sim_ctrl() {
         if (done)
             break;
     }
-    evaluate<decltype(org)>(pop, plant, log_pos);
+    evaluate<decltype(org)>(pop, ctx);
+    archiver.submit(*pop, [](Population &p) {
+        p.archive(FILE_POP + std::to_string(params::episode) + FILE_EXT);
+    });
+
+    delete org;
+    delete pop;
+    return 0;
+}
+
+
+/* @brief: controller task in steady-state mode
+ * organisms are evaluated by parallel workers
+ * and replaced by offspring as soon as fitness values return
+ * each worker controls its own plant model
+ */
+int eSpinn::sim_ctrl_steady() {
+    std::cout << "Starting controller task in steady-state mode..." << std::endl;
+
+    // initialize population
+    typedef Organism<HybLinNetwork> OrgType;
+    auto org = new OrgType(netID(1), 3, 0, 1, 1);
+    auto pop = new Population(org, params::pop_size);
+    pop->init();
+
+    // create an evaluation context for each worker
+    // contexts share the reference signal loaded once
+    const double dt = 0.02;
+    const eSpinn_size num_workers = std::max(std::thread::hardware_concurrency(), 1u);
+    auto ref = std::make_shared<const RefSignal>(FILE_REF_DATA);
+    std::vector<EvalContext*> contexts;
+    for (eSpinn_size w = 0; w < num_workers; ++w)
+        contexts.push_back(new EvalContext(dt, ref));
+
+    SteadyStateScheduler scheduler(pop, 
+        [&](OrganismBase *o, const eSpinn_size &w) {
+            auto org_cast = dynamic_cast<OrgType*>(o);
+            evaluate(org_cast, *contexts[w]);
+            return o->getFit();
+        }, num_workers);
+    scheduler.set_winner_fit(winner_fit);
+
+    // the same num of evaluations as the generational mode
+    Logger fit_logger(1);
+    for (eSpinn_size gen = 1; gen <= params::episode; ++gen) {
+        bool solved = scheduler.run(pop->size());
+        auto champ = scheduler.get_champ();
+        fit_logger.append_to_file(champ->getOrigFit(), FILE_FIT);
+        if (solved) {
+            std::cout << "Champion is " << *champ << std::endl;
+            break;
+        }
+    }
     pop->archive(FILE_POP + std::to_string(params::episode) + FILE_EXT);
 
-    delete plant;
-    delete log_pos;
+    for (auto &c : contexts)
+        delete c;
     delete org;
     delete pop;
     return 0;
 }
 
 
+/* @brief: constructor
+ * the injector normalizes position error & velocity
+ */
+EvalContext::EvalContext(const double &dt, const std::shared_ptr<const RefSignal> &ref) :
+    plant(dt), log_pos(ref), inj(2), hold(ctrl_period), tracer(0), pos(0),
+    cached(), screened(), demoted()
+{
+    inj.setNormFactors(Plant::posRANGE[0], Plant::posRANGE[1], 0); // pos_err
+    inj.setNormFactors(Plant::velRANGE[0], Plant::velRANGE[1], 1); // vel
+}
+
+
+/* @brief: get ready for the next organism */
+void EvalContext::reset() {
+    plant.reset();
+    hold.reset();
+}
+
+
 /* @brief: evaluate population 
  * use each network to control the plant model
  * and save system outputs to log_pos
  * calculate mean square errors 
  * and assign fitness values to organisms
  * finally, check if problem is solved
+ * organisms found in fit_cache are not simulated again
+ * organisms are screened on a short episode first if fidelity says so,
+ * and those not promoted are ranked below the fully evaluated ones
+ * organisms that can neither survive nor win are stopped early
+ * and finished later if they may change offspring counts
+ * the champion's trace is kept by ctx.tracer if tracing
  */
 template <typename T>
-bool eSpinn::evaluate(Population *pop, Plant *plant, PlantLogger *log_pos) {
-    for (auto &org : pop->orgs) {
-        auto org_cast = dynamic_cast<T>(org);
-        evaluate(org_cast, plant, log_pos);
+bool eSpinn::evaluate(Population *pop, EvalContext &ctx,
+    FitnessCache *fit_cache, const Fidelity &fidelity)
+{
+    ctx.tracer.clear();
+    // reuse fitness of genomes found in fit_cache
+    // and screen the rest if required
+    auto &cached = ctx.cached;
+    auto &screened = ctx.screened;
+    auto &demoted = ctx.demoted;
+    cached.assign(pop->size(), 0);
+    screened.clear();
+    demoted.clear();
+    const auto screen_len = fidelity.screen_length(ctx.log_pos.length());
+    for (eSpinn_size i = 0; i < pop->size(); ++i) {
+        auto &org = pop->orgs[i];
+        double fit;
+        if (fit_cache && fit_cache->lookup(org->get_genome(), fit)) {
+            org->setFit(fit);
+            cached[i] = 1;
+        } else if (fidelity.screens()) {
+            auto org_cast = dynamic_cast<T>(org);
+            evaluate(org_cast, ctx, nullptr, nullptr,
+                -std::numeric_limits<double>::infinity(), screen_len);
+            screened.push_back(org);
+        }
+    }
+    const auto promoted = fidelity.promoted(*pop, screened);
+
+    SurvivalCutoff cutoff(*pop, winner_fit);
+    double full_min = std::numeric_limits<double>::infinity();
+    for (eSpinn_size i = 0; i < pop->size(); ++i) {
+        auto &org = pop->orgs[i];
+        if (!cached[i]) {
+            if (fidelity.screens() && !promoted.count(org)) {
+                demoted.push_back(org);
+                continue;
+            }
+            auto org_cast = dynamic_cast<T>(org);
+            ctx.pos = i;
+            if (evaluate(org_cast, ctx, nullptr, nullptr,
+                cutoff.threshold(org)))
+            {
+                if (fit_cache)
+                    fit_cache->store(org->get_genome(), org->getFit());
+            } else {
+                // the fitness is a bound, not to be reused
+                // fitness is at least 0
+                cutoff.stopped(org, .0, org->getFit());
+            }
+        }
+        cutoff.record(org, org->getFit());
+        full_min = std::min(full_min, org->getFit());
         if (org->setWinner(winner_fit)) {
             pop->set_solved();
         }
     }
+    // screening fitness is not comparable with full fitness
+    // ranking it below keeps survivors, not offspring counts
+    for (auto &org : demoted)
+        org->setFit(std::min(org->getFit(), full_min));
+    // finish stopped evaluations that may change the offspring counts
+    while (auto org = cutoff.unresolved()) {
+        ctx.pos = std::find(pop->orgs.begin(), pop->orgs.end(), org) - pop->orgs.begin();
+        evaluate(dynamic_cast<T>(org), ctx);
+        if (fit_cache)
+            fit_cache->store(org->get_genome(), org->getFit());
+        cutoff.finished(org);
+    }
+    if (fidelity.screens())
+        std::cout << demoted.size() << " of " << screened.size() 
+            << " screened organisms not promoted" << std::endl;
+    std::cout << cutoff.get_stopped() << " evaluations stopped early, "
+        << cutoff.get_finished() << " of them finished" << std::endl;
+    if (fit_cache) {
+        std::cout << *fit_cache << std::endl;
+        fit_cache->reset_stats();
+    }
 
     return pop->issolved();
 }
 
 
+/* @brief: set up fitness cache with the evaluation configuration
+ * i.e. timestep, control period and reference signal
+ */
+void eSpinn::init_fit_cache(FitnessCache &fit_cache, const double &dt,
+    const PlantLogger *log_pos)
+{
+    fit_cache.add_config("sim_ctrl");
+    fit_cache.add_config(dt);
+    fit_cache.add_config(ctrl_period);
+    for (eSpinn_size i = 0; i < log_pos->length(); ++i)
+        fit_cache.add_config(log_pos->ref_at(i));
+}
+
+
 /* @brief: evaluate organism by controlling the plant model
  * log system outputs 
  * log controller outputs when re-evaluating champ organism
  * calculate mean square error 
  * and assign fitness value to organism
+ * stop once the fitness can't reach cutoff, and assign the fitness bound
+ * return false if stopped
+ * only the first steps of the reference signal are run if steps is given
+ * full episodes are traced if tracing, until org can't beat the kept trace
  */
 template <typename T>
-void eSpinn::evaluate(Organism<T> *org, Plant *plant,
-    PlantLogger *log_pos, Logger *const net_outp, WeightWatcher *w_watch) 
+bool eSpinn::evaluate(Organism<T> *org, EvalContext &ctx,
+    Logger *const net_outp, WeightWatcher *w_watch,
+    const double &cutoff, const eSpinn_size &steps) 
 {
     #ifndef NDEBUG
     std::cout << "Evaluating Network #" << org->getID() << std::endl;
@@ -124,32 +318,64 @@ void eSpinn::evaluate(Organism<T> *org, Plant *plant,
 
     auto net = org->getNet();
     auto inp_size = net->get_inp_size();
-    const auto timesteps = log_pos->length();
+    if (inp_size != ctx.inj.width() + 1) {
+        std::cerr << BnR_ERROR << "network inputs don't fit the injector" << std::endl;
+        org->setFit(.0);
+        return true;
+    }
+    auto plant = &ctx.plant;
+    auto log_pos = &ctx.log_pos;
+    auto &inj = ctx.inj;
+    const auto timesteps = (steps && steps < log_pos->length()) ? 
+        steps : log_pos->length();
     bool failed = false;
     net->backup_connection_weights();
+    // start from the same runtime states whatever ran before,
+    // e.g. a screening episode
+    net->reset();
 
     if (w_watch)
         w_watch->log_weights();
 
-    plant->reset();
-    Injector inj(inp_size-1);
-    inj.setNormFactors(plant->posRANGE[0], plant->posRANGE[1], 0); // pos_err
-    inj.setNormFactors(plant->velRANGE[0], plant->velRANGE[1], 1); // vel
+    ctx.reset();
+    auto &tracer = ctx.tracer;
+    if (!steps)
+        tracer.begin(0, org, ctx.pos, 2 + net->get_connection_size());
 
     // OutputBuffer outp_channel(5);
 
+    // the fitness is 1 - sum|err| / (timesteps*posRANGE[1]), at least 0.2,
+    // or below 0.2 if failed
+    // the sum so far gives an upper bound of it
+    const double err_scale = 1.0 / (timesteps * plant->posRANGE[1]);
+    double abs_err = .0;
+
     double raw_outp = .5, outp = .0;
     for (auto i = 0; i < timesteps; ++i) {
         log_pos->log_act(i, plant->getPos()); // archive actual position
         auto pos_err = log_pos->cal_err(i);
-        inj.load_data(0, pos_err); // load position error
-        inj.load_data(1, plant->getVel()); // load velocity
-        // add noise when training plastic rules (?)
-        // inj.load_data(0, pos_err + rand(-0.02,0.02)); // load position error
-        // inj.load_data(1, plant->getVel() + rand(-0.02,0.02)); // load vel
-        // inj.load_data(2, raw_outp); // load network output from previous step
-        net->load_inputs(inj.get_data_set(), inp_size);
-        raw_outp = net->run().at(0);
+        abs_err += std::abs(pos_err);
+        const double fit_bound = std::max(1.0 - abs_err * err_scale, 0.2);
+        if (fit_bound < cutoff) {
+            org->setFit(fit_bound);
+            tracer.drop(0);
+            net->restore_connection_weights();
+            return false;
+        }
+        tracer.drop_below(0, fit_bound);
+        // the controller runs at the rate of ctx.hold, held in between
+        if (ctx.hold.due()) {
+            inj.load_data(0, pos_err); // load position error
+            inj.load_data(1, plant->getVel()); // load velocity
+            // add noise when training plastic rules (?)
+            // inj.load_data(0, pos_err + rand(-0.02,0.02)); // load position error
+            // inj.load_data(1, plant->getVel() + rand(-0.02,0.02)); // load vel
+            // inj.load_data(2, raw_outp); // load network output from previous step
+            net->load_inputs(inj.get_data_set(), inp_size);
+            raw_outp = *ctx.hold.sample(net->run().data(), 1);
+        } else {
+            raw_outp = *ctx.hold.hold();
+        }
         outp = process(raw_outp);
         // outp_channel.push(outp);
         // outp = outp_channel.mean();
@@ -161,6 +387,11 @@ void eSpinn::evaluate(Organism<T> *org, Plant *plant,
         // log network output to file
         if (net_outp)
             net_outp->push_back(outp);
+        if (auto row = tracer.next_row(0)) {
+            row[0] = outp;
+            row[1] = log_pos->act_at(i);
+            net->get_connection_weights(row + 2);
+        }
 
         if (!plant->run(outp)) { // position out of boundary
             failed = true;
@@ -183,7 +414,7 @@ void eSpinn::evaluate(Organism<T> *org, Plant *plant,
         }
     }
     if (!failed) {
-        auto std_err = log_pos->cal_std_err() / plant->posRANGE[1];
+        auto std_err = log_pos->cal_std_err(timesteps) / plant->posRANGE[1];
         // make sure fit is positive
         if (std_err >= 1.0)
             std_err = .8;
@@ -191,8 +422,40 @@ void eSpinn::evaluate(Organism<T> *org, Plant *plant,
         std::cout << "org #" << org->getID() << "'s fit is " 
             << org->getFit() << std::endl;
     }
+    tracer.end(0, org->getFit());
     // restore connection weights if network is plastic
     net->restore_connection_weights();
+    return true;
+}
+
+
+/* @brief: save controller outputs, connection weights
+ * & actual positions of the champion in the background
+ * from its trace if ctx.tracer keeps it, or by re-evaluating it,
+ * e.g. if its fitness was found in the cache
+ */
+template <typename T>
+void eSpinn::save_champ_logs(Organism<T> *champ, EvalContext &ctx,
+    AsyncArchiver &archiver, const eSpinn_size &gen)
+{
+    if (ctx.tracer.has(champ)) {
+        auto trace = ctx.tracer.get_trace();
+        archiver.submit([trace]() {
+            trace.save(FILE_CTRL_OUT, 0, 1);
+            trace.save(FILE_WEIGHT, 2, trace.get_width() - 2, true);
+            trace.save(FILE_ACT_OUT, 1, 1);
+        });
+        return;
+    }
+    Logger net_outp(ctx.log_pos.length());
+    auto w_watch = std::make_shared<WeightWatcher>(champ->getNet(), gen);
+    evaluate(champ, ctx, &net_outp, w_watch.get());
+    auto act_log = ctx.log_pos;
+    archiver.submit([net_outp, w_watch, act_log]() mutable {
+        net_outp.save(FILE_CTRL_OUT);
+        w_watch->save(FILE_WEIGHT);
+        act_log.save_act(FILE_ACT_OUT);
+    });
 }
 
 
@@ -224,22 +487,24 @@ double eSpinn::process(const double &raw_out) {
 bool eSpinn::sim_plasticity() {
     std::cout << "Plasticify organisms..." << std::endl;
 
-    // create logger and load reference signal
-    auto log_pos = new PlantLogger();
-    log_pos->load_ref_signal(FILE_REF_DATA);
-
-    // construct plant model
+    // construct plant model & logger of the reference signal
     const double dt = 0.02;
-    auto plant = new Plant(dt);
+    EvalContext ctx(dt, std::make_shared<const RefSignal>(FILE_REF_DATA));
 
     // load previous population and get the champion
     auto pop = new eSpinn::Population;
     pop->load(FILE_POP + std::to_string(params::episode) + FILE_EXT);
     auto org = dynamic_cast<Organism<HybLinNetwork>*>(pop->get_champ_org())->duplicate(1, 1);
     // set as rate Hebbian
-    org->getNet()->set_connection_hebb_type(RateHebbian);
+    org->set_connection_hebb_type(RateHebbian);
     delete pop;
 
+    // trace the champion while evaluating instead of re-running it
+    ctx.tracer.set_capacity(ctx.log_pos.length());
+
+    // the task is deterministic, reuse fitness of evaluated genomes
+    FitnessCache fit_cache;
+    init_fit_cache(fit_cache, dt, &ctx.log_pos);
 
     // initialize population from the champion
     eSpinn_size gen = params::episode+1;
@@ -252,25 +517,32 @@ bool eSpinn::sim_plasticity() {
         o->mutate_plastic_terms();
     }
 
+    // checkpoints: full snapshots every few generations, deltas in between
+    CheckpointStore ckpt(FILE_POP, FILE_EXT);
+    // champions of all generations, indexed for fast loading
+    ChampionStore champs(FILE_CHAMPS + FILE_EXT);
+    // archive in the background, pending jobs are done before returning
+    AsyncArchiver archiver;
+
     Logger fit_logger(1);
     fit_logger.append_newline_to_file(FILE_FIT);
-    Logger net_outp(log_pos->length());
 
     for (gen = params::episode+1; gen <= 2 * params::episode; ++gen) {
         // evaluate pop, check if solved
-        if (evaluate<decltype(org)>(pop, plant, log_pos) || !(gen%1)) {
+        if (evaluate<decltype(org)>(pop, ctx, &fit_cache) || !(gen%1)) {
             auto champ = dynamic_cast<decltype(org)>(pop->get_champ_org());
             std::cout << "Champion is " << *champ << std::endl;
-            net_outp.clear();
-            WeightWatcher w_watch(champ->getNet(), gen);
-            evaluate(champ, plant, log_pos, &net_outp, &w_watch);
-            net_outp.save(FILE_CTRL_OUT);
-            w_watch.save(FILE_WEIGHT);
-            log_pos->save_act(FILE_ACT_OUT);
-            pop->archive(FILE_POP + std::to_string(gen) + FILE_EXT);
-            champ->getNet()->save(FILE_CHAMP + FILE_EXT);
+            // save results in the background while the next generation evaluates
+            save_champ_logs(champ, ctx, archiver, gen);
+            archiver.submit(*pop, [&ckpt, gen](Population &p) { ckpt.save(p, gen); });
+            archiver.submit(*champ, [&champs, gen](OrganismBase &o) {
+                dynamic_cast<Organism<HybLinNetwork>&>(o).getNet()->save(FILE_CHAMP + FILE_EXT);
+                champs.add(o, gen, true);
+            });
             if (pop->issolved()) {
-                pop->archive(FILE_POP + std::to_string(2*params::episode) + FILE_EXT);
+                archiver.submit(*pop, [](Population &p) {
+                    p.archive(FILE_POP + std::to_string(2*params::episode) + FILE_EXT);
+                });
                 fit_logger.append_to_file(champ->getFit(), FILE_FIT);
                 break;
             }
@@ -283,11 +555,11 @@ bool eSpinn::sim_plasticity() {
         if (done)
             break;
     }
-    evaluate<decltype(org)>(pop, plant, log_pos);
-    pop->archive(FILE_POP + std::to_string(2*params::episode) + FILE_EXT);
+    evaluate<decltype(org)>(pop, ctx);
+    archiver.submit(*pop, [](Population &p) {
+        p.archive(FILE_POP + std::to_string(2*params::episode) + FILE_EXT);
+    });
 
-    delete plant;
-    delete log_pos;
     delete org;
     delete pop;
     return 0;
@@ -300,13 +572,9 @@ bool eSpinn::sim_plasticity() {
 bool eSpinn::plasticify() {
     std::cout << "Plasticify non-plastic networks..." << std::endl;
 
-    // create logger and load reference signal
-    auto log_pos = new PlantLogger();
-    log_pos->load_ref_signal(FILE_REF_DATA);
-
-    // construct plant model
+    // construct plant model & logger of the reference signal
     const double dt = 0.02;
-    auto plant = new Plant(dt);
+    EvalContext ctx(dt, std::make_shared<const RefSignal>(FILE_REF_DATA));
 
     // load population and get the plastic champion
     auto pop = new eSpinn::Population;
@@ -321,13 +589,11 @@ bool eSpinn::plasticify() {
     for (auto &o : pop->orgs) {
         auto org = dynamic_cast<decltype(champ)>(o);
         org->duplicate_plastic_rule(champ);
-        evaluate(org, plant, log_pos);
+        evaluate(org, ctx);
     }
 
     delete champ;
     delete pop;
-    delete log_pos;
-    delete plant;
     return 0;
 }
 
@@ -412,30 +678,27 @@ int eSpinn::sim_rate() {
 int eSpinn::verify() {
     std::cout << "Verifying trained networks..." << std::endl;
 
-    // create logger and load reference signal
-    auto log_pos = new PlantLogger();
-    log_pos->load_ref_signal(FILE_VERIFY_DATA);
-    auto log_net_outp = new Logger(log_pos->length());
+    // load the champion only, not the whole population
+    ChampionStore champs(FILE_CHAMPS + FILE_EXT);
+    std::unique_ptr<OrganismBase> champ(champs.load_latest_champ(50));
+    if (!champ) {
+        std::cerr << BnR_ERROR << "No champion up to gen #50 in "
+            << FILE_CHAMPS + FILE_EXT << std::endl;
+        return 1;
+    }
 
-    // construct plant model
+    // construct plant model & logger of the verification signal
     const double dt = 0.01;
-    auto plant = new Plant(dt);
+    EvalContext ctx(dt, std::make_shared<const RefSignal>(FILE_VERIFY_DATA));
+    auto log_net_outp = new Logger(ctx.log_pos.length());
 
-    auto pop = new Population;
-    std::string file_pop = FILE_POP + "50" + FILE_EXT;
-    pop->load(file_pop);
-    std::cout << *pop << std::endl;
-    auto champ = pop->get_champ_org();
-    auto champ_cast = dynamic_cast<Organism<HybridNetwork>*>(champ);
+    auto champ_cast = dynamic_cast<Organism<HybridNetwork>*>(champ.get());
     std::cout << "Champ org: " << *champ_cast << std::endl;
-    evaluate(champ_cast, plant, log_pos, log_net_outp);
+    evaluate(champ_cast, ctx, log_net_outp);
     log_net_outp->save(FILE_VERIFY_CTRL_OUT);
-    log_pos->save_act(FILE_VERIFY_OUT);
+    ctx.log_pos.save_act(FILE_VERIFY_OUT);
 
-    delete log_pos;
     delete log_net_outp;
-    delete plant;
-    delete pop;
 
     return 0;
 }
@@ -445,13 +708,15 @@ int eSpinn::verify() {
  * read population from file, and print the champ org
  */
 int eSpinn::print_champ() {
-    auto pop = new Population;
-    std::string file_pop = FILE_POP + "51" + FILE_EXT;
-    pop->load(file_pop);
-    auto champ = pop->get_champ_org();
-    auto champ_cast = dynamic_cast<Organism<HybridNetwork>*>(champ);
+    ChampionStore champs(FILE_CHAMPS + FILE_EXT);
+    std::unique_ptr<OrganismBase> champ(champs.load_latest_champ(51));
+    if (!champ) {
+        std::cerr << BnR_ERROR << "No champion up to gen #51 in "
+            << FILE_CHAMPS + FILE_EXT << std::endl;
+        return 1;
+    }
+    auto champ_cast = dynamic_cast<Organism<HybridNetwork>*>(champ.get());
     std::cout << "Champ org: " << *champ_cast << std::endl;
 
-    delete pop;
     return 0;
 }
@@ -8,6 +8,9 @@
 #include "eSpinn.h"
 #include <iostream>
 #include <chrono>
+#include <limits>
+#include <memory>
+#include <vector>
 
 namespace eSpinn {
     const std::string FILE_REF_DATA_PSNN  (DIR_DATA + "ref_data_psnn");
@@ -15,6 +18,11 @@ namespace eSpinn {
     constexpr double ctrlRange[2] = {-4.0, 4.0};
     constexpr double ctrl_norm_factor = 6.0; // ctrlRange[1] - ctrlRange[0];
     constexpr double ctrl_shift = 7.0;
+    // the controller runs every ctrl_period plant steps, held in between
+    constexpr eSpinn_size ctrl_period = 1;
+    // screen organisms on a short episode in early generations,
+    // offspring counts of those generations are approximate then
+    constexpr bool screening = false;
 
     /* @brief: controller task
      * use neural networks to control a plant model
@@ -24,25 +32,91 @@ namespace eSpinn {
      */
     int sim_ctrl();
 
+    /* @brief: controller task in steady-state mode
+     * organisms are evaluated by parallel workers
+     * and replaced by offspring as soon as fitness values return
+     * each worker controls its own plant model
+     */
+    int sim_ctrl_steady();
+
+    /* @brief: EvalContext
+     * what a worker needs to evaluate organisms: plant model, logger,
+     * injector, sample & hold of the controller, trace recorder
+     * & scratch of population evaluation
+     * it is allocated once and reset between organisms,
+     * contexts of different workers share the reference signal
+     * tracing is disabled until the tracer is given a capacity,
+     * a traced time slot is controller output, actual position
+     * & connection weights after the network runs
+     */
+    struct EvalContext
+    {
+        Plant plant;
+        PlantLogger log_pos;
+        Injector inj;
+        SampleHold hold; // controller rate, ctrl_period by default
+        TraceRecorder tracer;
+        eSpinn_size pos; // position of the organism in the population
+        // scratch of evaluating a population
+        std::vector<char> cached;
+        std::vector<OrganismBase*> screened, demoted;
+
+        /* @brief: constructor */
+        EvalContext(const double &dt, const std::shared_ptr<const RefSignal> &ref);
+
+        /* @brief: deleted copy constructor */
+        EvalContext(const EvalContext &) = delete;
+
+        /* @brief: get ready for the next organism */
+        void reset();
+    };
+
     /* @brief: evaluate population 
      * use each network to control the plant model
      * and save system outputs to log_pos
      * calculate mean square errors 
      * and assign fitness values to organisms
      * finally, check if problem is solved
+     * organisms found in fit_cache are not simulated again
+     * organisms are screened on a short episode first if fidelity says so,
+     * and those not promoted are ranked below the fully evaluated ones
+     * organisms that can neither survive nor win are stopped early
+     * and finished later if they may change offspring counts
+     * the champion's trace is kept by ctx.tracer if tracing
      */
     template <typename T>
-    bool evaluate(Population *pop, Plant *plant, PlantLogger *log_pos);
+    bool evaluate(Population *pop, EvalContext &ctx,
+        FitnessCache *fit_cache = nullptr, const Fidelity &fidelity = Fidelity());
+
+    /* @brief: set up fitness cache with the evaluation configuration
+     * i.e. timestep, control period and reference signal
+     */
+    void init_fit_cache(FitnessCache &fit_cache, const double &dt,
+        const PlantLogger *log_pos);
 
     /* @brief: evaluate organism by controlling the plant model
      * log system outputs 
      * log controller outputs when re-evaluating champ organism
      * calculate mean square error 
      * and assign fitness value to organism
+     * stop once the fitness can't reach cutoff, and assign the fitness bound
+     * return false if stopped
+     * only the first steps of the reference signal are run if steps is given
+     * full episodes are traced if tracing, until org can't beat the kept trace
+     */
+    template <typename T>
+    bool evaluate(Organism<T> *org, EvalContext &ctx,
+        Logger *const net_outp = nullptr, WeightWatcher *ww = nullptr,
+        const double &cutoff = -std::numeric_limits<double>::infinity(),
+        const eSpinn_size &steps = 0);
+
+    /* @brief: save controller outputs, connection weights
+     * & actual positions of the champion in the background
+     * from its trace if ctx.tracer keeps it, or by re-evaluating it
      */
     template <typename T>
-    void evaluate(Organism<T> *org, Plant *plant, PlantLogger *log_pos, 
-        Logger *const net_outp = nullptr, WeightWatcher *ww = nullptr);
+    void save_champ_logs(Organism<T> *champ, EvalContext &ctx,
+        AsyncArchiver &archiver, const eSpinn_size &gen);
 
     /* @brief: denormalize and shift controller output */
     double process(const double &raw_out);
@@ -171,11 +171,13 @@ def eval(game, birds, inj, gen):
         refresh(game, birds, dist, gen, alive)
 
 
-# init game
-pygame.init()
-game = flappy.Flappy(pygame)
-stat_font = pygame.font.SysFont('arial', 25)
-color = (255, 255, 255)
+def init_game():
+    """ Init game window, only needed to replay birds """
+    global game, stat_font, color
+    pygame.init()
+    game = flappy.Flappy(pygame)
+    stat_font = pygame.font.SysFont('arial', 25)
+    color = (255, 255, 255)
 
 
 def train():
@@ -200,14 +202,23 @@ def train():
     #   err_x = pipe.x + pipe.width - bird.x
     # err_y: height dist btw bird (top edge) & pipe gap (middle)
     #   err_y = bird.y - (pipe.lowery - gap/2)
+    # the headless game normalizes input states the same way,
+    # inj is archived to replay birds in the game window
     inj = eSpinn.Injector(inp_num-1)
-    MAX_ERRX = game.PIPEGAP_H + game.IMAGES['pipe'][0].get_width()
-    MAX_ERRY = game.bird.yBOTTOM - int(0.2*game.base.Y + game.PIPEGAP/2)
-    MIN_ERRY = game.bird.yTOP - int(0.8*game.base.Y - game.PIPEGAP/2)
+    MAX_ERRX = 100 + 52 # PIPEGAP_H + pipe width
+    MAX_ERRY = 404-24 - int(0.2*404 + 100/2) # yBOTTOM - upmost gap middle
+    MIN_ERRY = -24 - int(0.8*404 - 100/2) # yTOP - lowest gap middle
     inj.setNormFactors(0, MAX_ERRX, 0)
     inj.setNormFactors(MIN_ERRY, MAX_ERRY, 1) # [-297, 250]
     inj.archive('./asset/archive/inj.arch')
 
+    # birds fly in the headless game, in parallel threads
+    evaluator = eSpinn.LifEvaluator(
+        eSpinn.FlappyEnv(), eSpinn.LifEvaluator.PARALLEL)
+
+    # champions of all generations, indexed for fast loading
+    champs = eSpinn.ChampionStore('./asset/archive/champs.arch', False)
+
     fit_file = './asset/data/fit'
     fit_logger = eSpinn.Logger()
 
@@ -219,17 +230,17 @@ def train():
         print('--------------------------------------------------')
         print(pop)
 
-        birds = create_nnbirds(game, pop.orgs)
-        # evaluate birds
-        dist = eval(game, birds, inj, gen)
+        # evaluate birds on a new course every generation
+        # solved if a bird flies over 10000
+        evaluator.set_env(eSpinn.FlappyEnv(gen))
+        evaluator.evaluate(pop, eSpinn.FlappyEnv.MAX_DIST + 1)
+        champ = pop.get_champ_org()
+        dist = champ.fit
         # save dist to file
         fit_logger.append_to_file(dist, fit_file)
-        # if solved
-        if dist > 10000:
-            pop.set_solved()
         pop.archive('./asset/archive/pop' + str(gen) + '.arch')
-        champ = pop.get_champ_org()
         champ.save('./asset/archive/champ_org.arch')
+        champs.add(champ, gen, True)
         if pop.issolved():
             print('Dist reaches 10000')
             break
@@ -248,13 +259,16 @@ def evaluate(gen):
     print()
     print('Evaluating champion bird of gen', gen, '...')
 
-    # load pop from file
-    pop = eSpinn.Population()
-    pop.load('./asset/archive/pop' + str(gen) + '.arch')
+    # load the champion only, not the whole population
+    champ = eSpinn.ChampionStore('./asset/archive/champs.arch').load_champ(gen)
+    if champ is None:
+        print('No champion of gen', gen)
+        return
     # load inject encoder used to normalize input states
     inj = eSpinn.createInjector('./asset/archive/inj.arch')
 
-    bird = create_nnbirds(game, [pop.get_champ_org()])
+    init_game()
+    bird = create_nnbirds(game, [champ])
     # evaluate bird
     dist = eval(game, bird, inj, gen)
     print('Champion bird dist =', dist)
@@ -4,11 +4,20 @@
 
 
 #include "sim_hexa.h"
+#include <algorithm>
+#include <memory>
 
 using namespace eSpinn;
 
 
+/* @brief: usage
+ * eSpinn.sim [random seed]
+ */
 int main(int argc, char *argv[]) {
+    // runs differ unless a seed is given
+    const std::uint64_t seed = argc > 1 ? std::stoull(argv[1]) : random_seed();
+    seed_rand(seed);
+    std::cout << "Random seed: " << seed << std::endl;
     sim_hexa_heave();
     return sim_plasticity();
     // verify();
@@ -40,7 +49,13 @@ int eSpinn::sim_hexa_heave() {
     // init new pop
     auto pop = new Population(org, params::pop_size);
     pop->init();
-    pop->archive(Hexa::Z_POP + std::to_string(gen) + Hexa::POP_EXT);
+    // checkpoints: full snapshots every few generations, deltas in between
+    CheckpointStore ckpt(Hexa::Z_POP, Hexa::POP_EXT);
+    ckpt.save(*pop, gen);
+    // champions of all generations, indexed for fast loading
+    ChampionStore champs(Hexa::Z_CHAMPS, false);
+    // archive in the background, pending jobs are done before returning
+    AsyncArchiver archiver;
     // or continue evolution by loading existing pop from which gen
     // gen = 1;
     // auto pop = new eSpinn::Population;
@@ -52,28 +67,45 @@ int eSpinn::sim_hexa_heave() {
     // inj.setNormFactors(hexa->battRange[0], hexa->battRange[1], 2); // batt_v
     inj.archive(Hexa::INJ_ARCH);
 
+    // screen organisms on the first half of the signal in early generations
+    // and evaluate all of them in full later on, if screening
+    FidelitySchedule fidelity;
+    if (Hexa::screening) {
+        fidelity.set(1, Fidelity(.5, .3));
+        fidelity.set(params::episode/2, Fidelity());
+    }
+
     Logger fit_logger(1);
     Logger net_outp(log_pos->length());
 
     for ( ; gen <= params::episode; ++gen) {
         // evaluate pop, check if solved
-        if (evaluate<decltype(org)>(pop, hexa, &inj, log_pos)
+        if (evaluate<decltype(org)>(pop, hexa, &inj, log_pos, fidelity.at(gen))
             || !(gen % 1))
         {
             auto champ = dynamic_cast<decltype(org)>(pop->get_champ_org());
             std::cout << "Champion is " << *champ << std::endl;
             net_outp.clear();
-            WeightWatcher w_watch(champ->getNet(), gen , log_pos->length()+5 );
-            evaluate(champ, hexa, &inj, log_pos, &net_outp, &w_watch);
-            net_outp.save(Hexa::FILE_THR);
-            w_watch.save(Hexa::FILE_Z_WEIGHT);
-            log_pos->save_act(Hexa::FILE_Z_ACT);
-            pop->archive(Hexa::Z_POP + std::to_string(gen) + Hexa::POP_EXT);
-            champ->archive(Hexa::Z_CHAMP_ORG);
-            champ->save(Hexa::Z_CHAMP);
+            auto w_watch = std::make_shared<WeightWatcher>(champ->getNet(), gen , log_pos->length()+5 );
+            evaluate(champ, hexa, &inj, log_pos, &net_outp, w_watch.get());
+            // save results in the background while the next generation evaluates
+            auto act_log = *log_pos;
+            archiver.submit([net_outp, w_watch, act_log]() mutable {
+                net_outp.save(Hexa::FILE_THR);
+                w_watch->save(Hexa::FILE_Z_WEIGHT);
+                act_log.save_act(Hexa::FILE_Z_ACT);
+            });
+            archiver.submit(*pop, [&ckpt, gen](Population &p) { ckpt.save(p, gen); });
+            archiver.submit(*champ, [&champs, gen](OrganismBase &o) {
+                o.archive_binary(Hexa::Z_CHAMP_ORG);
+                o.save(Hexa::Z_CHAMP);
+                champs.add(o, gen, true);
+            });
             if (pop->issolved()) {
-                pop->archive(Hexa::Z_POP + std::to_string(params::episode)
-                             + Hexa::POP_EXT);
+                archiver.submit(*pop, [](Population &p) {
+                    p.archive(Hexa::Z_POP + std::to_string(params::episode)
+                              + Hexa::POP_EXT);
+                });
                 fit_logger.append_to_file(champ->getFit(), Hexa::FILE_Z_FIT);
                 break;
             }
@@ -87,7 +119,9 @@ int eSpinn::sim_hexa_heave() {
             break;
     }
     evaluate<decltype(org)>(pop, hexa, &inj, log_pos);
-    pop->archive(Hexa::Z_POP + std::to_string(params::episode) + Hexa::POP_EXT);
+    archiver.submit(*pop, [](Population &p) {
+        p.archive(Hexa::Z_POP + std::to_string(params::episode) + Hexa::POP_EXT);
+    });
 
     delete hexa;
     delete log_pos;
@@ -103,18 +137,76 @@ int eSpinn::sim_hexa_heave() {
  * calculate mean square errors 
  * and assign fitness values to organisms
  * finally, check if problem is solved
+ * organisms are screened on a short episode first if fidelity says so,
+ * and those not promoted are ranked below the fully evaluated ones
+ * organisms that can neither survive nor win are stopped early
+ * and finished later if they may change offspring counts
+ * observation noise of each organism is drawn from its own stream
  */
 template <typename T>
 bool eSpinn::evaluate(Population *pop, Hexacopter *hexa,
-    Injector *inj, PlantLogger *log_pos)
+    Injector *inj, PlantLogger *log_pos, const Fidelity &fidelity)
 {
-    for (auto &org : pop->orgs) {
+    // observation noise of each organism is drawn from its own stream,
+    // so an evaluation finished later gives the same fitness
+    std::vector<std::uint64_t> seeds(pop->size());
+    for (auto &s : seeds)
+        s = draw_seed();
+    const auto engine = rand_engine();
+
+    std::vector<OrganismBase*> screened;
+    if (fidelity.screens()) {
+        const auto screen_len = fidelity.screen_length(log_pos->length());
+        for (eSpinn_size i = 0; i < pop->size(); ++i) {
+            auto &org = pop->orgs[i];
+            auto org_cast = dynamic_cast<T>(org);
+            seed_rand(seeds[i]);
+            evaluate(org_cast, hexa, inj, log_pos, nullptr, nullptr,
+                -std::numeric_limits<double>::infinity(), screen_len);
+            screened.push_back(org);
+        }
+    }
+    const auto promoted = fidelity.promoted(*pop, screened);
+
+    SurvivalCutoff cutoff(*pop, Hexa::WINNER_FIT);
+    std::vector<OrganismBase*> demoted;
+    double full_min = std::numeric_limits<double>::infinity();
+    for (eSpinn_size i = 0; i < pop->size(); ++i) {
+        auto &org = pop->orgs[i];
+        if (fidelity.screens() && !promoted.count(org)) {
+            demoted.push_back(org);
+            continue;
+        }
         auto org_cast = dynamic_cast<T>(org);
-        evaluate(org_cast, hexa, inj, log_pos);
+        seed_rand(seeds[i]);
+        if (evaluate(org_cast, hexa, inj, log_pos, nullptr, nullptr,
+            cutoff.threshold(org)))
+            cutoff.record(org, org->getFit());
+        else
+            // fitness is at least 0
+            cutoff.stopped(org, .0, org->getFit());
+        full_min = std::min(full_min, org->getFit());
         if (org->setWinner(Hexa::WINNER_FIT)) {
             pop->set_solved();
         }
     }
+    // screening fitness is not comparable with full fitness
+    // ranking it below keeps survivors, not offspring counts
+    for (auto &org : demoted)
+        org->setFit(std::min(org->getFit(), full_min));
+    // finish stopped evaluations that may change the offspring counts
+    while (auto org = cutoff.unresolved()) {
+        const auto i = std::find(pop->orgs.begin(), pop->orgs.end(), org) - pop->orgs.begin();
+        seed_rand(seeds[i]);
+        evaluate(dynamic_cast<T>(org), hexa, inj, log_pos);
+        cutoff.finished(org);
+    }
+    rand_engine() = engine;
+    if (fidelity.screens())
+        std::cout << demoted.size() << " of " << screened.size() 
+            << " screened organisms not promoted" << std::endl;
+    std::cout << cutoff.get_stopped() << " evaluations stopped early, "
+        << cutoff.get_finished() << " of them finished" << std::endl;
 
     return pop->issolved();
 }
@@ -125,11 +217,15 @@ bool eSpinn::evaluate(Population *pop, Hexacopter *hexa,
  * log controller outputs when re-evaluating champ organism
  * calculate mean square error 
  * and assign fitness value to organism
+ * stop once the fitness can't reach cutoff, and assign the fitness bound
+ * return false if stopped
+ * only the first steps of the reference signal are run if steps is given
  */
 template <typename T>
-void eSpinn::evaluate(Organism<T> *org, Hexacopter *hexa,
+bool eSpinn::evaluate(Organism<T> *org, Hexacopter *hexa,
     Injector *inj, PlantLogger *log_pos,
-    Logger *const net_outp, WeightWatcher *w_watch)
+    Logger *const net_outp, WeightWatcher *w_watch, const double &cutoff,
+    const eSpinn_size &steps)
 {
     #ifndef NDEBUG
     std::cout << "Evaluating Network #" << org->getID() << std::endl;
@@ -139,9 +235,13 @@ void eSpinn::evaluate(Organism<T> *org, Hexacopter *hexa,
 
     auto net = org->getNet();
     auto inp_size = net->get_inp_size();
-    const auto timesteps = log_pos->length();
+    const auto timesteps = (steps && steps < log_pos->length()) ? 
+        steps : log_pos->length();
     bool failed = false;
     net->backup_connection_weights();
+    // start from the same runtime states whatever ran before,
+    // e.g. a screening episode
+    net->reset();
 
     if (w_watch)
         w_watch->log_weights();
@@ -150,10 +250,23 @@ void eSpinn::evaluate(Organism<T> *org, Hexacopter *hexa,
 
     // OutputBuffer outp_channel(5);
 
+    // the fitness is 1 - sum|err| / (timesteps*posMAX), at least 0.2,
+    // or below 0.2 if failed
+    // the sum so far gives an upper bound of it
+    const double err_scale = 1.0 / (timesteps * hexa->posMAX);
+    double abs_err = .0;
+
     double raw_outp = .5, outp = .0, outp_pre = Hexa::thr_hover;
     for (auto i = 0; i < timesteps; ++i) {
         log_pos->log_act(i, hexa->getPos()); // archive actual position
         auto pos_err = log_pos->cal_err(i);
+        abs_err += std::abs(pos_err);
+        const double fit_bound = std::max(1.0 - abs_err * err_scale, 0.2);
+        if (fit_bound < cutoff) {
+            org->setFit(fit_bound);
+            net->restore_connection_weights();
+            return false;
+        }
         // introduce observation noise (2cm)
         inj->load_data(0, pos_err + rand(-.02, .02) ); // load position error
         inj->load_data(1, hexa->getVel() + rand(-.02, .02) ); // load velocity
@@ -197,7 +310,7 @@ void eSpinn::evaluate(Organism<T> *org, Hexacopter *hexa,
         }
     }
     if (!failed) {
-        auto std_err = log_pos->cal_std_err() / hexa->posMAX;
+        auto std_err = log_pos->cal_std_err(timesteps) / hexa->posMAX;
         // make sure fit is positive
         if (std_err >= 1.0)
             std_err = .8;
@@ -207,6 +320,7 @@ void eSpinn::evaluate(Organism<T> *org, Hexacopter *hexa,
     }
     // restore connection weights if network is plastic
     net->restore_connection_weights();
+    return true;
 }
 
 
@@ -253,7 +367,7 @@ bool eSpinn::sim_plasticity() {
     pop->load(Hexa::Z_POP + std::to_string(params::episode) + Hexa::POP_EXT);
     auto org = dynamic_cast<Organism<HybridNetwork>*>(pop->get_champ_org())->duplicate(1, 1);
     // set as rate Hebbian
-    org->getNet()->set_connection_hebb_type(RateHebbian);
+    org->set_connection_hebb_type(RateHebbian);
     delete pop;
 
     Injector inj = createInjector(Hexa::INJ_ARCH);
@@ -280,6 +394,13 @@ bool eSpinn::sim_plasticity() {
     ++gen;
     */
 
+    // checkpoints: full snapshots every few generations, deltas in between
+    CheckpointStore ckpt(Hexa::Z_POP, Hexa::POP_EXT);
+    // champions of all generations, indexed for fast loading
+    ChampionStore champs(Hexa::Z_CHAMPS);
+    // archive in the background, pending jobs are done before returning
+    AsyncArchiver archiver;
+
     Logger fit_logger(1);
     fit_logger.append_newline_to_file(Hexa::FILE_Z_FIT);
     Logger net_outp(log_pos->length());
@@ -290,17 +411,26 @@ bool eSpinn::sim_plasticity() {
             auto champ = dynamic_cast<decltype(org)>(pop->get_champ_org());
             std::cout << "Champion is " << *champ << std::endl;
             net_outp.clear();
-            WeightWatcher w_watch(champ->getNet(), gen);
-            evaluate(champ, hexa, &inj, log_pos, &net_outp, &w_watch);
-            net_outp.save(Hexa::FILE_THR);
-            w_watch.save(Hexa::FILE_Z_WEIGHT);
-            log_pos->save_act(Hexa::FILE_Z_ACT);
-            pop->archive(Hexa::Z_POP + std::to_string(gen) + Hexa::POP_EXT);
-            champ->archive(Hexa::Z_CHAMP_ORG);
-            champ->save(Hexa::Z_CHAMP);
+            auto w_watch = std::make_shared<WeightWatcher>(champ->getNet(), gen);
+            evaluate(champ, hexa, &inj, log_pos, &net_outp, w_watch.get());
+            // save results in the background while the next generation evaluates
+            auto act_log = *log_pos;
+            archiver.submit([net_outp, w_watch, act_log]() mutable {
+                net_outp.save(Hexa::FILE_THR);
+                w_watch->save(Hexa::FILE_Z_WEIGHT);
+                act_log.save_act(Hexa::FILE_Z_ACT);
+            });
+            archiver.submit(*pop, [&ckpt, gen](Population &p) { ckpt.save(p, gen); });
+            archiver.submit(*champ, [&champs, gen](OrganismBase &o) {
+                o.archive_binary(Hexa::Z_CHAMP_ORG);
+                o.save(Hexa::Z_CHAMP);
+                champs.add(o, gen, true);
+            });
             if (pop->issolved()) {
-                pop->archive(Hexa::Z_POP + std::to_string(2*params::episode)
-                             + Hexa::POP_EXT);
+                archiver.submit(*pop, [](Population &p) {
+                    p.archive(Hexa::Z_POP + std::to_string(2*params::episode)
+                              + Hexa::POP_EXT);
+                });
                 fit_logger.append_to_file(champ->getFit(), Hexa::FILE_Z_FIT);
                 break;
             }
@@ -314,7 +444,9 @@ bool eSpinn::sim_plasticity() {
             break;
     }
     evaluate<decltype(org)>(pop, hexa, &inj, log_pos);
-    pop->archive(Hexa::Z_POP + std::to_string(2*params::episode) + Hexa::POP_EXT);
+    archiver.submit(*pop, [](Population &p) {
+        p.archive(Hexa::Z_POP + std::to_string(2*params::episode) + Hexa::POP_EXT);
+    });
 
     delete hexa;
     delete log_pos;
@@ -331,6 +463,15 @@ bool eSpinn::sim_plasticity() {
 int eSpinn::verify() {
     std::cout << "Verifying trained networks..." << std::endl;
 
+    // load the champion only, not the whole population
+    ChampionStore champs(Hexa::Z_CHAMPS);
+    std::unique_ptr<OrganismBase> champ(champs.load_latest_champ(params::episode));
+    if (!champ) {
+        std::cerr << BnR_ERROR << "No champion up to gen #" << params::episode << " in "
+            << Hexa::Z_CHAMPS << std::endl;
+        return 1;
+    }
+
     // load the same reference signal for now
     auto log_pos = new PlantLogger();
     log_pos->load_ref_signal(Hexa::FILE_Z_REF);
@@ -340,11 +481,7 @@ int eSpinn::verify() {
     const double dt = 0.01;
     auto hexa = new Hexacopter(dt);
 
-    Population pop;
-    pop.load(Hexa::Z_POP + std::to_string(params::episode) + Hexa::POP_EXT);
-    std::cout << pop << std::endl;
-    auto champ = pop.get_champ_org();
-    auto champ_cast = dynamic_cast<Organism<HybridNetwork>*>(champ);
+    auto champ_cast = dynamic_cast<Organism<HybridNetwork>*>(champ.get());
     std::cout << "Champ org: " << *champ_cast << std::endl;
 
     Injector inj = createInjector(Hexa::INJ_ARCH);
@@ -365,10 +502,14 @@ int eSpinn::verify() {
  * read population from file, and print the champ org
  */
 int eSpinn::print_champ() {
-    Population pop;
-    pop.load(Hexa::Z_POP + std::to_string(params::episode) + Hexa::POP_EXT);
-    auto champ = pop.get_champ_org();
-    auto champ_cast = dynamic_cast<Organism<HybridNetwork>*>(champ);
+    ChampionStore champs(Hexa::Z_CHAMPS);
+    std::unique_ptr<OrganismBase> champ(champs.load_latest_champ(params::episode));
+    if (!champ) {
+        std::cerr << BnR_ERROR << "No champion up to gen #" << params::episode << " in "
+            << Hexa::Z_CHAMPS << std::endl;
+        return 1;
+    }
+    auto champ_cast = dynamic_cast<Organism<HybridNetwork>*>(champ.get());
     std::cout << "Champ org: " << *champ_cast << std::endl;
 
     return 0;
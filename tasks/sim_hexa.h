@@ -8,12 +8,14 @@
 #include "eSpinn.h"
 #include <iostream>
 #include <chrono>
+#include <limits>
 
 namespace eSpinn {
     namespace Hexa {
         const std::string Z_POP         (DIR_ARCHIVE + "z");
         const std::string Z_CHAMP       (DIR_ARCHIVE + "z.champ");
         const std::string Z_CHAMP_ORG   (DIR_ARCHIVE + "zchamp.org");
+        const std::string Z_CHAMPS      (DIR_ARCHIVE + "z.champs");
         const std::string POP_EXT       (".pop");
         const std::string INJ_ARCH      (DIR_ARCHIVE + "inj.arch");
         const std::string FILE_Z_REF    (DIR_DATA + "z.ref");
@@ -26,6 +28,9 @@ namespace eSpinn {
         constexpr double thr_norm_factor = thrRange[1] - thrRange[0];
         constexpr double thr_shift = thrRange[0];
         constexpr double thr_hover = 0.2729;
+        // screen organisms on a short episode in early generations,
+        // offspring counts of those generations are approximate then
+        constexpr bool screening = false;
     }
 
     /* @brief: controller task
@@ -42,21 +47,31 @@ namespace eSpinn {
      * calculate mean square errors 
      * and assign fitness values to organisms
      * finally, check if problem is solved
+     * organisms are screened on a short episode first if fidelity says so,
+     * and those not promoted are ranked below the fully evaluated ones
+     * organisms that can neither survive nor win are stopped early
+     * and finished later if they may change offspring counts
+     * observation noise of each organism is drawn from its own stream
      */
     template <typename T>
     bool evaluate(Population *pop, Hexacopter *hexa,
-        Injector *inj, PlantLogger *log_pos);
+        Injector *inj, PlantLogger *log_pos, const Fidelity &fidelity = Fidelity());
 
     /* @brief: evaluate organism by controlling the plant model
      * log system outputs 
      * log controller outputs when re-evaluating champ organism
      * calculate mean square error 
      * and assign fitness value to organism
+     * stop once the fitness can't reach cutoff, and assign the fitness bound
+     * return false if stopped
+     * only the first steps of the reference signal are run if steps is given
      */
     template <typename T>
-    void evaluate(Organism<T> *org, Hexacopter *hexa,
+    bool evaluate(Organism<T> *org, Hexacopter *hexa,
         Injector *inj, PlantLogger *log_pos,
-        Logger *const net_outp = nullptr, WeightWatcher *ww = nullptr);
+        Logger *const net_outp = nullptr, WeightWatcher *ww = nullptr,
+        const double &cutoff = -std::numeric_limits<double>::infinity(),
+        const eSpinn_size &steps = 0);
 
     /* @brief: denormalize and shift controller output */
     double process(const double &raw_out, double hover);
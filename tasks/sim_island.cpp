@@ -0,0 +1,155 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#include "sim_island.h"
+#include <cstdlib>
+#include <thread>
+
+using namespace eSpinn;
+
+
+/* @brief: usage
+ * eSpinn.sim <island id> <num of islands>  - run one island in this process
+ * eSpinn.sim <num of islands>              - run all islands in threads
+ */
+int main(int argc, char *argv[]) {
+    if (argc > 2)
+        return sim_island(std::atoi(argv[1]), std::atoi(argv[2]));
+    return sim_islands(argc > 1 ? std::atoi(argv[1]) : 4);
+}
+
+
+/* @brief: island model of the controller task
+ * evolve a population on one island
+ * and exchange the best organisms with other islands
+ * islands run in separate processes or threads
+ * all islands share the directory DIR_ISLAND
+ */
+int eSpinn::sim_island(const eSpinn_size &island_id, const eSpinn_size &num_islands) {
+    std::cout << "Starting island #" << island_id << " of "
+        << num_islands << "..." << std::endl;
+
+    // islands evolve differently, runs differ
+    const auto seed = random_seed();
+    seed_rand(seed);
+    std::cout << "Island #" << island_id << " random seed: " << seed << std::endl;
+
+    // create logger and load reference signal
+    auto log_pos = new PlantLogger();
+    log_pos->load_ref_signal(FILE_REF_DATA);
+
+    // construct plant model
+    const double dt = 0.02;
+    auto plant = new Plant(dt);
+
+    // initialize population
+    eSpinn_size gen = 1;
+    auto org = new Organism<HybLinNetwork>(netID(1), 3, 0, 1, gen);
+    auto pop = new Population(org, params::pop_size);
+    pop->init();
+    Island island(pop, island_id, num_islands, DIR_ISLAND,
+        Isl::migration_interval, Isl::num_migrants);
+
+    Logger fit_logger(1);
+    const auto fit_file = Isl::ISL_FIT + std::to_string(island_id);
+
+    for (gen = 1; gen <= params::episode; ++gen) {
+        // evaluate pop, check if solved
+        if (evaluate(pop, plant, log_pos)) {
+            std::cout << "Island #" << island_id << " solved the problem at gen #"
+                << gen << std::endl;
+            break;
+        }
+        // exchange migrants with other islands
+        island.migrate(gen);
+        // evolve
+        bool done = !pop->epoch(gen);
+        std::cout << "Island #" << island_id << " gen #" << gen
+            << ": champ fit = " << pop->get_champ_fit() << std::endl;
+        fit_logger.append_to_file(pop->get_champ_fit(), fit_file);
+        if (done)
+            break;
+    }
+    pop->archive(Isl::ISL_POP + std::to_string(island_id) + FILE_EXT);
+
+    delete plant;
+    delete log_pos;
+    delete org;
+    delete pop;
+    return 0;
+}
+
+
+/* @brief: run all islands in this process, one thread each */
+int eSpinn::sim_islands(const eSpinn_size &num_islands) {
+    std::vector<std::thread> threads;
+    for (eSpinn_size i = 0; i < num_islands; ++i)
+        threads.emplace_back(sim_island, i, num_islands);
+    for (auto &t : threads)
+        t.join();
+    return 0;
+}
+
+
+/* @brief: evaluate population
+ * use each network to control the plant model
+ * and assign fitness values to organisms
+ * finally, check if problem is solved
+ */
+bool eSpinn::evaluate(Population *pop, Plant *plant, PlantLogger *log_pos) {
+    for (auto &org : pop->orgs) {
+        evaluate(dynamic_cast<Organism<HybLinNetwork>*>(org), plant, log_pos);
+        if (org->setWinner(Isl::winner_fit)) {
+            pop->set_solved();
+        }
+    }
+    return pop->issolved();
+}
+
+
+/* @brief: evaluate organism by controlling the plant model
+ * calculate mean square error
+ * and assign fitness value to organism
+ */
+void eSpinn::evaluate(Organism<HybLinNetwork> *org, Plant *plant, PlantLogger *log_pos) {
+    auto net = org->getNet();
+    auto inp_size = net->get_inp_size();
+    const auto timesteps = log_pos->length();
+    net->backup_connection_weights();
+
+    plant->reset();
+    Injector inj(inp_size-1);
+    inj.setNormFactors(plant->posRANGE[0], plant->posRANGE[1], 0); // pos_err
+    inj.setNormFactors(plant->velRANGE[0], plant->velRANGE[1], 1); // vel
+
+    bool failed = false;
+    for (auto i = 0; i < timesteps; ++i) {
+        log_pos->log_act(i, plant->getPos());
+        inj.load_data(0, log_pos->cal_err(i)); // load position error
+        inj.load_data(1, plant->getVel()); // load velocity
+        net->load_inputs(inj.get_data_set(), inp_size);
+        // denormalize and saturate controller output
+        auto outp = net->run().at(0) * Isl::ctrl_norm_factor;
+        if (outp < Isl::ctrlRange[0])
+            outp = Isl::ctrlRange[0];
+        else if (outp > Isl::ctrlRange[1])
+            outp = Isl::ctrlRange[1];
+
+        if (!plant->run(outp)) { // position out of boundary
+            failed = true;
+            org->setFit(static_cast<double>(i)/timesteps * 0.2);
+            break;
+        }
+    }
+    if (!failed) {
+        auto std_err = log_pos->cal_std_err() / plant->posRANGE[1];
+        // make sure fit is positive
+        if (std_err >= 1.0)
+            std_err = .8;
+        org->calFit(std_err);
+    }
+    // restore connection weights if network is plastic
+    net->restore_connection_weights();
+}
@@ -0,0 +1,46 @@
+/* Copyright (C) 2017-2019 Huanneng Qiu.
+ * Licensed under the Apache-2.0 license. See LICENSE for details.
+ */
+
+
+#pragma once
+
+#include "eSpinn.h"
+#include <iostream>
+#include <chrono>
+
+namespace eSpinn {
+    namespace Isl {
+        const std::string ISL_POP   (DIR_ARCHIVE + "island");
+        const std::string ISL_FIT   (DIR_DATA + "island_fit");
+        constexpr double winner_fit = 0.999;
+        constexpr double ctrlRange[2] = {-4.0, 4.0};
+        constexpr double ctrl_norm_factor = 6.0;
+        constexpr eSpinn_size migration_interval = 5;
+        constexpr eSpinn_size num_migrants = 2;
+    }
+
+    /* @brief: island model of the controller task
+     * evolve a population on one island
+     * and exchange the best organisms with other islands
+     * islands run in separate processes or threads
+     * all islands share the directory DIR_ISLAND
+     */
+    int sim_island(const eSpinn_size &island_id, const eSpinn_size &num_islands);
+
+    /* @brief: run all islands in this process, one thread each */
+    int sim_islands(const eSpinn_size &num_islands);
+
+    /* @brief: evaluate population
+     * use each network to control the plant model
+     * and assign fitness values to organisms
+     * finally, check if problem is solved
+     */
+    bool evaluate(Population *pop, Plant *plant, PlantLogger *log_pos);
+
+    /* @brief: evaluate organism by controlling the plant model
+     * calculate mean square error
+     * and assign fitness value to organism
+     */
+    void evaluate(Organism<HybLinNetwork> *org, Plant *plant, PlantLogger *log_pos);
+}
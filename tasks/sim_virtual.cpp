@@ -8,7 +8,14 @@
 using namespace eSpinn;
 
 
+/* @brief: usage
+ * eSpinn.sim [random seed]
+ */
 int main(int argc, char *argv[]) {
+    // runs differ unless a seed is given
+    const std::uint64_t seed = argc > 1 ? std::stoull(argv[1]) : random_seed();
+    seed_rand(seed);
+    std::cout << "Random seed: " << seed << std::endl;
     return sim_virtual();
 }
 
@@ -31,6 +31,8 @@ namespace eSpinn {
     int run_spikeNet();
     int run_sigmNet();
     int run_hybridNet();
+    int run_netBatch();
+    int run_plantBatch();
 
     int serialize_net();
 
@@ -38,6 +40,8 @@ namespace eSpinn {
     int copy_org();
     int serialize_org();
     int test_org();
+    int test_genome();
+    int test_mutation();
 
     int test_gate();
     int test_injector();
@@ -47,4 +51,8 @@ namespace eSpinn {
     int serialize_species();
     int serialize_pop();
     int test_pop_archive();
+    int test_pop_binary_archive();
+    int test_pop_checkpoint();
+    int test_closed_loop();
+    int test_survival_cutoff();
 }
@@ -22,6 +22,8 @@ int main(int argc, char *argv[]) {
     // run_spikeNet();
     // run_sigmNet();
     // run_hybridNet();
+    // run_netBatch();
+    // run_plantBatch();
 
     // serialize_net();
 
@@ -29,6 +31,8 @@ int main(int argc, char *argv[]) {
     // copy_org();
     serialize_org();
     // test_org();
+    // test_genome();
+    // test_mutation();
 
     // test_gate();
     // test_injector();
@@ -38,5 +42,9 @@ int main(int argc, char *argv[]) {
     // serialize_species();
     // serialize_pop();
     // test_pop_archive();
+    // test_pop_binary_archive();
+    // test_pop_checkpoint();
+    // test_closed_loop();
+    // test_survival_cutoff();
     return 0;
 }
@@ -140,6 +140,111 @@ int eSpinn::run_hybridNet() {
 }
 
 
+/* @brief: run networks of the same topology in a batch
+ * batch outputs should be the same as running each network
+ */
+int eSpinn::run_netBatch() {
+    const double inp[2] = {0.5, 0.2};
+    auto org = new Organism<SigmNetwork>(netID(1), 2, 1, 1);
+    std::vector<Innovation*> innov;
+    neuronID next_nid = org->get_next_neuron_id();
+    connID next_cid = org->get_next_conn_id();
+    for (int i = 0; i < 5; ++i) {
+        org->addNeuron(next_nid, next_cid, innov);
+        org->addConnection(next_cid, innov);
+    }
+
+    std::vector<Organism<SigmNetwork>*> orgs{org};
+    for (auto i = 2; i <= 4; ++i) {
+        orgs.push_back(org->duplicate(netID(i), 1));
+        orgs.back()->mutateWeights();
+    }
+    std::vector<const Genome*> genomes;
+    for (auto &o : orgs)
+        genomes.push_back(&o->get_genome());
+    SigmNetworkBatch batch(genomes);
+    // copies of the first network sharing its parameters
+    SigmNetworkBatch copies(org->get_genome(), orgs.size());
+
+    std::vector<double> inps, outps(orgs.size()), copy_outps(orgs.size());
+    for (auto &o : orgs)
+        inps.insert(inps.end(), inp, inp + size_of(inp));
+    bool same = true;
+    for (auto t = 0; t < 10; ++t) {
+        batch.run(inps.data(), outps.data());
+        copies.run(inps.data(), copy_outps.data());
+        for (eSpinn_size b = 0; b < orgs.size(); ++b) {
+            auto net = orgs[b]->getNet();
+            net->load_inputs(inp, size_of(inp));
+            same = same && net->run()[0] == outps[b];
+            same = same && copy_outps[b] == outps[0];
+        }
+    }
+    std::cout << "Batch outputs are the same? " << std::boolalpha
+        << same << std::endl;
+
+    for (auto &o : orgs)
+        delete o;
+    for (auto &i : innov)
+        delete i;
+    return same ? 0 : -1;
+}
+
+
+/* @brief: step plant & hexacopter models in batches
+ * states & masks should be the same as stepping each model,
+ * models out of boundary hold their states
+ */
+int eSpinn::run_plantBatch() {
+    const eSpinn_size n = 4, timesteps = 500;
+    const double dt = 0.02;
+    std::vector<Plant> plants(n, Plant(dt));
+    PlantBatch plant_batch(n, dt);
+    const std::vector<double> batts{11.5, 11.0, 10.5, 10.0};
+    std::vector<Hexacopter> hexas;
+    for (auto &b : batts)
+        hexas.emplace_back(dt, b);
+    HexacopterBatch hexa_batch(batts, dt);
+
+    std::vector<char> plant_alive(n, 1), hexa_alive(n, 1);
+    std::vector<double> force(n), thr(n);
+    bool same = true;
+    for (eSpinn_size t = 0; t < timesteps; ++t) {
+        for (eSpinn_size i = 0; i < n; ++i) {
+            // feedback turns unstable for larger i, those models go out of boundary
+            const double k = 1. - .7 * i, d = .1 * std::sin(.02 * t);
+            force[i] = 7.1 + k * plants[i].getPos() + d;
+            thr[i] = hexas[i].getHover() - .02 - .1 * k * hexas[i].getPos()
+                - .05 * hexas[i].getVel() + .01 * d;
+            if (plant_alive[i])
+                plant_alive[i] = plants[i].run(force[i]);
+            if (hexa_alive[i])
+                hexa_alive[i] = hexas[i].run(thr[i]);
+        }
+        plant_batch.run(force.data());
+        hexa_batch.run(thr.data());
+        for (eSpinn_size i = 0; i < n; ++i) {
+            same = same && plant_batch.running(i) == bool(plant_alive[i])
+                && plant_batch.getPos(i) == plants[i].getPos()
+                && plant_batch.getVel(i) == plants[i].getVel()
+                && plant_batch.getAcc(i) == plants[i].getAcc();
+            same = same && hexa_batch.running(i) == bool(hexa_alive[i])
+                && hexa_batch.getPos(i) == hexas[i].getPos()
+                && hexa_batch.getVel(i) == hexas[i].getVel()
+                && hexa_batch.getAcc(i) == hexas[i].getAcc()
+                && hexa_batch.getBatt(i) == hexas[i].getBatt()
+                && hexa_batch.getHover(i) == hexas[i].getHover();
+        }
+    }
+    std::cout << plant_batch.num_running() << " of " << n << " plants & "
+        << hexa_batch.num_running() << " of " << n << " hexacopters running" << std::endl;
+    std::cout << "Batch states are the same? " << std::boolalpha
+        << same << std::endl;
+
+    return same ? 0 : -1;
+}
+
+
 // BOOST_CLASS_EXPORT(eSpinn::SpikeConnection)
 // BOOST_CLASS_EXPORT(eSpinn::Connection)
 // BOOST_CLASS_EXPORT(eSpinn::Sensor)
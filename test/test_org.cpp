@@ -140,3 +140,86 @@ int eSpinn::test_org() {
     delete new_org;
     return 0;
 }
+
+
+/* @brief: evolve a genome and build its phenotype
+ * the phenotype should encode back into the same genome
+ * genomes of the same structure should share the topology
+ */
+int eSpinn::test_genome() {
+    auto org = new Organism<HybridNetwork>(netID(1), 3, 1, 1);
+    std::vector<Innovation*> innov;
+    neuronID next_nid = org->get_next_neuron_id();
+    connID next_cid = org->get_next_conn_id();
+    for (int i = 0; i < 20; ++i) {
+        org->addNeuron(next_nid, next_cid, innov);
+        org->addConnection(next_cid, innov);
+        org->mutateWeights();
+    }
+    std::cout << org->get_genome() << std::endl;
+
+    Genome g;
+    org->getNet()->encode(g);
+    bool same = g.has_same_topology(org->get_genome()) &&
+        g.topology() == org->get_genome().topology() &&
+        g.weight == org->get_genome().weight;
+    std::cout << "Phenotype encodes the same genome? " << std::boolalpha
+        << same << std::endl;
+
+    // a duplicate shares the topology until its structure is mutated
+    auto dup = org->duplicate(netID(2), 1);
+    dup->mutateWeights();
+    bool shared = g.shared_topology() == org->get_genome().shared_topology() &&
+        dup->get_genome().shared_topology() == org->get_genome().shared_topology();
+    dup->addNeuron(next_nid, next_cid, innov);
+    shared = shared &&
+        dup->get_genome().shared_topology() != org->get_genome().shared_topology();
+    std::cout << "Same topologies are shared? " << shared << std::endl;
+    delete dup;
+
+    for (auto &i : innov)
+        delete i;
+    delete org;
+    return same && shared ? 0 : -1;
+}
+
+
+/* @brief: mutate the weights of many genomes in one go
+ * mutated weights should stay within their boundaries,
+ * and about mutate_weight_prob of them should change
+ */
+int eSpinn::test_mutation() {
+    auto org = new Organism<SigmNetwork>(netID(1), 10, 0, 10);
+    std::vector<Genome> genomes(100, org->get_genome());
+    MutationEngine mutation;
+    for (auto &g : genomes) {
+        mutation.add_weights(g);
+        mutation.add_lambdas(g);
+    }
+    std::cout << "Mutating " << mutation.size() << " genes" << std::endl;
+    mutation.mutate();
+
+    const auto &w0 = org->get_genome().weight;
+    double changed = 0, total = 0;
+    bool bounded = true;
+    for (auto &g : genomes) {
+        for (eSpinn_size i = 0; i < g.weight.size(); ++i) {
+            changed += g.weight[i] != w0[i];
+            ++total;
+            bounded = bounded && std::abs(g.weight[i]) <= params::MAX_WEIGHT;
+        }
+        for (eSpinn_size n = 0; n < g.neuron_size(); ++n) {
+            if (g.topology().neuron_type[n] == SIGMOID)
+                bounded = bounded && g.neuron_param[n] >= params::MIN_LAMBDA
+                    && g.neuron_param[n] <= params::MAX_LAMBDA;
+            else
+                bounded = bounded && g.neuron_param[n] == org->get_genome().neuron_param[n];
+        }
+    }
+    std::cout << "Fraction of weights mutated is " << changed/total
+        << ", all genes bounded? " << std::boolalpha << bounded << std::endl;
+
+    delete org;
+    bool ok = bounded && std::abs(changed/total - neat::mutate_weight_prob) < 0.05;
+    return ok ? 0 : -1;
+}
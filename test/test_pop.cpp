@@ -11,7 +11,7 @@
 int eSpinn::create_pop() {
     auto net = new HybridNetwork(netID(1), 2, 1, 1);
     auto org = Organism<HybridNetwork>(net, 0);
-    auto pop = Population(&org, 2);
+    Population pop(&org, 2);
     pop.init();
 
     // delete net;
@@ -159,3 +159,354 @@ int eSpinn::test_pop_archive() {
     delete new_pop;
     return 0;
 }
+
+
+int eSpinn::test_pop_binary_archive() {
+    auto net = new LinrNetwork(netID(1), 2, 1, 1);
+    auto org = new Organism<LinrNetwork>(net, 1);
+    auto pop = new Population(org, 10);
+    pop->init();
+    auto inno = new Innovation(1, 2, 1, .0, DEFAULTCONN);
+    pop->innovation.push_back(inno);
+
+    const std::string bin_file(FILE_POP + ".bin");
+    pop->archive_binary(bin_file);
+
+    // the format is detected when loading
+    auto new_pop = new Population;
+    new_pop->load(bin_file);
+    std::cout << *new_pop << std::endl;
+    const bool binary = is_binary_archive(bin_file);
+    std::cout << "binary archive: " << binary << std::endl;
+
+    auto first_org = new_pop->orgs[0];
+    const bool same = first_org->get_genome().hash()
+        == pop->orgs[0]->get_genome().hash();
+    std::cout << "same genome: " << same << std::endl;
+    auto org_cast = dynamic_cast<Organism<LinrNetwork>*>(first_org);
+    std::cout << *org_cast->getNet() << std::endl;
+
+    // 1 if g is loaded back, 0 if it's rejected & the loaded genome cleared
+    auto reload = [](const Genome &g) {
+        BinaryWriter w(binarch::ORGANISM);
+        g.archive(w);
+        BinaryReader r(w.release());
+        Genome loaded;
+        if (loaded.load(r))
+            return loaded.hash() == g.hash() ? 1 : -1;
+        return loaded.neuron_size() || loaded.conn_size() ? -1 : 0;
+    };
+    const auto &genome = pop->orgs[0]->get_genome();
+    Genome dangling(genome), unsorted(genome);
+    dangling.edit_topology().conn_in[0] = 9999;
+    std::swap(unsorted.edit_topology().conn_id[0], unsorted.edit_topology().conn_id[1]);
+    const bool rejected = reload(genome) == 1
+        && reload(dangling) == 0 && reload(unsorted) == 0;
+    std::cout << "corrupted genomes rejected: " << rejected << std::endl;
+
+    delete org;
+    delete pop;
+    delete new_pop;
+    return binary && same && rejected ? 0 : -1;
+}
+
+
+int eSpinn::test_pop_checkpoint() {
+    auto net = new LinrNetwork(netID(1), 2, 1, 1);
+    auto org = new Organism<LinrNetwork>(net, 1);
+    auto pop = new Population(org, 10);
+    pop->init();
+
+    // a base at gen 1 and deltas at gen 2 & 3
+    CheckpointStore ckpt(FILE_POP + "_ckpt", ".bin", 3);
+    std::uint64_t hash = 0;
+    for (eSpinn_size gen = 1; gen <= 3; ++gen) {
+        for (auto &o : pop->orgs)
+            o->setFit(gen + o->getID());
+        std::cout << "checkpoint " << gen << ": " << ckpt.save(*pop, gen)
+            << " bytes" << std::endl;
+        hash = pop->orgs[0]->get_genome().hash();
+        if (gen < 3)
+            pop->epoch(gen);
+    }
+
+    auto new_pop = new Population;
+    const bool restored = ckpt.restore(*new_pop, 3);
+    std::cout << *new_pop << std::endl;
+    const bool same = restored && new_pop->orgs[0]->get_genome().hash() == hash;
+    std::cout << "same genome: " << same << std::endl;
+
+    delete org;
+    delete pop;
+    delete new_pop;
+    return same ? 0 : -1;
+}
+
+
+/* @brief: a toy environment to track a sine wave */
+namespace {
+    class SineTracking : public eSpinn::Environment {
+    private:
+        eSpinn::eSpinn_size steps, len;
+        double err;
+        // episodes started by all copies, every k-th of them is cut to 10 steps
+        std::shared_ptr<eSpinn::eSpinn_size> resets;
+        eSpinn::eSpinn_size k;
+        double noise; // std of sensor noise
+    public:
+        SineTracking(const eSpinn::eSpinn_size &every = 0, const double &n = .0) :
+            steps(0), len(100), err(.0),
+            resets(std::make_shared<eSpinn::eSpinn_size>(0)), k(every), noise(n) { }
+        std::unique_ptr<eSpinn::Environment> clone() const override {
+            return std::unique_ptr<eSpinn::Environment>(new SineTracking(*this));
+        }
+        const eSpinn::eSpinn_size obs_size() const override { return 1; }
+        const eSpinn::eSpinn_size act_size() const override { return 1; }
+        void reset() override {
+            steps = 0;
+            err = .0;
+            len = k && (*resets)++ % k == 0 ? 10 : 100;
+        }
+        void observe(double *obs) override {
+            obs[0] = std::sin(.1 * steps);
+            if (noise > .0)
+                obs[0] += eSpinn::rand_normal(.0, noise);
+        }
+        void step(const double *act) override {
+            err += std::abs(act[0] - std::sin(.1 * steps++));
+        }
+        bool done() const override { return steps >= len; }
+        const double score() const override { return 100.0 - err; }
+        const eSpinn::eSpinn_size trace_size() const override { return 2; }
+        void trace(const double *act, double *row) const override {
+            row[0] = std::sin(.1 * steps);
+            row[1] = act[0];
+        }
+    };
+}
+
+
+/* @brief: evaluate a population in closed loop
+ * serially, in parallel and in batches
+ * and trace the champion's last 50 steps
+ * the toy environment is deterministic,
+ * so 4 episodes of each organism give the same fitness as one
+ * networks running every 4 time slots, held in between,
+ * give the same fitness in all modes
+ * the traced first of 4 episodes ending early is kept up to its last step
+ * noisy observations give the same fitness whatever the interleave depth
+ */
+int eSpinn::test_closed_loop() {
+    auto net = new LinrNetwork(netID(1), 2, 1, 1);
+    auto org = new Organism<LinrNetwork>(net, 1);
+    auto pop = new Population(org, 20);
+    pop->init();
+
+    ClosedLoopEvaluator<LinrNetwork> evaluator(SineTracking{});
+    evaluator.set_tracing(50);
+    std::vector<std::vector<double>> fits, traces;
+    auto champ_trace = [&evaluator, pop]() {
+        std::vector<double> v;
+        auto &tr = evaluator.get_tracer().get_trace();
+        if (!evaluator.get_tracer().has(pop->get_champ_org()))
+            return v;
+        for (eSpinn_size ts = 0; ts < tr.length(); ++ts)
+            v.push_back(tr.at(ts, 1));
+        return v;
+    };
+    for (auto mode : {ClosedLoopEvaluator<LinrNetwork>::SERIAL,
+        ClosedLoopEvaluator<LinrNetwork>::PARALLEL,
+        ClosedLoopEvaluator<LinrNetwork>::BATCHED})
+    {
+        evaluator.set_mode(mode);
+        evaluator.evaluate(pop->orgs);
+        fits.push_back({});
+        for (auto &o : pop->orgs)
+            fits.back().push_back(o->getFit());
+        traces.push_back(champ_trace());
+    }
+    // interleaved episodes of each worker
+    evaluator.set_mode(ClosedLoopEvaluator<LinrNetwork>::PARALLEL);
+    evaluator.set_depth(4);
+    evaluator.evaluate(pop->orgs);
+    fits.push_back({});
+    for (auto &o : pop->orgs)
+        fits.back().push_back(o->getFit());
+    traces.push_back(champ_trace());
+    // episodes of each organism in lockstep
+    for (auto mode : {ClosedLoopEvaluator<LinrNetwork>::SERIAL,
+        ClosedLoopEvaluator<LinrNetwork>::PARALLEL,
+        ClosedLoopEvaluator<LinrNetwork>::BATCHED})
+    {
+        evaluator.set_mode(mode);
+        evaluator.set_episodes(4, ClosedLoopEvaluator<LinrNetwork>::QUANTILE, .25);
+        evaluator.evaluate(pop->orgs);
+        fits.push_back({});
+        for (auto &o : pop->orgs)
+            fits.back().push_back(o->getFit());
+    }
+    // networks at a quarter of the rate of the environment
+    evaluator.set_episodes(1);
+    evaluator.set_depth(1);
+    std::vector<std::vector<double>> held_fits;
+    for (auto mode : {ClosedLoopEvaluator<LinrNetwork>::SERIAL,
+        ClosedLoopEvaluator<LinrNetwork>::PARALLEL,
+        ClosedLoopEvaluator<LinrNetwork>::BATCHED})
+    {
+        evaluator.set_mode(mode);
+        evaluator.set_control(4, SampleHold::RAMP);
+        evaluator.evaluate(pop->orgs);
+        held_fits.push_back({});
+        for (auto &o : pop->orgs)
+            held_fits.back().push_back(o->getFit());
+    }
+    // the first episode of each organism lasts 10 steps, the others 100
+    ClosedLoopEvaluator<LinrNetwork> short_eval(SineTracking(4));
+    short_eval.set_episodes(4);
+    bool short_traced = true;
+    for (auto mode : {ClosedLoopEvaluator<LinrNetwork>::SERIAL,
+        ClosedLoopEvaluator<LinrNetwork>::BATCHED})
+    {
+        for (eSpinn_size capacity : {50, 5}) {
+            short_eval.set_mode(mode);
+            short_eval.set_tracing(capacity);
+            short_eval.evaluate(pop->orgs);
+            auto &tr = short_eval.get_tracer().get_trace();
+            short_traced = short_traced
+                && tr.length() == std::min<eSpinn_size>(capacity, 10)
+                && tr.at(tr.length() - 1, 0) == std::sin(.1 * 9);
+        }
+    }
+    // sensor noise drawn by interleaved episodes
+    ClosedLoopEvaluator<LinrNetwork> noisy_eval(SineTracking(0, .1),
+        ClosedLoopEvaluator<LinrNetwork>::PARALLEL);
+    std::vector<std::vector<double>> noisy_fits;
+    for (eSpinn_size d : {1, 4}) {
+        noisy_eval.set_depth(d);
+        seed_rand(1);
+        noisy_eval.evaluate(pop->orgs);
+        noisy_fits.push_back({});
+        for (auto &o : pop->orgs)
+            noisy_fits.back().push_back(o->getFit());
+    }
+    const bool same = fits[0] == fits[1] && fits[0] == fits[2] && fits[0] == fits[3];
+    const bool traced = traces[0].size() == 50;
+    const bool same_episodes = fits[0] == fits[4] && fits[0] == fits[5]
+        && fits[0] == fits[6];
+    const bool same_held = held_fits[0] == held_fits[1] && held_fits[0] == held_fits[2]
+        && held_fits[0] != fits[0];
+    const bool same_trace = traces[0] == traces[1] && traces[0] == traces[2]
+        && traces[0] == traces[3];
+    const bool same_noisy = noisy_fits[0] == noisy_fits[1] && noisy_fits[0] != fits[0];
+    std::cout << "fit of org #1: " << fits[0][0] << std::endl;
+    std::cout << "same fitness: " << std::boolalpha << same << std::endl;
+    std::cout << "champion traced: " << traced << std::endl;
+    std::cout << "same fitness of 4 episodes: " << same_episodes << std::endl;
+    std::cout << "same fitness of held outputs: " << same_held << std::endl;
+    std::cout << "same champion trace: " << same_trace << std::endl;
+    std::cout << "short episode traced: " << short_traced << std::endl;
+    std::cout << "same fitness of noisy episodes: " << same_noisy << std::endl;
+
+    delete org;
+    delete pop;
+    return same && traced && same_episodes && same_held && same_trace
+        && short_traced && same_noisy ? 0 : -1;
+}
+
+
+/* @brief: evaluate organisms by tracking a sine wave */
+namespace {
+    typedef eSpinn::Organism<eSpinn::LinrNetwork> SineOrg;
+
+    /* the fitness is 1 - mean of errors, which are clipped to 1,
+     * so the errors so far give a range of it
+     * stop once it can't reach cutoff, return false if stopped
+     */
+    bool track_sine(SineOrg *org, const double &cutoff, double &lowest) {
+        const eSpinn::eSpinn_size timesteps = 100;
+        auto net = org->getNet();
+        net->reset();
+        double inps[2] = {.0, 1.0}, err = .0;
+        for (eSpinn::eSpinn_size i = 0; i < timesteps; ++i) {
+            inps[0] = std::sin(.1 * i);
+            net->load_inputs(inps, 2);
+            err += std::min(std::abs(net->run()[0] - std::sin(.1 * (i + 1))), 1.0);
+            if (1.0 - err / timesteps < cutoff) {
+                org->setFit(1.0 - err / timesteps);
+                lowest = 1.0 - (err + timesteps - i - 1) / timesteps;
+                return false;
+            }
+        }
+        org->setFit(1.0 - err / timesteps);
+        return true;
+    }
+
+    /* evaluate organisms of pop, stop hopeless evaluations if stop
+     * and finish those that may change offspring counts
+     */
+    void track_sine(eSpinn::Population *pop, const bool &stop,
+        eSpinn::eSpinn_size &stopped, eSpinn::eSpinn_size &finished)
+    {
+        // never solved
+        eSpinn::SurvivalCutoff cutoff(*pop, 2.0);
+        double lowest;
+        for (auto &o : pop->orgs) {
+            auto org = dynamic_cast<SineOrg*>(o);
+            if (!stop)
+                track_sine(org, -std::numeric_limits<double>::infinity(), lowest);
+            else if (track_sine(org, cutoff.threshold(o), lowest))
+                cutoff.record(o, o->getFit());
+            else
+                cutoff.stopped(o, lowest, o->getFit());
+        }
+        while (auto o = cutoff.unresolved()) {
+            track_sine(dynamic_cast<SineOrg*>(o),
+                -std::numeric_limits<double>::infinity(), lowest);
+            cutoff.finished(o);
+        }
+        stopped += cutoff.get_stopped();
+        finished += cutoff.get_finished();
+    }
+}
+
+
+/* @brief: evolve two populations of the same seed,
+ * one evaluated to the end and the other stopping hopeless evaluations
+ * offspring counts, hence offspring, should be the same
+ */
+int eSpinn::test_survival_cutoff() {
+    auto net = new LinrNetwork(netID(1), 2, 1, 1);
+    auto org = new Organism<LinrNetwork>(net, 1);
+    std::vector<Population*> pops;
+    for (eSpinn_size p = 0; p < 2; ++p) {
+        seed_rand(1);
+        pops.push_back(new Population(org, 50));
+        pops.back()->init();
+    }
+
+    eSpinn_size stopped = 0, finished = 0;
+    bool same = true;
+    for (eSpinn_size gen = 1; gen <= 10; ++gen) {
+        track_sine(pops[0], false, stopped, finished);
+        track_sine(pops[1], true, stopped, finished);
+        // species sizes & genomes of offspring
+        std::vector<std::uint64_t> counts[2];
+        for (eSpinn_size p = 0; p < 2; ++p) {
+            seed_rand(gen);
+            pops[p]->epoch(gen);
+            for (auto &s : pops[p]->species)
+                counts[p].push_back(s->size());
+            for (auto &o : pops[p]->orgs)
+                counts[p].push_back(o->get_genome().hash());
+        }
+        same = same && counts[0] == counts[1];
+    }
+    std::cout << "same offspring with " << stopped << " evaluations stopped, "
+        << finished << " of them finished: " << std::boolalpha << same << std::endl;
+
+    delete org;
+    for (auto &p : pops)
+        delete p;
+    return same ? 0 : -1;
+}
+